@@ -0,0 +1,159 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+
+#include <DPsim.h>
+#include <cps/CIM/Reader.h>
+#include <cps/CIM/TopologyCache.h>
+
+using namespace DPsim;
+using namespace CPS;
+using namespace CPS::CIM;
+
+// Loads a grid through the topology cache and checks that the restored
+// topology gives the same nodes, components and powerflow solution as the
+// parsed one. Caches that are edited to contain an unconnected component
+// must be rejected. Caches with an unknown component type, a wrong number
+// of parameters or an unknown terminal are damaged and parsed again.
+
+static const Real frequency = 50;
+
+static SystemTopology load(const std::list<fs::path> &filenames, const fs::path &cache) {
+	Reader reader("CIM_TopologyCache", Logger::Level::off, Logger::Level::off);
+	if (!cache.empty())
+		reader.setTopologyCache(cache);
+	return reader.loadCIM(frequency, filenames, Domain::SP);
+}
+
+static std::vector<Complex> powerflow(String name, SystemTopology &system) {
+	Simulation sim(name, system, 1, 1, Domain::SP, Solver::Type::NRP, Logger::Level::off, true);
+	sim.run();
+	std::vector<Complex> voltages;
+	for (auto node : system.mNodes)
+		voltages.push_back(node->attributeComplex("v")->get());
+	return voltages;
+}
+
+/// Key of an existing cache file, stored after the magic and the version
+static std::uint64_t fileKey(const fs::path &cache) {
+	std::ifstream in(cache.string(), std::ios::binary);
+	std::uint64_t key = 0;
+	in.seekg(8 + sizeof(std::uint32_t));
+	in.read(reinterpret_cast<char*>(&key), sizeof(key));
+	return key;
+}
+
+/// Write the cache again with the given change applied to the first component
+static void editCache(const fs::path &cache, std::function<void(TopologyCache::ComponentRecord&)> edit) {
+	std::uint64_t key = fileKey(cache);
+	TopologyCache original, edited;
+	original.load(cache, key);
+	for (auto &node : original.nodes())
+		edited.addNode(node);
+	for (auto &term : original.terminals())
+		edited.addTerminal(term);
+	Bool first = true;
+	for (auto &entry : original.components()) {
+		auto comp = entry.second;
+		if (first)
+			edit(comp);
+		first = false;
+		edited.addComponent(comp);
+	}
+	edited.save(cache, key);
+}
+
+int main(int argc, char** argv) {
+	std::list<fs::path> filenames;
+	if (argc <= 1) {
+		filenames = DPsim::Utils::findFiles({
+			"case9.xml"
+		}, "build/_deps/cim-data-src/Matpower_cases", "CIMPATH");
+	}
+	else {
+		filenames = std::list<fs::path>(argv + 1, argv + argc);
+	}
+
+	fs::path cache = "CIM_TopologyCache.bin";
+	fs::remove(cache);
+
+	auto parsed = load(filenames, "");
+	load(filenames, cache);
+	if (!fs::exists(cache)) {
+		std::cerr << "topology cache was not written" << std::endl;
+		return 1;
+	}
+	auto restored = load(filenames, cache);
+
+	if (parsed.mNodes.size() != restored.mNodes.size()
+		|| parsed.mComponents.size() != restored.mComponents.size()) {
+		std::cerr << "restored topology has " << restored.mNodes.size() << " nodes and "
+			<< restored.mComponents.size() << " components instead of "
+			<< parsed.mNodes.size() << " and " << parsed.mComponents.size() << std::endl;
+		return 1;
+	}
+	for (UInt i = 0; i < parsed.mComponents.size(); i++) {
+		if (parsed.mComponents[i]->uid() != restored.mComponents[i]->uid()) {
+			std::cerr << "component " << i << " differs: " << parsed.mComponents[i]->uid()
+				<< " vs " << restored.mComponents[i]->uid() << std::endl;
+			return 1;
+		}
+	}
+
+	auto vParsed = powerflow("CIM_TopologyCache_parsed", parsed);
+	auto vRestored = powerflow("CIM_TopologyCache_restored", restored);
+	for (UInt i = 0; i < vParsed.size(); i++) {
+		if (std::abs(vParsed[i] - vRestored[i]) > 1e-9 * std::abs(vParsed[i])) {
+			std::cerr << "node " << parsed.mNodes[i]->name() << ": " << vParsed[i]
+				<< " parsed vs " << vRestored[i] << " restored" << std::endl;
+			return 1;
+		}
+	}
+
+	// Component without terminals
+	editCache(cache, [](TopologyCache::ComponentRecord &comp) { comp.terminals.clear(); });
+	try {
+		load(filenames, cache);
+		std::cerr << "unconnected component in cache was not rejected" << std::endl;
+		return 1;
+	}
+	catch (InvalidTopology &) { }
+
+	std::map<String, std::function<void(TopologyCache::ComponentRecord&)>> damages = {
+		{ "unknown component type", [](TopologyCache::ComponentRecord &comp) {
+			comp.type = static_cast<TopologyCache::ComponentType>(1000); } },
+		{ "missing parameters", [](TopologyCache::ComponentRecord &comp) {
+			comp.parameters.assign(comp.parameters.empty() ? 9 : comp.parameters.size() - 1, 0); } },
+		{ "unknown terminal", [](TopologyCache::ComponentRecord &comp) {
+			comp.terminals.push_back(std::make_pair(0, "unknown")); } },
+	};
+	for (auto &damage : damages) {
+		fs::remove(cache);
+		load(filenames, cache);
+		editCache(cache, damage.second);
+		auto reparsed = load(filenames, cache);
+		TopologyCache rewritten;
+		if (reparsed.mComponents.size() != parsed.mComponents.size()
+			|| !rewritten.load(cache, fileKey(cache))) {
+			std::cerr << "cache with " << damage.first << " was not parsed again" << std::endl;
+			return 1;
+		}
+	}
+
+	fs::remove(cache);
+	return 0;
+}
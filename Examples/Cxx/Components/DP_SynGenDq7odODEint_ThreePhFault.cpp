@@ -15,82 +15,124 @@
  *********************************************************************************/
 
 #include <DPsim.h>
-#include<dpsim/ODEintSolver.h>
 
 using namespace DPsim;
 using namespace CPS::DP;
 using namespace CPS::DP::Ph3;
 
-/*###### For execution at least one command line argument is required: ###########
-	First argument: binary flag (0 or 1),
-	0: The Generator Equations are solved without using the ODE-Simulation Class
-	1: The Generator Equations are solved using the ODE-Simulation Class
+// Three-phase fault at the terminals of a synchronous generator, whose
+// equations are integrated by the odeint RK4 solver. The generator current
+// is checked against the built-in trapezoidal generator model before,
+// during and after the fault.
 
-    This is a general Test of the ODEintSolver Class. TODO: Add ODEint Solver option to Sim_ODE interface
-	*/
+// Define machine parameters in per unit
+static const Real nomPower = 555e6;
+static const Real nomPhPhVoltRMS = 24e3;
+static const Real nomFreq = 60;
+static const Real nomFieldCurr = 1300;
+static const Int poleNum = 2;
+static const Real H = 3.7;
+static const Real Rs = 0.003;
+static const Real Ll = 0.15;
+static const Real Lmd = 1.6599;
+static const Real Lmq = 1.61;
+static const Real Rfd = 0.0006;
+static const Real Llfd = 0.1648;
+static const Real Rkd = 0.0284;
+static const Real Llkd = 0.1713;
+static const Real Rkq1 = 0.0062;
+static const Real Llkq1 = 0.7252;
+static const Real Rkq2 = 0.0237;
+static const Real Llkq2 = 0.125;
+// Initialization parameters
+static const Real initActivePower = 300e6;
+static const Real initReactivePower = 0;
+static const Real initTerminalVolt = 24000 / sqrt(3) * sqrt(2);
+static const Real initVoltAngle = -PI / 2;
+static const Real fieldVoltage = 7.0821;
+static const Real mechPower = 300e6;
+// Define grid parameters
+static const Real Rload = 1.92;
+static const Real BreakerOpen = 1e6;
+static const Real BreakerClosed = 0.001;
 
+static const Real timeStep = 0.00005;
+static const Real finalTime = 0.3;
 
+/// Simulate the fault and return the phase a current of the generator
+/// at every step
+template <typename SynGen>
+static std::vector<Complex> simulateFault(String simName, std::shared_ptr<SynGen> gen) {
+	std::vector<Complex> initVoltN1 = std::vector<Complex>({
+		Complex(initTerminalVolt * cos(initVoltAngle), initTerminalVolt * sin(initVoltAngle)),
+		Complex(initTerminalVolt * cos(initVoltAngle - 2 * PI / 3), initTerminalVolt * sin(initVoltAngle - 2 * PI / 3)),
+		Complex(initTerminalVolt * cos(initVoltAngle + 2 * PI / 3), initTerminalVolt * sin(initVoltAngle + 2 * PI / 3)) });
+	auto n1 = SimNode::make("n1", PhaseType::ABC, initVoltN1);
+
+	gen->setParametersFundamentalPerUnit(
+		nomPower, nomPhPhVoltRMS, nomFreq, poleNum, nomFieldCurr,
+		Rs, Ll, Lmd, Lmq, Rfd, Llfd, Rkd, Llkd, Rkq1, Llkq1, Rkq2, Llkq2, H,
+		initActivePower, initReactivePower, initTerminalVolt, initVoltAngle, fieldVoltage, mechPower);
+
+	auto res = Ph3::SeriesResistor::make("R_load");
+	res->setParameters(Rload);
+
+	auto fault = Ph3::SeriesSwitch::make("Br_fault");
+	fault->setParameters(BreakerOpen, BreakerClosed);
+	fault->open();
+
+	gen->connect({n1});
+	res->connect({SimNode::GND, n1});
+	fault->connect({SimNode::GND, n1});
+
+	auto sys = SystemTopology(60, SystemNodeList{n1}, SystemComponentList{gen, res, fault});
+	Simulation sim(simName, sys, timeStep, finalTime, Domain::DP, Solver::Type::MNA, Logger::Level::off);
+	sim.addEvent(SwitchEvent::make(0.1, fault, true));
+	sim.addEvent(SwitchEvent::make(0.2, fault, false));
+
+	// Without an ODE solver the state of the ODE generator would stay zero
+	sim.initialize();
+	std::vector<Complex> current;
+	while (sim.time() < finalTime - timeStep / 2) {
+		sim.step();
+		current.push_back(gen->attributeMatrixComp("i_intf")->get()(0, 0));
+	}
+	return current;
+}
 
 int main(int argc, char* argv[]) {
-    // Define simulation parameters
-    Real om = 2.0 * PI * 60.0;
-    Real timeStep = 0.00005; //initial: 0.00005
-    Real finalTime = 0.1;
-    Real curTime = timeStep;
-    String simName = "DP_SynchronGenerator_dq_ThreePhFault";
-    // Define machine parameters in per unit
-    Real nomPower = 555e6;
-    Real nomPhPhVoltRMS = 24e3;
-    Real nomFreq = 60;
-    Real nomFieldCurr = 1300;
-    Int poleNum = 2;
-    Real H = 3.7;
-    Real Rs = 0.003;
-    Real Ll = 0.15;
-    Real Lmd = 1.6599;
-    Real Lmq = 1.61;
-    Real Rfd = 0.0006;
-    Real Llfd = 0.1648;
-    Real Rkd = 0.0284;
-    Real Llkd = 0.1713;
-    Real Rkq1 = 0.0062;
-    Real Llkq1 = 0.7252;
-    Real Rkq2 = 0.0237;
-    Real Llkq2 = 0.125;
-    // Initialization parameters
-    Real initActivePower = 300e6;
-    Real initReactivePower = 0;
-    Real initTerminalVolt = 24000 / sqrt(3) * sqrt(2);
-    Real initVoltAngle = -PI / 2;
-    Real fieldVoltage = 7.0821;
-    Real mechPower = 300e6;
-
-
-    /// Use seperate ODE-Solver and Simulation Class->true ; use directly built-in solver: false
-    bool ode_class;
-    /// Pass on command line '1' for execution with ODE-Class; else use built-in solver
-    assert(argc>=2);
-    if(atoi(argv[1])==1){
-        ode_class=true; // simulate with ode-class
-    }else{
-        ode_class=false; // simulate without ode-class (use built in solver)
-    }
-
-    // Components
-    auto gen = Ph3::SynchronGeneratorDQ::make("DP_SynGen_dq_ThreePhFault_SynGen", ode_class);
-    gen->setParametersFundamentalPerUnit(nomPower, nomPhPhVoltRMS, nomFreq, poleNum, nomFieldCurr,
-                                    Rs, Ll, Lmd, Lmq, Rfd, Llfd, Rkd, Llkd, Rkq1, Llkq1, Rkq2, Llkq2, H,
-                                    initActivePower, initReactivePower, initTerminalVolt, initVoltAngle, fieldVoltage, mechPower);
-
-    ODEintSolver sim(simName, gen, timeStep, timeStep);
-
-    while (curTime < finalTime){
-
-        curTime = sim.step(curTime);
-        for (auto sol : sim.curSolution)
-            std::cout<< sol<<std::endl;
-
-    }
-
-    return 0;
+	auto ref = simulateFault("DP_SynGenDq7odTrapez_ThreePhFault",
+		Ph3::SynchronGeneratorDQTrapez::make("DP_SynGen"));
+	auto ode = simulateFault("DP_SynGenDq7odODEint_ThreePhFault",
+		Ph3::SynchronGeneratorDQODE::make("DP_SynGen"));
+
+	if (ref.size() != ode.size()) {
+		std::cerr << "step count differs: " << ref.size() << " vs " << ode.size() << std::endl;
+		return 1;
+	}
+
+	// Largest deviation relative to the peak current of each interval
+	const std::vector<Real> bounds = { 0, 0.1, 0.2, finalTime };
+	const std::vector<String> names = { "pre-fault", "fault", "post-fault" };
+	Bool failed = false;
+	for (UInt k = 0; k < names.size(); k++) {
+		Real maxDiff = 0, peak = 0;
+		for (UInt i = 0; i < ref.size(); i++) {
+			Real t = (i + 1) * timeStep;
+			if (t <= bounds[k] || t > bounds[k+1])
+				continue;
+			maxDiff = std::max(maxDiff, std::abs(ode[i] - ref[i]));
+			peak = std::max(peak, std::abs(ref[i]));
+		}
+		std::cout << names[k] << ": peak " << peak << " A, max deviation "
+			<< maxDiff / peak * 100 << " %" << std::endl;
+		if (!(maxDiff <= 0.01 * peak))
+			failed = true;
+	}
+	if (failed) {
+		std::cerr << "ODEint generator deviates from the trapezoidal model" << std::endl;
+		return 1;
+	}
+
+	return 0;
 }
@@ -0,0 +1,111 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/DAESolver.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Solves a resistive ladder with the dense, the sparse and the Krylov
+// linear solver of the DAE solver, directly and through a simulation.
+// All of them have to reach the nodal voltages of the voltage divider.
+
+static const UInt numNodes = 8;
+static const Real timeStep = 1e-4;
+static const Real sourceVoltage = 1000;
+static const Real lineResistance = 1;
+static const Real loadResistance = 100;
+
+static std::vector<Real> solve(String name, DAESolver::LinearSolverType linearSolver, Bool simulation) {
+	Logger::setLogDir("logs/" + name);
+
+	// Ladder with series resistances between the nodes and a load at each node
+	SimNode::List nodes;
+	SystemComponentList comps;
+	for (UInt n = 0; n < numNodes; n++)
+		nodes.push_back(SimNode::make("n" + std::to_string(n)));
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(sourceVoltage, 0));
+	vs->connect({ SimNode::GND, nodes[0] });
+	comps.push_back(vs);
+	for (UInt n = 1; n < numNodes; n++) {
+		auto line = Resistor::make("line" + std::to_string(n));
+		line->setParameters(lineResistance);
+		line->connect({ nodes[n - 1], nodes[n] });
+		comps.push_back(line);
+
+		auto load = Resistor::make("load" + std::to_string(n));
+		load->setParameters(loadResistance);
+		load->connect({ SimNode::GND, nodes[n] });
+		comps.push_back(load);
+	}
+
+	SystemNodeList topoNodes{ SimNode::GND };
+	topoNodes.insert(topoNodes.end(), nodes.begin(), nodes.end());
+	if (simulation) {
+		Simulation sim(name, SystemTopology(50, topoNodes, comps), timeStep, 10 * timeStep,
+			CPS::Domain::DP, Solver::Type::DAE, CPS::Logger::Level::off);
+		sim.setDAELinearSolver(linearSolver);
+		sim.run();
+	}
+	else {
+		DAESolver solver(name, SystemTopology(50, topoNodes, comps), timeStep, 0, linearSolver);
+		for (Real time = 0; time < 10 * timeStep; )
+			time = solver.step(time);
+	}
+
+	std::vector<Real> voltages;
+	for (auto node : nodes)
+		voltages.push_back(node->singleVoltage().real());
+	return voltages;
+}
+
+int main(int argc, char* argv[]) {
+	// Voltages of the ladder from its end, where the load current is known
+	std::vector<Real> expected(numNodes);
+	Real voltage = 1, current = 1 / loadResistance;
+	for (Int n = numNodes - 1; n >= 0; n--) {
+		expected[n] = voltage;
+		voltage += current * lineResistance;
+		current += voltage / loadResistance;
+	}
+	for (auto& v : expected)
+		v *= sourceVoltage / expected[0];
+
+	std::map<String, DAESolver::LinearSolverType> solvers = {
+		{ "Dense", DAESolver::LinearSolverType::Dense },
+		{ "Sparse", DAESolver::LinearSolverType::Sparse },
+		{ "Krylov", DAESolver::LinearSolverType::Krylov }
+	};
+	for (auto& solver : solvers) {
+		for (Bool simulation : { false, true }) {
+			String name = solver.first + (simulation ? "_Simulation" : "");
+			auto voltages = solve("DAE_DP_LinearSolvers_" + name, solver.second, simulation);
+			for (UInt n = 0; n < numNodes; n++) {
+				if (std::abs(voltages[n] - expected[n]) > 1e-4 * sourceVoltage) {
+					std::cerr << name << " solver: voltage " << voltages[n] << " at n" << n
+						<< " instead of " << expected[n] << std::endl;
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,163 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <DPsim.h>
+#include <cps/CSVReader.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+// Writes CSV files with numbers in different notations, a title row,
+// CRLF line ends and no line end after the last row. The files are large
+// enough to be split into several chunks. They have to be read with the
+// exact values that have been written, independent of the number of
+// threads. Load profiles read through the CSVReader have to be the same
+// for one and for several threads.
+
+static const UInt numColumns = 4;
+static const UInt numRows = 60000;
+
+static String format(Real value, UInt variant) {
+	char buf[64];
+	switch (variant % 4) {
+		case 0: std::snprintf(buf, sizeof(buf), "%.17g", value); break;
+		case 1: std::snprintf(buf, sizeof(buf), "%.17e", value); break;
+		case 2: std::snprintf(buf, sizeof(buf), "%.3f", value); break;
+		default: std::snprintf(buf, sizeof(buf), "%+.6E", value); break;
+	}
+	return buf;
+}
+
+// Writes the file and returns the values as they are written
+static std::vector<Real> writeFile(const String& filename, Bool title, Real firstValue) {
+	std::mt19937_64 gen(42);
+	std::uniform_real_distribution<Real> mantissa(-1, 1);
+	std::uniform_int_distribution<Int> exponent(-30, 30);
+
+	std::vector<Real> values;
+	std::ofstream file(filename, std::ios_base::binary);
+	if (title)
+		file << "time, p, q, x\r\n";
+	for (UInt row = 0; row < numRows; row++) {
+		for (UInt col = 0; col < numColumns; col++) {
+			Real value = row == 0 && col == 0 ? firstValue : mantissa(gen) * std::pow(10., exponent(gen));
+			String text = format(value, row + col);
+			values.push_back(std::strtod(text.c_str(), nullptr));
+			file << (col > 0 ? ", " : "") << text;
+		}
+		if (row + 1 < numRows)
+			file << (row % 2 ? "\r\n" : "\n");
+	}
+	return values;
+}
+
+static Bool checkData(const String& filename, const std::vector<Real>& expected, UInt numThreads) {
+	CSVData data(filename, false, numThreads);
+	if (data.columns() != numColumns || data.rows() != numRows) {
+		std::cerr << filename << " read with " << numThreads << " threads has "
+			<< data.rows() << " rows of " << data.columns() << " values" << std::endl;
+		return false;
+	}
+	for (std::size_t row = 0; row < numRows; row++) {
+		for (UInt col = 0; col < numColumns; col++) {
+			if (data.get(row, col) != expected[row * numColumns + col]) {
+				std::cerr << filename << " read with " << numThreads << " threads: value "
+					<< data.get(row, col) << " in row " << row << " instead of "
+					<< expected[row * numColumns + col] << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static Bool equal(const PowerProfile& a, const PowerProfile& b) {
+	if (a.pqData.size() != b.pqData.size() || a.weightingFactors != b.weightingFactors)
+		return false;
+	for (auto ita = a.pqData.begin(), itb = b.pqData.begin(); ita != a.pqData.end(); ++ita, ++itb) {
+		if (ita->first != itb->first || ita->second.p != itb->second.p || ita->second.q != itb->second.q)
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	String simName = "CSVData";
+	Logger::setLogDir("logs/"+simName);
+	String dir = "logs/" + simName;
+	std::experimental::filesystem::create_directories(dir + "/profiles");
+
+	// A first row that starts with a negative number is data, not a title
+	auto titled = writeFile(dir + "/titled.csv", true, 0.5);
+	auto untitled = writeFile(dir + "/untitled.csv", false, -2.5);
+	for (UInt numThreads : { 1, 3, 8 }) {
+		if (!checkData(dir + "/titled.csv", titled, numThreads)
+			|| !checkData(dir + "/untitled.csv", untitled, numThreads))
+			return 1;
+	}
+
+	// Time of day is converted to seconds
+	{
+		std::ofstream file(dir + "/timeofday.csv");
+		file << "time,p\n00:00:10,1.5\n01:02:03,2.5\n23:59,3.5\n";
+	}
+	CSVData timeOfDay(dir + "/timeofday.csv", true, 1);
+	if (timeOfDay.rows() != 3 || timeOfDay.get(0, 0) != 10 || timeOfDay.get(1, 0) != 3723
+		|| timeOfDay.get(2, 0) != 86340 || timeOfDay.get(2, 1) != 3.5) {
+		std::cerr << "Time of day is not converted to seconds" << std::endl;
+		return 1;
+	}
+
+	// Profiles of several loads read on one and on several threads. The rows
+	// up to the first one after the end time are kept and the missing
+	// quarter seconds are interpolated.
+	SystemComponentList loads;
+	for (UInt k = 0; k < 6; k++) {
+		String name = "Load_" + std::to_string(k);
+		std::ofstream file(dir + "/profiles/" + name + ".csv");
+		file.precision(17);
+		file << "time,p,q\n";
+		for (UInt row = 0; row < 5000; row++)
+			file << row * 0.5 << "," << std::sin(row * 0.01 + k) << "," << std::cos(row * 0.02 * k) << "\n";
+		loads.push_back(SP::Ph1::Load::make(name));
+	}
+	SystemTopology sys(50, SystemNodeList{}, loads);
+
+	std::vector<PowerProfile> serial;
+	for (UInt numThreads : { 1, 4 }) {
+		CSVReader reader(simName, dir + "/profiles", Logger::Level::off);
+		reader.setNumThreads(numThreads);
+		reader.assignLoadProfile(sys, 0, 0.25, 2000);
+		for (UInt k = 0; k < loads.size(); k++) {
+			auto& profile = std::dynamic_pointer_cast<SP::Ph1::Load>(loads[k])->mLoadProfile;
+			if (numThreads == 1) {
+				if (profile.pqData.size() != 8002) {
+					std::cerr << loads[k]->name() << " has " << profile.pqData.size() << " samples" << std::endl;
+					return 1;
+				}
+				serial.push_back(profile);
+			} else if (!equal(profile, serial[k])) {
+				std::cerr << loads[k]->name() << " differs when read on several threads" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
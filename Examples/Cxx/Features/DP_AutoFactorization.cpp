@@ -0,0 +1,107 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Runs an RLC ladder with an adaptive time step and the automatic
+// factorization. The factorization must be selected once, although the
+// system is factorized again for every time step level, and the result
+// must match the LU.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.3;
+
+static Int countLines(String filename, String text) {
+	std::ifstream file(filename);
+	Int count = 0;
+	for (String line; std::getline(file, line); )
+		if (line.find(text) != String::npos)
+			count++;
+	return count;
+}
+
+static Complex runLadder(String simName, Solver::Factorization method, Int& steps) {
+	Logger::setLogDir("logs/" + simName);
+
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	std::vector<SimNode::Ptr> ladder;
+	for (UInt i = 0; i < 6; i++) {
+		ladder.push_back(SimNode::make("n" + std::to_string(i)));
+		nodes.push_back(ladder.back());
+	}
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ SimNode::GND, ladder[0] });
+	comps.push_back(vs);
+	for (UInt i = 1; i < ladder.size(); i++) {
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(1. * i);
+		r->connect({ ladder[i-1], ladder[i] });
+		auto l = Inductor::make("l" + std::to_string(i));
+		l->setParameters(1e-3);
+		l->connect({ ladder[i], SimNode::GND });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-5);
+		c->connect({ ladder[i], SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(l);
+		comps.push_back(c);
+	}
+
+	Simulation sim(simName, SystemTopology(50, nodes, comps), timeStep, finalTime,
+		CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::info);
+	sim.setFactorization(method);
+	sim.doAdaptiveTimeStep(true);
+	sim.setAdaptiveTimeSteps({ timeStep, 10 * timeStep, 100 * timeStep });
+	sim.run();
+
+	steps = sim.timeStepCount();
+	return ladder.back()->singleVoltage();
+}
+
+int main(int argc, char* argv[]) {
+	String name = "DP_AutoFactorization";
+	Int luSteps, autoSteps;
+	Complex lu = runLadder(name + "_LU", Solver::Factorization::LU, luSteps);
+	Complex automatic = runLadder(name + "_Auto", Solver::Factorization::Auto, autoSteps);
+
+	Int selections = countLines("logs/" + name + "_Auto/" + name + "_Auto_Solver.log",
+		"Selecting factorization");
+	std::cout << "Steps: " << autoSteps << ", factorization selections: " << selections << std::endl;
+	std::cout << "LU: " << lu << ", automatic: " << automatic << std::endl;
+
+	if (autoSteps >= Int(finalTime / timeStep)) {
+		std::cerr << "time step was not increased" << std::endl;
+		return 1;
+	}
+	if (selections != 1) {
+		std::cerr << "factorization was selected " << selections << " times" << std::endl;
+		return 1;
+	}
+	if (autoSteps != luSteps || std::abs(automatic - lu) > 1e-8 * std::abs(lu)) {
+		std::cerr << "automatic factorization deviates from LU" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
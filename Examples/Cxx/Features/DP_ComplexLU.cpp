@@ -0,0 +1,160 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <chrono>
+#include <fstream>
+#include <unistd.h>
+#include <DPsim.h>
+#include <dpsim/MNASolver.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Benchmark of the complex LU against the LU of the real system on meshes
+// with a fault switch. The complex LU only keeps the factors of the phasor
+// system, so the memory held by the solver has to drop to less than half,
+// while the node voltages of a fault simulation stay the same.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.05;
+
+/// Resident memory of the process in bytes
+static std::size_t residentMemory() {
+	std::ifstream statm("/proc/self/statm");
+	std::size_t size = 0, resident = 0;
+	statm >> size >> resident;
+	return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+static SystemTopology mesh(UInt width, UInt height, std::shared_ptr<Switch> &fault) {
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	std::vector<SimNode::Ptr> grid;
+	for (UInt i = 0; i < width * height; i++) {
+		auto n = SimNode::make("n" + std::to_string(i));
+		grid.push_back(n);
+		nodes.push_back(n);
+
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-6);
+		c->connect({ n, SimNode::GND });
+		comps.push_back(c);
+	}
+	for (UInt y = 0; y < height; y++) {
+		for (UInt x = 0; x < width; x++) {
+			UInt i = y * width + x;
+			if (x + 1 < width) {
+				auto r = Resistor::make("r" + std::to_string(i));
+				r->setParameters(0.1 + 0.01 * y);
+				r->connect({ grid[i], grid[i+1] });
+				comps.push_back(r);
+			}
+			if (y + 1 < height) {
+				auto l = Inductor::make("l" + std::to_string(i));
+				l->setParameters(1e-3 + 1e-5 * x);
+				l->connect({ grid[i], grid[i+width] });
+				comps.push_back(l);
+			}
+		}
+	}
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ SimNode::GND, grid[0] });
+	comps.push_back(vs);
+
+	auto load = Resistor::make("load");
+	load->setParameters(10);
+	load->connect({ grid.back(), SimNode::GND });
+	comps.push_back(load);
+
+	fault = Switch::make("fault");
+	fault->setParameters(1e9, 0.5);
+	fault->open();
+	fault->connect({ grid[width * height / 2], SimNode::GND });
+	comps.push_back(fault);
+
+	return SystemTopology(50, nodes, comps);
+}
+
+/// Memory held by an initialized solver, its initialization time and the
+/// size of its real system matrix
+static std::size_t solverMemory(Solver::Factorization method, Real &initTime, Eigen::Index &matrixSize) {
+	std::shared_ptr<Switch> fault;
+	auto sys = mesh(20, 15, fault);
+	std::size_t before = residentMemory();
+	auto start = std::chrono::steady_clock::now();
+	MnaSolver<Complex> solver("DP_ComplexLU_Memory", CPS::Domain::DP, CPS::Logger::Level::off);
+	solver.setTimeStep(timeStep);
+	solver.setFactorization(method);
+	solver.setSystem(sys);
+	solver.initialize();
+	initTime = std::chrono::duration<Real>(std::chrono::steady_clock::now() - start).count();
+	matrixSize = solver.systemMatrix().size();
+	return residentMemory() - before;
+}
+
+/// Run time of the simulation and the node voltages at its end
+static Real simulate(Solver::Factorization method, MatrixComp &voltages) {
+	std::shared_ptr<Switch> fault;
+	auto sys = mesh(10, 10, fault);
+	Simulation sim("DP_ComplexLU", sys, timeStep, finalTime, CPS::Domain::DP,
+		Solver::Type::MNA, CPS::Logger::Level::off);
+	sim.setFactorization(method);
+	sim.addEvent(SwitchEvent::make(finalTime / 2, fault, true));
+
+	auto start = std::chrono::steady_clock::now();
+	sim.run();
+	Real time = std::chrono::duration<Real>(std::chrono::steady_clock::now() - start).count();
+
+	voltages.resize(sys.mNodes.size(), 1);
+	for (UInt i = 0; i < sys.mNodes.size(); i++)
+		voltages(i, 0) = std::dynamic_pointer_cast<SimNode>(sys.mNodes[i])->singleVoltage();
+	return time;
+}
+
+int main(int argc, char* argv[]) {
+	Eigen::Index luMatrixSize, complexMatrixSize;
+	Real luInitTime, complexInitTime;
+	std::size_t luMemory = solverMemory(Solver::Factorization::LU, luInitTime, luMatrixSize);
+	std::size_t complexMemory = solverMemory(Solver::Factorization::ComplexLU, complexInitTime, complexMatrixSize);
+
+	MatrixComp luVoltages, complexVoltages;
+	Real luTime = simulate(Solver::Factorization::LU, luVoltages);
+	Real complexTime = simulate(Solver::Factorization::ComplexLU, complexVoltages);
+
+	std::cout << "LU:         " << luMemory / 1024 << " KiB solver memory, "
+		<< luInitTime << " s initialization, " << luTime << " s simulation" << std::endl;
+	std::cout << "complex LU: " << complexMemory / 1024 << " KiB solver memory, "
+		<< complexInitTime << " s initialization, " << complexTime << " s simulation" << std::endl;
+
+	if (luMatrixSize == 0 || complexMatrixSize != 0) {
+		std::cerr << "complex LU kept the real system matrix" << std::endl;
+		return 1;
+	}
+	if (2 * complexMemory >= luMemory) {
+		std::cerr << "complex LU does not save memory" << std::endl;
+		return 1;
+	}
+	Real deviation = (luVoltages - complexVoltages).cwiseAbs().maxCoeff();
+	if (deviation > 1e-9 * luVoltages.cwiseAbs().maxCoeff()) {
+		std::cerr << "node voltages differ by " << deviation << " V" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/ThreadLevelScheduler.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Runs the pre-fault part of an RC ladder once, stores a checkpoint and
+// forks one simulation per fault location from it. Each fork has to end
+// in the same state as a straight simulation of the same fault.
+
+static const Real timeStep = 1e-4;
+static const Real checkpointTime = 0.05;
+static const Real faultTime = 0.06;
+static const Real finalTime = 0.1;
+static const UInt numFaults = 3;
+
+struct Ladder {
+	SystemTopology sys;
+	std::vector<std::shared_ptr<Switch>> faults;
+};
+
+static Ladder createLadder() {
+	Ladder ladder;
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	for (UInt i = 0; i <= numFaults; i++)
+		nodes.push_back(SimNode::make("n" + std::to_string(i)));
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, std::dynamic_pointer_cast<SimNode>(nodes[0]) });
+	comps.push_back(vs);
+	for (UInt i = 1; i <= numFaults; i++) {
+		auto n0 = std::dynamic_pointer_cast<SimNode>(nodes[i-1]);
+		auto n1 = std::dynamic_pointer_cast<SimNode>(nodes[i]);
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(1);
+		r->connect({ n0, n1 });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-3);
+		c->connect({ n1, SimNode::GND });
+		auto sw = Switch::make("f" + std::to_string(i));
+		sw->setParameters(1e9, 0.1);
+		sw->open();
+		sw->connect({ n1, SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(c);
+		comps.push_back(sw);
+		ladder.faults.push_back(sw);
+	}
+	ladder.sys = SystemTopology(50, nodes, comps);
+	return ladder;
+}
+
+static Matrix nodeVoltages(const SystemTopology& sys) {
+	Matrix v(2 * sys.mNodes.size(), 1);
+	for (UInt i = 0; i < sys.mNodes.size(); i++) {
+		Complex vi = std::dynamic_pointer_cast<SimNode>(sys.mNodes[i])->singleVoltage();
+		v(2*i, 0) = vi.real();
+		v(2*i+1, 0) = vi.imag();
+	}
+	return v;
+}
+
+int main(int argc, char* argv[]) {
+	String simName = "DP_Contingencies";
+	Logger::setLogDir("logs/"+simName);
+
+	// Pre-fault simulation up to the checkpoint
+	CPS::Snapshot snapshot;
+	{
+		auto ladder = createLadder();
+		Simulation sim(simName + "_PreFault", ladder.sys, timeStep, finalTime);
+		sim.initialize();
+		while (sim.time() < checkpointTime)
+			sim.step();
+		sim.checkpoint(snapshot);
+	}
+
+	for (UInt fault = 0; fault < numFaults; fault++) {
+		String faultName = simName + "_Fault" + std::to_string(fault + 1);
+
+		// Straight simulation of the fault from the start
+		auto straight = createLadder();
+		Simulation straightSim(faultName + "_Straight", straight.sys, timeStep, finalTime);
+		straightSim.addEvent(SwitchEvent::make(faultTime, straight.faults[fault], true));
+		straightSim.run();
+
+		// Fork from the checkpoint with a parallel scheduler
+		auto fork = createLadder();
+		Simulation forkSim(faultName + "_Fork", fork.sys, timeStep, finalTime);
+		forkSim.setScheduler(std::make_shared<ThreadLevelScheduler>(2));
+		forkSim.addEvent(SwitchEvent::make(faultTime, fork.faults[fault], true));
+		forkSim.restore(snapshot);
+		forkSim.run();
+
+		if (forkSim.timeStepCount() != straightSim.timeStepCount()) {
+			std::cerr << faultName << ": fork ended after " << forkSim.timeStepCount()
+				<< " steps instead of " << straightSim.timeStepCount() << std::endl;
+			return 1;
+		}
+		Matrix diff = nodeVoltages(fork.sys) - nodeVoltages(straight.sys);
+		if (diff.lpNorm<Eigen::Infinity>() > 1e-9 * nodeVoltages(straight.sys).lpNorm<Eigen::Infinity>()) {
+			std::cerr << faultName << ": fork deviates from the straight simulation by "
+				<< diff.lpNorm<Eigen::Infinity>() << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Toggles the fault switches of an RC ladder many times, once with events
+// in the event queue and once with an event wheel whose horizon is much
+// shorter than the simulation. The wheel is filled from a CSV file and
+// stored to and loaded from a binary file. All runs have to log the same
+// voltages. Damaged binary files have to be rejected.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.2;
+static const UInt numFaults = 3;
+
+enum class Events { Queue, WheelCSV, WheelBinary };
+
+static std::vector<String> readLines(const String& filename) {
+	std::vector<String> lines;
+	std::ifstream file(filename);
+	for (String line; std::getline(file, line); )
+		lines.push_back(line);
+	return lines;
+}
+
+// Switch f<k> toggles every (k + 2) ms with an offset of k / 7 ms,
+// so that no event falls on a step boundary
+static void writeEvents(const String& filename) {
+	std::ofstream file(filename);
+	for (UInt fault = 1; fault <= numFaults; fault++) {
+		Bool closed = false;
+		for (Real time = fault / 7. * 1e-3; time < finalTime; time += (fault + 2) * 1e-3) {
+			closed = !closed;
+			file << time << ",f" << fault << "," << (closed ? 1 : 0) << "\n";
+		}
+	}
+}
+
+static std::vector<String> runLadder(String simName, Events events) {
+	Logger::setLogDir("logs/"+simName);
+
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	std::vector<std::shared_ptr<Switch>> faults;
+	for (UInt i = 0; i <= numFaults; i++)
+		nodes.push_back(SimNode::make("n" + std::to_string(i)));
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, std::dynamic_pointer_cast<SimNode>(nodes[0]) });
+	comps.push_back(vs);
+	for (UInt i = 1; i <= numFaults; i++) {
+		auto n0 = std::dynamic_pointer_cast<SimNode>(nodes[i-1]);
+		auto n1 = std::dynamic_pointer_cast<SimNode>(nodes[i]);
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(1);
+		r->connect({ n0, n1 });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-4);
+		c->connect({ n1, SimNode::GND });
+		auto sw = Switch::make("f" + std::to_string(i));
+		sw->setParameters(1e9, 0.1);
+		sw->open();
+		sw->connect({ n1, SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(c);
+		comps.push_back(sw);
+		faults.push_back(sw);
+	}
+
+	auto logger = DataLogger::make(simName);
+	for (auto node : nodes)
+		logger->addAttribute(node->name() + ".v", node->attribute("v"));
+
+	Simulation sim(simName, SystemTopology(50, nodes, comps), timeStep, finalTime);
+	sim.addLogger(logger);
+
+	// The wheel covers 1.6 ms, later events wait in its far list
+	auto wheel = EventWheel::make(timeStep, 16);
+	for (UInt fault = 0; fault < numFaults; fault++)
+		wheel->addTarget(faults[fault]->name(), faults[fault]);
+
+	if (events == Events::Queue) {
+		for (auto& line : readLines("DP_EventWheel_events.csv")) {
+			std::stringstream fields(line);
+			String time, target, value;
+			std::getline(fields, time, ',');
+			std::getline(fields, target, ',');
+			std::getline(fields, value, ',');
+			sim.addEvent(SwitchEvent::make(std::stod(time), faults[wheel->targetIndex(target)], value == "1"));
+		}
+	}
+	else {
+		wheel->loadCSV("DP_EventWheel_events.csv");
+		if (events == Events::WheelBinary) {
+			wheel->saveBinary("DP_EventWheel_events.bin");
+			wheel = EventWheel::make(timeStep, 16);
+			for (UInt fault = 0; fault < numFaults; fault++)
+				wheel->addTarget(faults[fault]->name(), faults[fault]);
+			wheel->loadBinary("DP_EventWheel_events.bin");
+		}
+		sim.addEventWheel(wheel);
+	}
+
+	sim.run();
+
+	if (wheel->pendingEvents() != 0 && events != Events::Queue)
+		throw CPS::SystemError("Event wheel kept events after the simulation");
+
+	return readLines("logs/" + simName + "/" + simName + ".csv");
+}
+
+// Loads a damaged copy of the binary event file
+static Bool rejects(const String& what, std::function<void(String&)> damage) {
+	std::ifstream in("DP_EventWheel_events.bin", std::ios_base::binary);
+	String content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	damage(content);
+	std::ofstream out("DP_EventWheel_damaged.bin", std::ios_base::binary | std::ios_base::trunc);
+	out.write(content.data(), content.size());
+	out.close();
+
+	try {
+		EventWheel::make(timeStep, 16)->loadBinary("DP_EventWheel_damaged.bin");
+	} catch (const CPS::SystemError&) {
+		return true;
+	}
+	std::cerr << "Event file with " << what << " was loaded" << std::endl;
+	return false;
+}
+
+int main(int argc, char* argv[]) {
+	writeEvents("DP_EventWheel_events.csv");
+
+	auto queue = runLadder("DP_EventWheel_Queue", Events::Queue);
+	auto csv = runLadder("DP_EventWheel_CSV", Events::WheelCSV);
+	auto binary = runLadder("DP_EventWheel_Binary", Events::WheelBinary);
+
+	if (csv != queue || binary != queue) {
+		std::cerr << "Event wheel results differ from the event queue" << std::endl;
+		return 1;
+	}
+
+	// The header holds magic, version and a 64 bit count of the events
+	if (!rejects("wrong magic", [](String& content) { content[0] ^= 1; })
+		|| !rejects("wrong version", [](String& content) { content[4] ^= 1; })
+		|| !rejects("huge count", [](String& content) { content[14] = 0x7f; })
+		|| !rejects("truncated record", [](String& content) { content.pop_back(); }))
+		return 1;
+
+	return 0;
+}
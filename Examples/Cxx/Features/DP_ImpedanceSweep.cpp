@@ -0,0 +1,112 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Sweeps the impedance of an RLC circuit and compares it with the
+// analytic impedance. A circuit with a component without admittance
+// stamp and a sweep at 0 Hz with an inductor have to be rejected.
+
+static const Real R1 = 2, L = 10e-3, C = 50e-6, R2 = 40;
+
+// Source at n1, R1 from n1 to n2, L from n2 to n3, C and R2 from n3 to ground
+static Simulation::Ptr makeSimulation(String simName, Bool currentSource, CPS::TopologicalNode::List& nodes) {
+	Logger::setLogDir("logs/"+simName);
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	auto r1 = Resistor::make("r1");
+	r1->setParameters(R1);
+	auto l = Inductor::make("l");
+	l->setParameters(L);
+	auto c = Capacitor::make("c");
+	c->setParameters(C);
+	auto r2 = Resistor::make("r2");
+	r2->setParameters(R2);
+
+	vs->connect({ SimNode::GND, n1 });
+	r1->connect({ n1, n2 });
+	l->connect({ n2, n3 });
+	c->connect({ n3, SimNode::GND });
+	r2->connect({ n3, SimNode::GND });
+
+	nodes = CPS::TopologicalNode::List{ n2, n3 };
+	SystemComponentList comps{ vs, r1, l, c, r2 };
+	if (currentSource) {
+		auto cs = CurrentSource::make("cs");
+		cs->setParameters(Complex(1, 0));
+		cs->connect({ SimNode::GND, n3 });
+		comps.push_back(cs);
+	}
+
+	auto sim = std::make_shared<Simulation>(simName, Logger::Level::off);
+	sim->setSystem(SystemTopology(50, SystemNodeList{ n1, n2, n3 }, comps));
+	sim->setDomain(Domain::DP);
+	sim->setTimeStep(1e-4);
+	sim->setFinalTime(0.01);
+	return sim;
+}
+
+int main(int argc, char* argv[]) {
+	CPS::TopologicalNode::List nodes, unsupportedNodes;
+	auto sim = makeSimulation("DP_ImpedanceSweep", false, nodes);
+
+	std::vector<Real> frequencies;
+	for (Real f = 1; f < 5000; f *= 1.1)
+		frequencies.push_back(f);
+	auto impedances = sim->impedanceSweep(frequencies, nodes);
+
+	for (std::size_t k = 0; k < frequencies.size(); k++) {
+		Real omega = 2 * PI * frequencies[k];
+		Complex zSeries = Complex(R1, omega * L);
+		Complex z33 = 1. / (1. / zSeries + Complex(0, omega * C) + 1. / R2);
+		Complex z23 = z33 * R1 / zSeries;
+		Complex z22 = 1. / (1. / R1 + 1. / (Complex(0, omega * L) + 1. / (Complex(0, omega * C) + 1. / R2)));
+
+		const MatrixComp& z = impedances[k];
+		Real diff = std::max({ std::abs(z(0, 0) - z22), std::abs(z(1, 1) - z33),
+			std::abs(z(0, 1) - z23), std::abs(z(1, 0) - z23) });
+		if (diff > 1e-9 * std::abs(z33)) {
+			std::cerr << "Impedance at " << frequencies[k] << " Hz differs by " << diff << std::endl;
+			return 1;
+		}
+	}
+
+	// A current source has no admittance stamp
+	auto unsupported = makeSimulation("DP_ImpedanceSweep_CurrentSource", true, unsupportedNodes);
+	try {
+		unsupported->impedanceSweep(frequencies, unsupportedNodes);
+		std::cerr << "Sweep with a current source did not fail" << std::endl;
+		return 1;
+	} catch (SolverException&) { }
+
+	// The inductor is a short circuit at 0 Hz
+	try {
+		sim->impedanceSweep({ 0, 50 }, nodes);
+		std::cerr << "Sweep at 0 Hz did not fail" << std::endl;
+		return 1;
+	} catch (CPS::SystemError&) { }
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/MNAFactorization.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Checks the explicit inverse solve mode. A switched circuit has to give the
+// same node voltages as with the LU in every step. Systems beyond the size
+// or memory limits and ill-conditioned systems must not use the inverse.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.1;
+
+static Bool checkLimits() {
+	Bool ok = true;
+	if (!MnaFactorization::inverseFits(MnaFactorization::maxInverseSize, 1)) {
+		std::cerr << "inverse of the largest allowed size was rejected" << std::endl;
+		ok = false;
+	}
+	if (MnaFactorization::inverseFits(MnaFactorization::maxInverseSize + 1, 1)) {
+		std::cerr << "inverse above the size limit was accepted" << std::endl;
+		ok = false;
+	}
+	// 1000 x 1000 doubles are 8 MB, 100 switch states exceed the memory limit
+	if (MnaFactorization::inverseFits(1000, 100) || !MnaFactorization::inverseFits(1000, 32)) {
+		std::cerr << "memory limit of the inverses is not applied" << std::endl;
+		ok = false;
+	}
+
+	// The inverse of the Hilbert matrix is dominated by rounding errors
+	Matrix hilbert(14, 14);
+	for (UInt i = 0; i < 14; i++)
+		for (UInt j = 0; j < 14; j++)
+			hilbert(i, j) = 1. / (i + j + 1);
+	MnaFactorization factorization;
+	factorization.compute(hilbert, Solver::Factorization::Inverse);
+	if (factorization.method() != Solver::Factorization::LU) {
+		std::cerr << "ill-conditioned system was not factorized with LU" << std::endl;
+		ok = false;
+	}
+	return ok;
+}
+
+/// Node voltages of every step of a ladder with two faults
+static std::vector<MatrixComp> simulate(Solver::Factorization method) {
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	std::vector<SimNode::Ptr> ladder;
+	for (UInt i = 0; i < 8; i++) {
+		ladder.push_back(SimNode::make("n" + std::to_string(i)));
+		nodes.push_back(ladder.back());
+	}
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ SimNode::GND, ladder[0] });
+	comps.push_back(vs);
+	for (UInt i = 1; i < ladder.size(); i++) {
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(0.5 * i);
+		r->connect({ ladder[i-1], ladder[i] });
+		auto l = Inductor::make("l" + std::to_string(i));
+		l->setParameters(1e-3);
+		l->connect({ ladder[i], SimNode::GND });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-5 * i);
+		c->connect({ ladder[i], SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(l);
+		comps.push_back(c);
+	}
+
+	auto fault1 = Switch::make("fault1");
+	fault1->setParameters(1e8, 0.1);
+	fault1->open();
+	fault1->connect({ ladder[3], SimNode::GND });
+	comps.push_back(fault1);
+	auto fault2 = Switch::make("fault2");
+	fault2->setParameters(1e8, 0.1);
+	fault2->open();
+	fault2->connect({ ladder[6], SimNode::GND });
+	comps.push_back(fault2);
+
+	Simulation sim("DP_InverseSolve", SystemTopology(50, nodes, comps), timeStep, finalTime,
+		CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::off);
+	sim.setFactorization(method);
+	sim.addEvent(SwitchEvent::make(0.02, fault1, true));
+	sim.addEvent(SwitchEvent::make(0.04, fault2, true));
+	sim.addEvent(SwitchEvent::make(0.06, fault1, false));
+	sim.addEvent(SwitchEvent::make(0.08, fault2, false));
+	sim.initialize();
+
+	std::vector<MatrixComp> voltages;
+	while (sim.time() < finalTime - timeStep / 2) {
+		sim.step();
+		MatrixComp v(ladder.size(), 1);
+		for (UInt i = 0; i < ladder.size(); i++)
+			v(i, 0) = ladder[i]->singleVoltage();
+		voltages.push_back(v);
+	}
+	return voltages;
+}
+
+int main(int argc, char* argv[]) {
+	if (!checkLimits())
+		return 1;
+
+	auto lu = simulate(Solver::Factorization::LU);
+	auto inverse = simulate(Solver::Factorization::Inverse);
+	Real maxDeviation = 0, maxVoltage = 0;
+	for (UInt step = 0; step < lu.size(); step++) {
+		maxDeviation = std::max(maxDeviation, (lu[step] - inverse[step]).cwiseAbs().maxCoeff());
+		maxVoltage = std::max(maxVoltage, lu[step].cwiseAbs().maxCoeff());
+	}
+	std::cout << "Largest deviation from LU: " << maxDeviation << " V" << std::endl;
+	if (lu.size() != inverse.size() || maxDeviation > 1e-10 * maxVoltage) {
+		std::cerr << "inverse solve results differ from LU" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
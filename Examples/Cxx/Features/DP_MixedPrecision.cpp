@@ -0,0 +1,144 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/MNAFactorization.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Checks the mixed precision factorization. Well-conditioned systems are
+// solved to double precision accuracy by the refinement, ill-conditioned
+// systems fall back to LU. A switched circuit has to give the same node
+// voltages as with the LU in every step.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.1;
+
+/// Normwise backward error of a solution
+static Real backwardError(const Matrix& sys, const Matrix& rightSide, const Matrix& solution) {
+	Real norm = sys.cwiseAbs().rowwise().sum().maxCoeff();
+	return (rightSide - sys * solution).lpNorm<Eigen::Infinity>()
+		/ (norm * solution.lpNorm<Eigen::Infinity>() + rightSide.lpNorm<Eigen::Infinity>());
+}
+
+static Bool checkFactorization() {
+	// Diagonally dominant, so single precision pivots are well-conditioned
+	Matrix sys = Matrix::Random(60, 60);
+	sys.diagonal().array() += 60;
+	Matrix rightSide = Matrix::Random(60, 1), solution;
+
+	MnaFactorization factorization;
+	factorization.compute(sys, Solver::Factorization::MixedPrecision);
+	if (factorization.method() != Solver::Factorization::MixedPrecision) {
+		std::cerr << "well-conditioned system was not factorized in single precision" << std::endl;
+		return false;
+	}
+	factorization.solve(rightSide, solution);
+	Real error = backwardError(sys, rightSide, solution);
+	std::cout << "Backward error after refinement: " << error << std::endl;
+	if (error > 1e-14) {
+		std::cerr << "refinement did not reach double precision" << std::endl;
+		return false;
+	}
+
+	// The Hilbert matrix exceeds the range of single precision
+	Matrix hilbert(12, 12);
+	for (UInt i = 0; i < 12; i++)
+		for (UInt j = 0; j < 12; j++)
+			hilbert(i, j) = 1. / (i + j + 1);
+	factorization.compute(hilbert, Solver::Factorization::MixedPrecision);
+	if (factorization.method() != Solver::Factorization::LU) {
+		std::cerr << "ill-conditioned system was not factorized with LU" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Node voltages of every step of a ladder with a fault
+static std::vector<MatrixComp> simulate(Solver::Factorization method) {
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	std::vector<SimNode::Ptr> ladder;
+	for (UInt i = 0; i < 6; i++) {
+		ladder.push_back(SimNode::make("n" + std::to_string(i)));
+		nodes.push_back(ladder.back());
+	}
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ SimNode::GND, ladder[0] });
+	comps.push_back(vs);
+	for (UInt i = 1; i < ladder.size(); i++) {
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(0.5 * i);
+		r->connect({ ladder[i-1], ladder[i] });
+		auto l = Inductor::make("l" + std::to_string(i));
+		l->setParameters(1e-3);
+		l->connect({ ladder[i], SimNode::GND });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-5 * i);
+		c->connect({ ladder[i], SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(l);
+		comps.push_back(c);
+	}
+
+	// Switch resistances far apart to stress single precision
+	auto fault = Switch::make("fault");
+	fault->setParameters(1e8, 1e-3);
+	fault->open();
+	fault->connect({ ladder[3], SimNode::GND });
+	comps.push_back(fault);
+
+	Simulation sim("DP_MixedPrecision", SystemTopology(50, nodes, comps), timeStep, finalTime,
+		CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::off);
+	sim.setFactorization(method);
+	sim.addEvent(SwitchEvent::make(0.03, fault, true));
+	sim.addEvent(SwitchEvent::make(0.06, fault, false));
+	sim.initialize();
+
+	std::vector<MatrixComp> voltages;
+	while (sim.time() < finalTime - timeStep / 2) {
+		sim.step();
+		MatrixComp v(ladder.size(), 1);
+		for (UInt i = 0; i < ladder.size(); i++)
+			v(i, 0) = ladder[i]->singleVoltage();
+		voltages.push_back(v);
+	}
+	return voltages;
+}
+
+int main(int argc, char* argv[]) {
+	if (!checkFactorization())
+		return 1;
+
+	auto lu = simulate(Solver::Factorization::LU);
+	auto mixed = simulate(Solver::Factorization::MixedPrecision);
+	Real maxDeviation = 0, maxVoltage = 0;
+	for (UInt step = 0; step < lu.size(); step++) {
+		maxDeviation = std::max(maxDeviation, (lu[step] - mixed[step]).cwiseAbs().maxCoeff());
+		maxVoltage = std::max(maxVoltage, lu[step].cwiseAbs().maxCoeff());
+	}
+	std::cout << "Largest deviation from LU: " << maxDeviation << " V" << std::endl;
+	if (lu.size() != mixed.size() || maxDeviation > 1e-10 * maxVoltage) {
+		std::cerr << "mixed precision results differ from LU" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
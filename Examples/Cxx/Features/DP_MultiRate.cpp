@@ -0,0 +1,179 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <thread>
+#include <DPsim.h>
+#include <dpsim/ThreadLevelScheduler.h>
+#include <dpsim/ThreadListScheduler.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Runs an RC ladder with a downsampled data logger on each scheduler and
+// checks that every scheduler logs the same rows as the sequential one.
+// A chain of tasks with a slower task in the middle has to keep its order
+// in the steps without the slower task, and rate divisors that would need
+// too many schedules are rejected.
+
+static const UInt downsampling = 3;
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.05;
+
+static std::vector<String> runLadder(String simName, std::shared_ptr<Scheduler> scheduler) {
+	Logger::setLogDir("logs/"+simName);
+
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	for (Int i = 0; i < 5; i++)
+		nodes.push_back(SimNode::make("n" + std::to_string(i)));
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, std::dynamic_pointer_cast<SimNode>(nodes[0]) });
+	comps.push_back(vs);
+	for (UInt i = 1; i < nodes.size(); i++) {
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(1);
+		r->connect({ std::dynamic_pointer_cast<SimNode>(nodes[i-1]), std::dynamic_pointer_cast<SimNode>(nodes[i]) });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-4);
+		c->connect({ std::dynamic_pointer_cast<SimNode>(nodes[i]), SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(c);
+	}
+
+	auto logger = DataLogger::make(simName, true, downsampling);
+	for (auto node : nodes)
+		logger->addAttribute(node->name() + ".v", node->attribute("v"));
+
+	Simulation sim(simName, SystemTopology(50, nodes, comps), timeStep, finalTime);
+	sim.addLogger(logger);
+	if (scheduler)
+		sim.setScheduler(scheduler);
+	sim.run();
+	logger->close();
+
+	std::vector<String> rows;
+	std::ifstream file("logs/" + simName + "/" + simName + ".csv");
+	for (String line; std::getline(file, line); )
+		rows.push_back(line);
+	return rows;
+}
+
+/// Task that records the time it was started and finished
+class TimedTask : public CPS::Task {
+public:
+	TimedTask(String name, UInt rateDivisor, Real sleep,
+		CPS::AttributeBase::List dependencies, CPS::AttributeBase::List modified) :
+		Task(name), mSleep(sleep) {
+		setRateDivisor(rateDivisor);
+		mAttributeDependencies = dependencies;
+		mModifiedAttributes = modified;
+	}
+
+	void execute(Real time, Int timeStepCount) {
+		mStart = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(std::chrono::duration<Real>(mSleep));
+		mEnd = std::chrono::steady_clock::now();
+	}
+
+	std::chrono::steady_clock::time_point mStart, mEnd;
+
+private:
+	Real mSleep;
+};
+
+static Bool checkChain(String name, std::shared_ptr<Scheduler> scheduler) {
+	Real a = 0, b = 0;
+	auto aAttr = CPS::Attribute<Real>::make(&a, CPS::Flags::read | CPS::Flags::write);
+	auto bAttr = CPS::Attribute<Real>::make(&b, CPS::Flags::read | CPS::Flags::write);
+	auto first = std::make_shared<TimedTask>("first", 1, 2e-3,
+		CPS::AttributeBase::List{}, CPS::AttributeBase::List{ aAttr });
+	auto slow = std::make_shared<TimedTask>("slow", 2, 0,
+		CPS::AttributeBase::List{ aAttr }, CPS::AttributeBase::List{ bAttr });
+	auto last = std::make_shared<TimedTask>("last", 1, 0,
+		CPS::AttributeBase::List{ bAttr }, CPS::AttributeBase::List{ Scheduler::external });
+
+	CPS::Task::List tasks = { first, slow, last };
+	Scheduler::Edges inEdges, outEdges;
+	scheduler->resolveDeps(tasks, inEdges, outEdges);
+	scheduler->createSchedule(tasks, inEdges, outEdges);
+	for (Int step = 0; step < 10; step++) {
+		scheduler->step(step * timeStep, step);
+		if (last->mStart < first->mEnd) {
+			std::cerr << name << " started the last task before the first one finished in step " << step << std::endl;
+			scheduler->stop();
+			return false;
+		}
+	}
+	scheduler->stop();
+	return true;
+}
+
+static Bool checkPhaseLimit() {
+	auto fast = std::make_shared<TimedTask>("fast", 1000, 0,
+		CPS::AttributeBase::List{}, CPS::AttributeBase::List{ Scheduler::external });
+	auto slow = std::make_shared<TimedTask>("slow", 999, 0,
+		CPS::AttributeBase::List{}, CPS::AttributeBase::List{ Scheduler::external });
+
+	CPS::Task::List tasks = { fast, slow };
+	Scheduler::Edges inEdges, outEdges;
+	ThreadLevelScheduler scheduler(2);
+	scheduler.resolveDeps(tasks, inEdges, outEdges);
+	try {
+		scheduler.createSchedule(tasks, inEdges, outEdges);
+	} catch (SchedulingException&) {
+		return true;
+	}
+	std::cerr << "Schedules for 999000 rate phases were created" << std::endl;
+	return false;
+}
+
+int main(int argc, char* argv[]) {
+	auto reference = runLadder("DP_MultiRate_Sequential", nullptr);
+
+	// Header plus one row for every third step
+	UInt steps = static_cast<UInt>(std::round(finalTime / timeStep));
+	UInt expected = 1 + (steps + downsampling - 1) / downsampling;
+	if (reference.size() != expected) {
+		std::cerr << "Logged " << reference.size() << " rows, expected " << expected << std::endl;
+		return 1;
+	}
+
+	std::map<String, std::shared_ptr<Scheduler>> schedulers = {
+		{ "ThreadLevel", std::make_shared<ThreadLevelScheduler>(2) },
+		{ "ThreadList", std::make_shared<ThreadListScheduler>(2) },
+#ifdef WITH_OPENMP
+		{ "OpenMPLevel", std::make_shared<OpenMPLevelScheduler>(2) },
+#endif
+	};
+	for (auto& sched : schedulers) {
+		auto rows = runLadder("DP_MultiRate_" + sched.first, sched.second);
+		if (rows != reference) {
+			std::cerr << sched.first << " logged different rows than the sequential scheduler" << std::endl;
+			return 1;
+		}
+	}
+
+	if (!checkChain("ThreadLevel", std::make_shared<ThreadLevelScheduler>(2))
+		|| !checkChain("ThreadList", std::make_shared<ThreadListScheduler>(2))
+		|| !checkPhaseLimit())
+		return 1;
+
+	return 0;
+}
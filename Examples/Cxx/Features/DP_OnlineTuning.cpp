@@ -0,0 +1,144 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/SequentialScheduler.h>
+#include <dpsim/ThreadListScheduler.h>
+#include <dpsim/ThreadLevelScheduler.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Simulates independent subnets with thread schedulers that are tuned with
+// the task times measured during the simulation. The tuned schedules have
+// to be activated without changing the results of a sequential simulation.
+// Without drift, the schedule is only recreated after the first measurements.
+// A schedule that is still being recreated when the scheduler is reset is
+// discarded.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.05;
+static const UInt numSubnets = 4;
+
+static std::vector<MatrixComp> simulate(String simName, std::shared_ptr<Scheduler> scheduler, Int resetStep = -1) {
+	Logger::setLogDir("logs/" + simName);
+
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	std::vector<SimNode::Ptr> loads;
+	std::shared_ptr<Switch> fault;
+	for (UInt net = 0; net < numSubnets; net++) {
+		String suffix = "_" + std::to_string(net);
+		auto n1 = SimNode::make("n1" + suffix);
+		auto n2 = SimNode::make("n2" + suffix);
+
+		auto vs = VoltageSource::make("vs" + suffix);
+		vs->setParameters(Complex(100 * (net + 1), 0));
+		vs->connect({ SimNode::GND, n1 });
+		auto r = Resistor::make("r" + suffix);
+		r->setParameters(1 + net);
+		r->connect({ n1, n2 });
+		auto l = Inductor::make("l" + suffix);
+		l->setParameters(1e-3);
+		l->connect({ n2, SimNode::GND });
+		auto c = Capacitor::make("c" + suffix);
+		c->setParameters(1e-5);
+		c->connect({ n2, SimNode::GND });
+		nodes.push_back(n1);
+		nodes.push_back(n2);
+		comps.push_back(vs);
+		comps.push_back(r);
+		comps.push_back(l);
+		comps.push_back(c);
+		loads.push_back(n2);
+
+		if (net == 0) {
+			fault = Switch::make("fault");
+			fault->setParameters(1e8, 0.1);
+			fault->open();
+			fault->connect({ n2, SimNode::GND });
+			comps.push_back(fault);
+		}
+	}
+
+	Simulation sim(simName, SystemTopology(50, nodes, comps), timeStep, finalTime,
+		CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::off);
+	sim.setScheduler(scheduler);
+	sim.addEvent(SwitchEvent::make(0.02, fault, true));
+	sim.initialize();
+
+	std::vector<MatrixComp> voltages;
+	while (sim.time() < finalTime - timeStep / 2) {
+		if (sim.timeStepCount() == resetStep)
+			sim.scheduler()->reset(resetStep);
+		sim.step();
+		MatrixComp v(loads.size(), 1);
+		for (UInt i = 0; i < loads.size(); i++)
+			v(i, 0) = loads[i]->singleVoltage();
+		voltages.push_back(v);
+	}
+	sim.scheduler()->stop();
+	return voltages;
+}
+
+static Bool check(String name, std::shared_ptr<ThreadScheduler> scheduler,
+	const std::vector<MatrixComp>& reference, UInt minTuned, UInt maxTuned, Int resetStep = -1) {
+	auto voltages = simulate(name, scheduler, resetStep);
+	std::cout << name << ": " << scheduler->tunedSchedules() << " tuned schedules" << std::endl;
+
+	if (scheduler->tunedSchedules() < minTuned || scheduler->tunedSchedules() > maxTuned) {
+		std::cerr << name << ": expected between " << minTuned << " and " << maxTuned
+			<< " tuned schedules" << std::endl;
+		return false;
+	}
+	for (UInt step = 0; step < reference.size(); step++) {
+		if ((voltages[step] - reference[step]).cwiseAbs().maxCoeff() > 1e-9 * reference[step].cwiseAbs().maxCoeff()) {
+			std::cerr << name << ": results differ from the sequential schedule in step " << step << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	auto reference = simulate("DP_OnlineTuning_Sequential", std::make_shared<SequentialScheduler>());
+
+	// Any measured drift leads to a new schedule in each retune period
+	auto list = std::make_shared<ThreadListScheduler>(2);
+	list->setOnlineTuning(20, 100, 0);
+	if (!check("DP_OnlineTuning_List", list, reference, 2, 5))
+		return 1;
+
+	auto level = std::make_shared<ThreadLevelScheduler>(2);
+	level->setOnlineTuning(20, 100, 0);
+	if (!check("DP_OnlineTuning_Level", level, reference, 2, 5))
+		return 1;
+
+	// The task times never drift this far from the first measurements
+	auto stable = std::make_shared<ThreadListScheduler>(2);
+	stable->setOnlineTuning(20, 100, 1e6);
+	if (!check("DP_OnlineTuning_Stable", stable, reference, 1, 1))
+		return 1;
+
+	// The reset directly follows the start of the recreation
+	auto reset = std::make_shared<ThreadListScheduler>(2);
+	reset->setOnlineTuning(20);
+	if (!check("DP_OnlineTuning_Reset", reset, reference, 0, 0, 21))
+		return 1;
+
+	return 0;
+}
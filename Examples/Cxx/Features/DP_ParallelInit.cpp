@@ -0,0 +1,102 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Initializes a ladder with several fault switches on one and on four
+// threads. The components and all switching states are initialized in
+// parallel, but the component logs and results have to be identical.
+
+static const UInt numFaults = 3;
+
+static String readFile(const String& filename) {
+	std::ifstream file(filename);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+static Matrix runLadder(String simName, UInt threads) {
+	Logger::setLogDir("logs/"+simName);
+
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	for (UInt i = 0; i <= numFaults; i++)
+		nodes.push_back(SimNode::make("n" + std::to_string(i)));
+
+	auto vs = VoltageSource::make("vs", Logger::Level::info);
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, std::dynamic_pointer_cast<SimNode>(nodes[0]) });
+	comps.push_back(vs);
+	for (UInt i = 1; i <= numFaults; i++) {
+		auto n0 = std::dynamic_pointer_cast<SimNode>(nodes[i-1]);
+		auto n1 = std::dynamic_pointer_cast<SimNode>(nodes[i]);
+		auto r = Resistor::make("r" + std::to_string(i), Logger::Level::info);
+		r->setParameters(1);
+		r->connect({ n0, n1 });
+		auto c = Capacitor::make("c" + std::to_string(i), Logger::Level::info);
+		c->setParameters(1e-3);
+		c->connect({ n1, SimNode::GND });
+		auto sw = Switch::make("f" + std::to_string(i), Logger::Level::info);
+		sw->setParameters(1e9, 0.1);
+		sw->open();
+		sw->connect({ n1, SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(c);
+		comps.push_back(sw);
+	}
+
+	Simulation sim(simName, SystemTopology(50, nodes, comps), 1e-4, 0.01);
+	sim.setThreadBudget(threads);
+	sim.run();
+
+	Matrix v(2 * nodes.size(), 1);
+	for (UInt i = 0; i < nodes.size(); i++) {
+		Complex vi = std::dynamic_pointer_cast<SimNode>(nodes[i])->singleVoltage();
+		v(2*i, 0) = vi.real();
+		v(2*i+1, 0) = vi.imag();
+	}
+	return v;
+}
+
+int main(int argc, char* argv[]) {
+	Matrix serial = runLadder("DP_ParallelInit_Serial", 1);
+	Matrix parallel = runLadder("DP_ParallelInit_Parallel", 4);
+
+	if (serial != parallel) {
+		std::cerr << "Parallel initialization changed the results" << std::endl;
+		return 1;
+	}
+
+	for (UInt i = 1; i <= numFaults; i++) {
+		for (String comp : { "r", "c", "f" }) {
+			String name = comp + std::to_string(i) + ".log";
+			String serialLog = readFile("logs/DP_ParallelInit_Serial/" + name);
+			if (serialLog.empty() || serialLog != readFile("logs/DP_ParallelInit_Parallel/" + name)) {
+				std::cerr << "Log " << name << " differs between serial and parallel initialization" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <DPsim.h>
+#include <dpsim/ThreadLevelScheduler.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Writes full-rate and downsampled data loggers with and without the
+// output pipeline. The pipelined CSV files have to be identical to the
+// files written directly by the step, also with a thread scheduler.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.05;
+
+static void simulate(String simName, Bool pipelined, std::shared_ptr<Scheduler> scheduler) {
+	Logger::setLogDir("logs/" + simName);
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ SimNode::GND, n1 });
+	auto r = Resistor::make("r");
+	r->setParameters(1);
+	r->connect({ n1, n2 });
+	auto l = Inductor::make("l");
+	l->setParameters(1e-3);
+	l->connect({ n2, SimNode::GND });
+	auto c = Capacitor::make("c");
+	c->setParameters(1e-5);
+	c->connect({ n2, SimNode::GND });
+	auto fault = Switch::make("fault");
+	fault->setParameters(1e8, 0.1);
+	fault->open();
+	fault->connect({ n2, SimNode::GND });
+
+	auto full = DataLogger::make(String("full"));
+	full->addAttribute("v1", n1->attribute("v"));
+	full->addAttribute("v2", n2->attribute("v"));
+	full->addAttribute("i_l", l->attribute("i_intf"));
+	auto downsampled = DataLogger::make("downsampled", true, 7);
+	downsampled->addAttribute("v2", n2->attribute("v"));
+
+	Simulation sim(simName, SystemTopology(50, SystemNodeList{ n1, n2 },
+		SystemComponentList{ vs, r, l, c, fault }),
+		timeStep, finalTime, CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::off);
+	sim.addLogger(full);
+	sim.addLogger(downsampled);
+	sim.addEvent(SwitchEvent::make(0.02, fault, true));
+	sim.addEvent(SwitchEvent::make(0.035, fault, false));
+	sim.setPipelinedOutput(pipelined);
+	if (scheduler)
+		sim.setScheduler(scheduler);
+	sim.run();
+}
+
+static String readFile(String filename) {
+	std::ifstream file(filename);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+static Bool compare(String simName, String reference) {
+	for (String logger : { "full", "downsampled" }) {
+		String expected = readFile("logs/" + reference + "/" + logger + ".csv");
+		String actual = readFile("logs/" + simName + "/" + logger + ".csv");
+		if (expected.empty() || actual != expected) {
+			std::cerr << simName << ": " << logger << ".csv differs from the direct output" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	simulate("DP_PipelinedOutput_Direct", false, nullptr);
+	simulate("DP_PipelinedOutput_Pipelined", true, nullptr);
+	simulate("DP_PipelinedOutput_Threads", true, std::make_shared<ThreadLevelScheduler>(2));
+
+	String lines = readFile("logs/DP_PipelinedOutput_Direct/full.csv");
+	Int steps = static_cast<Int>(std::count(lines.begin(), lines.end(), '\n')) - 1;
+	std::cout << "Logged steps: " << steps << std::endl;
+	if (steps != Int(std::round(finalTime / timeStep))) {
+		std::cerr << "Direct output misses steps" << std::endl;
+		return 1;
+	}
+
+	if (!compare("DP_PipelinedOutput_Pipelined", "DP_PipelinedOutput_Direct")
+		|| !compare("DP_PipelinedOutput_Threads", "DP_PipelinedOutput_Direct"))
+		return 1;
+
+	return 0;
+}
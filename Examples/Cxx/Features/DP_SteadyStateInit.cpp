@@ -0,0 +1,87 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <chrono>
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Initializes an RC circuit by steady-state initialization with the
+// simulation time step and with a larger initialization time step and
+// checks that both start the simulation in the analytic steady state.
+
+static const Real timeStep = 1e-4;
+static const Real resistance = 1;
+static const Real capacitance = 1e-3;
+
+static Complex runRC(String simName, Bool init, Real initTimeStep) {
+	Logger::setLogDir("logs/"+simName);
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, n1 });
+	auto r1 = Resistor::make("r_1");
+	r1->setParameters(resistance);
+	r1->connect({ n1, n2 });
+	auto c1 = Capacitor::make("c_1");
+	c1->setParameters(capacitance);
+	c1->connect({ n2, SimNode::GND });
+
+	auto sys = SystemTopology(50, SystemNodeList{ n1, n2 }, SystemComponentList{ vs, r1, c1 });
+
+	auto logger = DataLogger::make(simName);
+	logger->addAttribute("v2", n2->attribute("v"));
+
+	Simulation sim(simName, sys, timeStep, 10 * timeStep);
+	sim.addLogger(logger);
+	sim.doSteadyStateInit(init);
+	sim.setSteadStIniTimeStep(initTimeStep);
+	sim.setSteadStIniAccLimit(1e-6);
+
+	auto start = std::chrono::steady_clock::now();
+	sim.run();
+	std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+	std::cout << simName << ": " << duration.count() << " s" << std::endl;
+
+	return n2->singleVoltage();
+}
+
+int main(int argc, char* argv[]) {
+	Complex steadyState = Complex(10, 0) / Complex(1, 2. * PI * 50 * resistance * capacitance);
+
+	Complex noInit = runRC("DP_SteadyStateInit_None", false, 0);
+	Complex simStep = runRC("DP_SteadyStateInit_SimStep", true, 0);
+	Complex largeStep = runRC("DP_SteadyStateInit_LargeStep", true, 10 * timeStep);
+
+	// Without initialization, the capacitor is still charging
+	if (std::abs(noInit - steadyState) < 0.01 * std::abs(steadyState)) {
+		std::cerr << "Circuit without initialization is already in steady state" << std::endl;
+		return 1;
+	}
+	for (auto v : { simStep, largeStep }) {
+		if (std::abs(v - steadyState) > 1e-3 * std::abs(steadyState)) {
+			std::cerr << "Initialized voltage " << v << " differs from steady state " << steadyState << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
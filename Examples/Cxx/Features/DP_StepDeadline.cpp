@@ -0,0 +1,217 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <thread>
+#include <DPsim.h>
+#include <dpsim/SequentialScheduler.h>
+#include <dpsim/ThreadListScheduler.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Checks the step deadline. Deferrable tasks have to be skipped in the
+// steps in which a critical task is slow and executed again afterwards.
+// Deferrable tasks without critical successors run after the critical ones,
+// and skipped tasks must not block their successors in thread schedulers.
+// In a simulation, only the data loggers are skipped and the results stay
+// the same.
+
+using TaskTime = Scheduler::TaskTime;
+
+/// Sleeps for a given time per step and records its executions
+class SleepTask : public CPS::Task {
+public:
+	SleepTask(String name, std::function<TaskTime(Int)> duration, std::vector<String>& trace,
+		CPS::AttributeBase::List dependencies, CPS::AttributeBase::List modified) :
+		Task(name), mDuration(duration), mTrace(trace) {
+		mAttributeDependencies = dependencies;
+		mModifiedAttributes = modified;
+	}
+
+	void execute(Real time, Int timeStepCount) {
+		std::this_thread::sleep_for(mDuration(timeStepCount));
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTrace.push_back(mName + "@" + std::to_string(timeStepCount));
+	}
+
+	Bool executed(Int timeStepCount) const {
+		return std::find(mTrace.begin(), mTrace.end(), mName + "@" + std::to_string(timeStepCount)) != mTrace.end();
+	}
+
+private:
+	std::function<TaskTime(Int)> mDuration;
+	std::vector<String>& mTrace;
+	static std::mutex mMutex;
+};
+
+std::mutex SleepTask::mMutex;
+
+static TaskTime ms(Real t) {
+	return std::chrono::duration_cast<TaskTime>(std::chrono::duration<Real, std::milli>(t));
+}
+
+static void createSchedule(Scheduler& scheduler, CPS::Task::List tasks) {
+	Scheduler::Edges inEdges, outEdges;
+	scheduler.resolveDeps(tasks, inEdges, outEdges);
+	scheduler.createSchedule(tasks, inEdges, outEdges);
+}
+
+static Bool checkSpikes() {
+	const Int steps = 60, spikeStart = 20, spikeEnd = 23;
+	Real x = 0;
+	auto xAttr = CPS::Attribute<Real>::make(&x, CPS::Flags::read | CPS::Flags::write);
+	std::vector<String> trace;
+
+	// Without dependencies, the monitor would be a candidate for the first task
+	auto monitor = std::make_shared<SleepTask>("monitor", [](Int) { return ms(0.2); }, trace,
+		CPS::AttributeBase::List{}, CPS::AttributeBase::List{ Scheduler::external });
+	auto solve = std::make_shared<SleepTask>("solve",
+		[=](Int step) { return step >= spikeStart && step < spikeEnd ? ms(10) : ms(0); }, trace,
+		CPS::AttributeBase::List{}, CPS::AttributeBase::List{ xAttr });
+	auto log = std::make_shared<SleepTask>("log", [](Int) { return ms(0.5); }, trace,
+		CPS::AttributeBase::List{ xAttr }, CPS::AttributeBase::List{ Scheduler::external });
+	monitor->setDeferrable(true);
+	log->setDeferrable(true);
+
+	SequentialScheduler scheduler;
+	scheduler.setStepDeadline(ms(5));
+	createSchedule(scheduler, { monitor, solve, log });
+
+	for (Int step = 0; step < steps; step++) {
+		trace.clear();
+		scheduler.step(step * 1e-3, step);
+		Bool spike = step >= spikeStart && step < spikeEnd;
+		if (!solve->executed(step)) {
+			std::cerr << "critical task skipped in step " << step << std::endl;
+			return false;
+		}
+		if (spike == log->executed(step) || spike == monitor->executed(step)) {
+			std::cerr << "deferrable tasks " << (spike ? "executed" : "skipped")
+				<< " in step " << step << std::endl;
+			return false;
+		}
+		if (!spike && trace.front() != "solve@" + std::to_string(step)) {
+			std::cerr << "deferrable task executed before the critical task in step " << step << std::endl;
+			return false;
+		}
+	}
+	scheduler.stop();
+
+	auto shed = scheduler.shedTasks();
+	std::cout << "Skipped during " << spikeEnd - spikeStart << " slow steps: log " << shed["log"]
+		<< " times, monitor " << shed["monitor"] << " times" << std::endl;
+	return shed["log"] == UInt(spikeEnd - spikeStart) && shed["monitor"] == UInt(spikeEnd - spikeStart);
+}
+
+static Bool checkThreadScheduler() {
+	const Int steps = 50;
+	Real y = 0;
+	auto yAttr = CPS::Attribute<Real>::make(&y, CPS::Flags::read | CPS::Flags::write);
+	std::vector<String> trace;
+
+	// The filter always misses the deadline, the control depends on it
+	auto filter = std::make_shared<SleepTask>("filter", [](Int) { return ms(0.1); }, trace,
+		CPS::AttributeBase::List{}, CPS::AttributeBase::List{ yAttr });
+	auto control = std::make_shared<SleepTask>("control", [](Int) { return ms(0); }, trace,
+		CPS::AttributeBase::List{ yAttr }, CPS::AttributeBase::List{ Scheduler::external });
+	filter->setDeferrable(true);
+
+	ThreadListScheduler scheduler(2);
+	scheduler.setStepDeadline(TaskTime(1));
+	createSchedule(scheduler, { filter, control });
+
+	for (Int step = 0; step < steps; step++) {
+		trace.clear();
+		scheduler.step(step * 1e-3, step);
+		if (!control->executed(step) || filter->executed(step)) {
+			std::cerr << "thread scheduler did not skip only the deferrable task in step " << step << std::endl;
+			return false;
+		}
+	}
+	scheduler.stop();
+	return scheduler.shedTasks()["filter"] == UInt(steps);
+}
+
+static Complex simulate(String simName, Real deadline, std::shared_ptr<Scheduler>& scheduler) {
+	Logger::setLogDir("logs/" + simName);
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ SimNode::GND, n1 });
+	auto r = Resistor::make("r");
+	r->setParameters(1);
+	r->connect({ n1, n2 });
+	auto l = Inductor::make("l");
+	l->setParameters(1e-3);
+	l->connect({ n2, SimNode::GND });
+
+	auto logger = DataLogger::make(simName);
+	logger->addAttribute("v2", n2->attribute("v"));
+
+	Simulation sim(simName, SystemTopology(50, SystemNodeList{ n1, n2 }, SystemComponentList{ vs, r, l }),
+		1e-4, 0.01, CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::off);
+	sim.addLogger(logger);
+	sim.setStepDeadline(deadline);
+	sim.run();
+
+	scheduler = sim.scheduler();
+	return n2->singleVoltage();
+}
+
+static Int countLines(String filename) {
+	std::ifstream file(filename);
+	Int count = 0;
+	for (String line; std::getline(file, line); )
+		count++;
+	return count;
+}
+
+static Bool checkSimulation() {
+	std::shared_ptr<Scheduler> relaxed, strict;
+	Complex reference = simulate("DP_StepDeadline_Relaxed", 1, relaxed);
+	Complex result = simulate("DP_StepDeadline_Strict", 1e-9, strict);
+
+	auto shed = strict->shedTasks();
+	UInt loggerShed = 0;
+	for (auto& task : shed)
+		loggerShed += task.second;
+	Int relaxedLines = countLines("logs/DP_StepDeadline_Relaxed/DP_StepDeadline_Relaxed.csv");
+	Int strictLines = countLines("logs/DP_StepDeadline_Strict/DP_StepDeadline_Strict.csv");
+	std::cout << "Logged lines: " << relaxedLines << " with a relaxed deadline, "
+		<< strictLines << " with a strict deadline" << std::endl;
+
+	// The header is written with the first line, one line per step follows
+	if (shed.size() != 1 || strictLines != 0 || Int(loggerShed) != relaxedLines - 1) {
+		std::cerr << "only the data logger should be skipped with the strict deadline" << std::endl;
+		return false;
+	}
+	if (std::abs(result - reference) > 1e-12 * std::abs(reference)) {
+		std::cerr << "skipped tasks changed the simulation results" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	if (!checkSpikes() || !checkThreadScheduler() || !checkSimulation())
+		return 1;
+
+	return 0;
+}
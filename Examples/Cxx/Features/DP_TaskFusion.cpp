@@ -0,0 +1,120 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <fstream>
+#include <DPsim.h>
+#include <dpsim/ThreadLevelScheduler.h>
+#include <dpsim/ThreadListScheduler.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Simulates an RC ladder with many small tasks on each parallel scheduler
+// with task fusion. The results have to match the sequential scheduler.
+// The measurement files have to list a time for every task instead of the
+// fused tasks, and a list scheduler has to accept them as input.
+
+static std::vector<String> readLines(const String& filename) {
+	std::vector<String> lines;
+	std::ifstream file(filename);
+	for (String line; std::getline(file, line); )
+		lines.push_back(line);
+	return lines;
+}
+
+static std::vector<String> runLadder(String simName, std::shared_ptr<Scheduler> scheduler) {
+	Logger::setLogDir("logs/"+simName);
+
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	for (Int i = 0; i < 20; i++)
+		nodes.push_back(SimNode::make("n" + std::to_string(i)));
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, std::dynamic_pointer_cast<SimNode>(nodes[0]) });
+	comps.push_back(vs);
+	for (UInt i = 1; i < nodes.size(); i++) {
+		auto r = Resistor::make("r" + std::to_string(i));
+		r->setParameters(1);
+		r->connect({ std::dynamic_pointer_cast<SimNode>(nodes[i-1]), std::dynamic_pointer_cast<SimNode>(nodes[i]) });
+		auto c = Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-4);
+		c->connect({ std::dynamic_pointer_cast<SimNode>(nodes[i]), SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(c);
+	}
+
+	auto logger = DataLogger::make(simName);
+	for (auto node : nodes)
+		logger->addAttribute(node->name() + ".v", node->attribute("v"));
+
+	Simulation sim(simName, SystemTopology(50, nodes, comps), 1e-4, 0.01);
+	sim.addLogger(logger);
+	if (scheduler) {
+		// Fuse tasks until each one is expected to take 10 us
+		scheduler->setTaskGranularity(std::chrono::microseconds(10));
+		sim.setScheduler(scheduler);
+	}
+	sim.run();
+
+	return readLines("logs/" + simName + "/" + simName + ".csv");
+}
+
+int main(int argc, char* argv[]) {
+	auto reference = runLadder("DP_TaskFusion_Sequential", nullptr);
+
+	std::map<String, std::shared_ptr<Scheduler>> schedulers = {
+		{ "ThreadLevel", std::make_shared<ThreadLevelScheduler>(2, "measurements_ThreadLevel.txt") },
+		{ "ThreadList", std::make_shared<ThreadListScheduler>(2, "measurements_ThreadList.txt") },
+#ifdef WITH_OPENMP
+		{ "OpenMPLevel", std::make_shared<OpenMPLevelScheduler>(2, "measurements_OpenMPLevel.txt") },
+#endif
+	};
+	for (auto& sched : schedulers) {
+		if (runLadder("DP_TaskFusion_" + sched.first, sched.second) != reference) {
+			std::cerr << sched.first << " changed the results" << std::endl;
+			return 1;
+		}
+
+		// Measured tasks are listed as "name,time", each task of the
+		// fused tasks has its own time
+		auto lines = readLines("measurements_" + sched.first + ".txt");
+		for (auto& line : lines) {
+			String name = line.substr(0, line.find(','));
+			if (name.find('+') != String::npos) {
+				std::cerr << sched.first << " wrote a fused task: " << name << std::endl;
+				return 1;
+			}
+			if (std::stol(line.substr(line.find(',') + 1)) <= 0) {
+				std::cerr << sched.first << " wrote no time for " << name << std::endl;
+				return 1;
+			}
+		}
+		std::cout << sched.first << ": " << lines.size() << " measured tasks" << std::endl;
+	}
+
+	// The measured times are complete for the fused schedule. Task names
+	// contain the simulation name, so the run is repeated under the same name.
+	auto measured = std::make_shared<ThreadListScheduler>(2, "", "measurements_ThreadList.txt");
+	if (runLadder("DP_TaskFusion_ThreadList", measured) != reference) {
+		std::cerr << "Measured schedule changed the results" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
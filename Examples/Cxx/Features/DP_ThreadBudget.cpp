@@ -0,0 +1,89 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/Utils.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+using namespace CPS::DP::Ph1;
+
+// Checks that the thread budget of a simulation is applied while it runs
+// and that the thread counts of the process are restored afterwards.
+// A second simulation has to follow changes of the process thread count.
+
+static const Real timeStep = 1e-3;
+static const Real finalTime = 0.01;
+
+static std::shared_ptr<Simulation> makeSimulation(String simName) {
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, n1 });
+	auto r = Resistor::make("r");
+	r->setParameters(1);
+	r->connect({ n1, n2 });
+	auto l = Inductor::make("l");
+	l->setParameters(1e-3);
+	l->connect({ n2, SimNode::GND });
+
+	return std::make_shared<Simulation>(simName,
+		SystemTopology(50, SystemNodeList{ n1, n2 }, SystemComponentList{ vs, r, l }),
+		timeStep, finalTime, CPS::Domain::DP, Solver::Type::MNA, CPS::Logger::Level::off);
+}
+
+static Bool check(Bool condition, String message) {
+	if (!condition)
+		std::cerr << message << std::endl;
+	return condition;
+}
+
+int main(int argc, char* argv[]) {
+	Utils::setMaxThreads(3);
+	Eigen::setNbThreads(3);
+	// Without OpenMP both counts stay at 1
+	UInt processThreads = Utils::maxThreads();
+	Int eigenThreads = Eigen::nbThreads();
+
+	auto budgeted = makeSimulation("DP_ThreadBudget_Budget");
+	budgeted->setThreadBudget(1);
+	budgeted->initialize();
+	if (!check(Utils::maxThreads() == 1, "thread budget is not applied during the simulation")
+		|| !check(Eigen::nbThreads() == 1, "Eigen threads exceed the thread budget"))
+		return 1;
+	budgeted->run();
+	if (!check(Utils::maxThreads() == processThreads, "OpenMP thread count is not restored after run")
+		|| !check(Eigen::nbThreads() == eigenThreads, "Eigen thread count is not restored after run"))
+		return 1;
+
+	// Without a budget the current thread count of the process is used
+	Utils::setMaxThreads(2);
+	auto unbudgeted = makeSimulation("DP_ThreadBudget_Process");
+	if (!check(unbudgeted->threadBudget() == Utils::maxThreads(), "budget does not follow the process thread count"))
+		return 1;
+	unbudgeted->initialize();
+	for (Int step = 0; step < 3; step++)
+		unbudgeted->step();
+	unbudgeted.reset();
+	if (!check(Utils::maxThreads() == std::min<UInt>(processThreads, 2), "OpenMP thread count is not restored after destruction")
+		|| !check(Eigen::nbThreads() == eigenThreads, "Eigen thread count is not restored after destruction"))
+		return 1;
+
+	std::cout << "Thread counts restored" << std::endl;
+	return 0;
+}
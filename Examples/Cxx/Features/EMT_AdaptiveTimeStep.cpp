@@ -0,0 +1,97 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::EMT;
+using namespace CPS::EMT::Ph3;
+
+// Charges a three-phase RLC circuit from a DC source with a fixed and an
+// adaptive time step and checks that the adaptive simulation follows the
+// transient and reaches the same state with fewer steps.
+
+static const Real timeStep = 1e-5;
+
+static Real runRLC(String simName, Real finalTime, Bool adaptive, Int& steps) {
+	Logger::setLogDir("logs/"+simName);
+
+	auto n1 = SimNode::make("n1", PhaseType::ABC);
+	auto n2 = SimNode::make("n2", PhaseType::ABC);
+	auto n3 = SimNode::make("n3", PhaseType::ABC);
+
+	auto vs = VoltageSource::make("vs");
+	vs->setParameters(Complex(10, 0));
+	vs->connect({ SimNode::GND, n1 });
+	auto r1 = Resistor::make("r_1");
+	r1->setParameters(Matrix::Identity(3, 3) * 1);
+	r1->connect({ n1, n2 });
+	auto l1 = Inductor::make("l_1");
+	l1->setParameters(Matrix::Identity(3, 3) * 1e-3);
+	l1->connect({ n2, n3 });
+	auto c1 = Capacitor::make("c_1");
+	c1->setParameters(Matrix::Identity(3, 3) * 1e-3);
+	c1->connect({ n3, SimNode::GND });
+	auto r2 = Resistor::make("r_2");
+	r2->setParameters(Matrix::Identity(3, 3) * 10);
+	r2->connect({ n3, SimNode::GND });
+
+	auto sys = SystemTopology(50, SystemNodeList{ n1, n2, n3 },
+		SystemComponentList{ vs, r1, l1, c1, r2 });
+
+	auto logger = DataLogger::make(simName);
+	logger->addAttribute("v3", n3->attribute("v"));
+	logger->addAttribute("i_l1", l1->attribute("i_intf"));
+
+	Simulation sim(simName, sys, timeStep, finalTime, Domain::EMT);
+	sim.addLogger(logger);
+	sim.doAdaptiveTimeStep(adaptive);
+	sim.setAdaptiveTimeSteps({ timeStep, 10 * timeStep, 100 * timeStep });
+	sim.run();
+
+	steps = sim.timeStepCount();
+	return n3->singleVoltage(PhaseType::A);
+}
+
+static Bool compare(String name, Real finalTime, Real tolerance, Bool fewerSteps) {
+	Int fixedSteps, adaptiveSteps;
+	Real fixed = runRLC(name + "_Fixed", finalTime, false, fixedSteps);
+	Real adaptive = runRLC(name + "_Adaptive", finalTime, true, adaptiveSteps);
+
+	std::cout << name << " fixed: " << fixedSteps << " steps, v3 = " << fixed << std::endl;
+	std::cout << name << " adaptive: " << adaptiveSteps << " steps, v3 = " << adaptive << std::endl;
+
+	if (fewerSteps && adaptiveSteps >= fixedSteps) {
+		std::cerr << "Adaptive time step did not reduce the number of steps" << std::endl;
+		return false;
+	}
+	if (std::abs(adaptive - fixed) > tolerance * std::abs(fixed)) {
+		std::cerr << "Adaptive time step deviates from the fixed time step" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	// The oscillation is resolved with the smallest time step,
+	// larger time steps are only taken when it has decayed
+	if (!compare("EMT_AdaptiveTimeStep_Transient", 0.004, 0.01, false))
+		return 1;
+	if (!compare("EMT_AdaptiveTimeStep_SteadyState", 0.2, 1e-4, true))
+		return 1;
+
+	return 0;
+}
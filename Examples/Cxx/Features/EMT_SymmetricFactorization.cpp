@@ -0,0 +1,146 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/MNASolver.h>
+#include <dpsim/MNAFactorization.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+// Checks the symmetric factorization on the MNA systems of EMT networks fed
+// by a voltage source (indefinite, LDLT) and by a current source (positive
+// definite, Cholesky). Both have to give the same node voltages as the LU in
+// every step. The real form of a DP system is not symmetric and falls back
+// to LU.
+
+static const Real timeStep = 1e-4;
+static const Real finalTime = 0.05;
+
+/// RLC ladder fed by a voltage or a current source
+static SystemTopology ladder(Bool voltageSource, std::vector<EMT::SimNode::Ptr>& ladder) {
+	SystemNodeList nodes;
+	SystemComponentList comps;
+	ladder.clear();
+	for (UInt i = 0; i < 5; i++) {
+		ladder.push_back(EMT::SimNode::make("n" + std::to_string(i)));
+		nodes.push_back(ladder.back());
+	}
+
+	if (voltageSource) {
+		auto vs = EMT::Ph1::VoltageSource::make("vs");
+		vs->setParameters(Complex(1000, 0), 50);
+		vs->connect({ EMT::SimNode::GND, ladder[0] });
+		comps.push_back(vs);
+	}
+	else {
+		auto cs = EMT::Ph1::CurrentSource::make("cs");
+		cs->setParameters(Complex(10, 0), 50);
+		cs->connect({ EMT::SimNode::GND, ladder[0] });
+		comps.push_back(cs);
+		auto rs = EMT::Ph1::Resistor::make("rs");
+		rs->setParameters(100);
+		rs->connect({ ladder[0], EMT::SimNode::GND });
+		comps.push_back(rs);
+	}
+	for (UInt i = 1; i < ladder.size(); i++) {
+		auto r = EMT::Ph1::Resistor::make("r" + std::to_string(i));
+		r->setParameters(0.5 * i);
+		r->connect({ ladder[i-1], ladder[i] });
+		auto l = EMT::Ph1::Inductor::make("l" + std::to_string(i));
+		l->setParameters(2e-3);
+		l->connect({ ladder[i], EMT::SimNode::GND });
+		auto c = EMT::Ph1::Capacitor::make("c" + std::to_string(i));
+		c->setParameters(1e-5 * i);
+		c->connect({ ladder[i], EMT::SimNode::GND });
+		comps.push_back(r);
+		comps.push_back(l);
+		comps.push_back(c);
+	}
+	return SystemTopology(50, nodes, comps);
+}
+
+/// Method that the factorization of the stamped system matrix ends up with
+template <typename VarType>
+static Solver::Factorization appliedMethod(SystemTopology sys, Domain domain) {
+	MnaSolver<VarType> solver("EMT_SymmetricFactorization_System", domain, Logger::Level::off);
+	solver.setTimeStep(timeStep);
+	solver.setSystem(sys);
+	solver.initialize();
+	MnaFactorization factorization;
+	factorization.compute(solver.systemMatrix(), Solver::Factorization::Symmetric);
+	return factorization.method();
+}
+
+/// Node voltages of every step
+static std::vector<Matrix> simulate(Bool voltageSource, Solver::Factorization method) {
+	std::vector<EMT::SimNode::Ptr> nodes;
+	auto sys = ladder(voltageSource, nodes);
+	Simulation sim("EMT_SymmetricFactorization", sys, timeStep, finalTime,
+		Domain::EMT, Solver::Type::MNA, Logger::Level::off);
+	sim.setFactorization(method);
+	sim.initialize();
+
+	std::vector<Matrix> voltages;
+	while (sim.time() < finalTime - timeStep / 2) {
+		sim.step();
+		Matrix v(nodes.size(), 1);
+		for (UInt i = 0; i < nodes.size(); i++)
+			v(i, 0) = nodes[i]->attributeMatrixReal("v")->get()(0, 0);
+		voltages.push_back(v);
+	}
+	return voltages;
+}
+
+int main(int argc, char* argv[]) {
+	for (Bool voltageSource : { true, false }) {
+		String source = voltageSource ? "voltage source" : "current source";
+		std::vector<EMT::SimNode::Ptr> nodes;
+		if (appliedMethod<Real>(ladder(voltageSource, nodes), Domain::EMT) != Solver::Factorization::Symmetric) {
+			std::cerr << "EMT system with " << source << " was not factorized as symmetric" << std::endl;
+			return 1;
+		}
+
+		auto lu = simulate(voltageSource, Solver::Factorization::LU);
+		auto symmetric = simulate(voltageSource, Solver::Factorization::Symmetric);
+		Real maxDeviation = 0, maxVoltage = 0;
+		for (UInt step = 0; step < lu.size(); step++) {
+			maxDeviation = std::max(maxDeviation, (lu[step] - symmetric[step]).cwiseAbs().maxCoeff());
+			maxVoltage = std::max(maxVoltage, lu[step].cwiseAbs().maxCoeff());
+		}
+		std::cout << "Largest deviation from LU with " << source << ": " << maxDeviation << " V" << std::endl;
+		if (maxVoltage == 0 || maxDeviation > 1e-10 * maxVoltage) {
+			std::cerr << "symmetric factorization differs from LU" << std::endl;
+			return 1;
+		}
+	}
+
+	// DP RL circuit, whose real form couples real and imaginary parts antisymmetrically
+	auto n1 = DP::SimNode::make("n1");
+	auto vs = DP::Ph1::VoltageSource::make("vs");
+	vs->setParameters(Complex(1000, 0));
+	vs->connect({ DP::SimNode::GND, n1 });
+	auto l = DP::Ph1::Inductor::make("l");
+	l->setParameters(1e-3);
+	l->connect({ n1, DP::SimNode::GND });
+	if (appliedMethod<Complex>(SystemTopology(50, SystemNodeList{ n1 }, SystemComponentList{ vs, l }), Domain::DP)
+		!= Solver::Factorization::LU) {
+		std::cerr << "DP system was not factorized with LU" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+// Checks the block stamps of three-phase components. Blocks are compared
+// with element-wise stamps for contiguous and non-contiguous phase indices,
+// real and complex values and the harmonic layout of frequency parallel
+// systems. A DP three-phase circuit with coupled phases is then compared
+// with its phasor solution.
+
+static Bool checkStamp(String name, const Matrix& block, const Matrix& elements) {
+	Real deviation = (block - elements).cwiseAbs().maxCoeff();
+	if (deviation > 0) {
+		std::cerr << name << ": block stamp deviates by " << deviation << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static Bool checkStamps() {
+	Matrix real3 = Matrix::Random(3, 3);
+	MatrixComp comp3 = MatrixComp::Random(3, 3);
+	MatrixComp comp2 = MatrixComp::Random(2, 2);
+	Bool ok = true;
+
+	for (auto rows : std::vector<std::vector<UInt>>{ { 1, 2, 3 }, { 4, 0, 2 } }) {
+		std::vector<UInt> cols = { 5, 6, 7 };
+		String layout = rows[1] == rows[0] + 1 ? "contiguous" : "non-contiguous";
+
+		Matrix block = Matrix::Zero(9, 9), elements = Matrix::Zero(9, 9);
+		Math::addToMatrixBlock(block, rows, cols, real3);
+		Math::addToMatrixBlock(block, cols, rows, -real3);
+		for (UInt r = 0; r < 3; r++) {
+			for (UInt c = 0; c < 3; c++) {
+				Math::addToMatrixElement(elements, rows[r], cols[c], real3(r, c));
+				Math::addToMatrixElement(elements, cols[r], rows[c], -real3(r, c));
+			}
+		}
+		ok &= checkStamp("real " + layout, block, elements);
+
+		block = Matrix::Zero(18, 18);
+		elements = Matrix::Zero(18, 18);
+		Math::addToMatrixBlock(block, rows, cols, comp3);
+		Math::addToMatrixBlock(block, cols, rows, -comp3);
+		for (UInt r = 0; r < 3; r++) {
+			for (UInt c = 0; c < 3; c++) {
+				Math::addToMatrixElement(elements, rows[r], cols[c], comp3(r, c));
+				Math::addToMatrixElement(elements, cols[r], rows[c], -comp3(r, c));
+			}
+		}
+		ok &= checkStamp("complex " + layout, block, elements);
+
+		// Second of three frequencies
+		block = Matrix::Zero(54, 54);
+		elements = Matrix::Zero(54, 54);
+		Math::addToMatrixBlock(block, rows, cols, comp3, 3, 1);
+		Math::addToMatrixBlock(block, cols, rows, -comp3, 3, 1);
+		for (UInt r = 0; r < 3; r++) {
+			for (UInt c = 0; c < 3; c++) {
+				Math::addToMatrixElement(elements, rows[r], cols[c], comp3(r, c), 3, 1);
+				Math::addToMatrixElement(elements, cols[r], rows[c], -comp3(r, c), 3, 1);
+			}
+		}
+		ok &= checkStamp("harmonic " + layout, block, elements);
+	}
+
+	// Blocks of other sizes use the dynamic kernel
+	Matrix block = Matrix::Zero(16, 16), elements = Matrix::Zero(16, 16);
+	Math::addToMatrixBlock(block, { 0, 1 }, { 2, 3 }, comp2, 2, 1);
+	for (UInt r = 0; r < 2; r++)
+		for (UInt c = 0; c < 2; c++)
+			Math::addToMatrixElement(elements, r, 2 + c, comp2(r, c), 2, 1);
+	ok &= checkStamp("complex 2x2", block, elements);
+
+	return ok;
+}
+
+static Bool checkCircuit() {
+	Real frequency = 50, omega = 2 * PI * frequency;
+	Matrix resistance(3, 3), inductance(3, 3), capacitance(3, 3);
+	resistance <<
+		1.0, 0.2, 0.1,
+		0.2, 1.2, 0.2,
+		0.1, 0.2, 1.1;
+	inductance <<
+		0.020, 0.005, 0.004,
+		0.005, 0.022, 0.005,
+		0.004, 0.005, 0.021;
+	capacitance <<
+		2e-4, 0, 0,
+		0, 3e-4, 0,
+		0, 0, 4e-4;
+	Complex voltage(1000, 0);
+
+	auto n0 = DP::SimNode::make("n0", PhaseType::ABC);
+	auto n1 = DP::SimNode::make("n1", PhaseType::ABC);
+	auto n2 = DP::SimNode::make("n2", PhaseType::ABC);
+
+	auto vs = DP::Ph3::VoltageSource::make("vs");
+	vs->setParameters(voltage);
+	vs->connect({ DP::SimNode::GND, n0 });
+	auto r = DP::Ph3::Resistor::make("r");
+	r->setParameters(resistance);
+	r->connect({ n0, n1 });
+	auto l = DP::Ph3::Inductor::make("l");
+	l->setParameters(inductance);
+	l->connect({ n1, n2 });
+	auto c = DP::Ph3::Capacitor::make("c");
+	c->setParameters(capacitance);
+	c->connect({ n2, DP::SimNode::GND });
+
+	auto sys = SystemTopology(frequency, SystemNodeList{ n0, n1, n2 }, SystemComponentList{ vs, r, l, c });
+	Simulation sim("Ph3_BlockStamps", sys, 1e-4, 1.0, Domain::DP, Solver::Type::MNA, Logger::Level::off);
+	sim.run();
+
+	// Steady state phasors of the coupled series circuit
+	MatrixComp source(3, 1);
+	for (UInt phase = 0; phase < 3; phase++)
+		source(phase, 0) = std::polar(std::abs(voltage), std::arg(voltage) - phase * 2. / 3. * PI);
+	MatrixComp impedance = resistance.cast<Complex>() + Complex(0, omega) * inductance.cast<Complex>()
+		+ (Complex(0, omega) * capacitance.cast<Complex>()).inverse();
+	MatrixComp current = impedance.partialPivLu().solve(source);
+	MatrixComp expected = source - resistance.cast<Complex>() * current;
+
+	MatrixComp simulated = n1->attributeMatrixComp("v")->get();
+	Real deviation = (simulated - expected).cwiseAbs().maxCoeff();
+	std::cout << "Voltage at n1: " << simulated.transpose() << ", expected "
+		<< expected.transpose() << std::endl;
+	if (deviation > 1e-3 * expected.cwiseAbs().maxCoeff()) {
+		std::cerr << "three-phase circuit deviates from the phasor solution by " << deviation << " V" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	Bool ok = checkStamps();
+	ok &= checkCircuit();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/PFSolverPowerPolar.h>
+
+using namespace DPsim;
+using namespace CPS;
+using namespace CPS::SP;
+using namespace CPS::SP::Ph1;
+
+// Screens all line outages of a ring with a radial spur. The base case is
+// solved with Newton-Raphson and with the fast-decoupled method, which
+// have to agree. Each outage that leaves the grid connected has to agree
+// with a Newton-Raphson solution of the grid built without that line,
+// and the outage of the spur has to be reported as islanded.
+
+static const UInt numRing = 6;
+static const Real baseVoltage = 20e3;
+
+// Ring n0 - n1 - ... - n5 - n0 and spur n3 - n6, the line named skip is left out
+static SystemTopology makeGrid(const String& skip) {
+	std::vector<SP::SimNode::Ptr> nodes;
+	for (UInt n = 0; n <= numRing; n++)
+		nodes.push_back(SP::SimNode::make("n" + std::to_string(n)));
+	SystemTopology sys(50, SystemNodeList(nodes.begin(), nodes.end()), SystemComponentList{});
+
+	auto grid = externalGridInjection::make("grid");
+	grid->setParameters(1.0);
+	grid->modifyPowerFlowBusType(PowerflowBusType::VD);
+	sys.connectComponentToNodes<Complex>(grid, { nodes[0] });
+	sys.addComponent(grid);
+
+	auto addLine = [&](String name, UInt from, UInt to, Real length) {
+		if (name == skip)
+			return;
+		auto line = PiLine::make(name);
+		line->setParameters(0.3 * length, 1.2e-3 * length, 1e-8 * length);
+		line->setBaseVoltage(baseVoltage);
+		sys.connectComponentToNodes<Complex>(line, { nodes[from], nodes[to] });
+		sys.addComponent(line);
+	};
+	for (UInt n = 0; n < numRing; n++)
+		addLine("line" + std::to_string(n), n, (n + 1) % numRing, 1 + n % 3);
+	addLine("spur", 3, numRing, 2);
+
+	for (UInt n = 1; n <= numRing; n++) {
+		// The powerflow initializes the load from its terminal power
+		auto load = Load::make("load" + std::to_string(n));
+		sys.connectComponentToNodes<Complex>(load, { nodes[n] });
+		load->terminal(0)->setPower(Complex((1 + 0.5 * n) * 1e6, 0.4e6));
+		sys.addComponent(load);
+	}
+	return sys;
+}
+
+// Per unit voltage magnitudes and angles of a Newton-Raphson solution
+static Bool solveReference(const String& skip, Vector& magnitude, Vector& angle) {
+	String name = "SP_Contingencies_" + (skip.empty() ? String("base") : skip);
+	Logger::setLogDir("logs/" + name);
+	SystemTopology sys = makeGrid(skip);
+	PFSolverPowerPolar solver(name, sys, 1, Logger::Level::off);
+	if (!solver.solveTimeStep(0))
+		return false;
+
+	magnitude.resize(sys.mNodes.size());
+	angle.resize(sys.mNodes.size());
+	for (auto node : sys.mNodes) {
+		Complex v = std::dynamic_pointer_cast<SP::SimNode>(node)->singleVoltage() / baseVoltage;
+		magnitude(node->matrixNodeIndex()) = std::abs(v);
+		angle(node->matrixNodeIndex()) = std::arg(v);
+	}
+	return true;
+}
+
+static Bool compare(const String& what, const Vector& magnitude, const Vector& angle,
+	const Vector& refMagnitude, const Vector& refAngle) {
+	Real diff = std::max((magnitude - refMagnitude).cwiseAbs().maxCoeff(),
+		(angle - refAngle).cwiseAbs().maxCoeff());
+	if (diff > 1e-6) {
+		std::cerr << what << " differs from Newton-Raphson by " << diff << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	Vector refMagnitude, refAngle;
+	if (!solveReference("", refMagnitude, refAngle)) {
+		std::cerr << "Base case did not converge" << std::endl;
+		return 1;
+	}
+
+	String simName = "SP_Contingencies";
+	Logger::setLogDir("logs/" + simName);
+	SystemTopology sys = makeGrid("");
+	PFSolverPowerPolar solver(simName, sys, 1, Logger::Level::off);
+	solver.setMethod(PFSolverPowerPolar::Method::FastDecoupled);
+	auto results = solver.screenContingencies(0);
+
+	// The fast-decoupled base case is stored in the nodes
+	Vector magnitude(sys.mNodes.size()), angle(sys.mNodes.size());
+	for (auto node : sys.mNodes) {
+		Complex v = std::dynamic_pointer_cast<SP::SimNode>(node)->singleVoltage() / baseVoltage;
+		magnitude(node->matrixNodeIndex()) = std::abs(v);
+		angle(node->matrixNodeIndex()) = std::arg(v);
+	}
+	if (!compare("Fast-decoupled base case", magnitude, angle, refMagnitude, refAngle))
+		return 1;
+
+	if (results.size() != numRing + 1) {
+		std::cerr << results.size() << " contingencies instead of " << numRing + 1 << std::endl;
+		return 1;
+	}
+	for (auto& result : results) {
+		if (result.branch == "spur") {
+			if (!result.islanded) {
+				std::cerr << "Outage of the spur is not reported as islanded" << std::endl;
+				return 1;
+			}
+			continue;
+		}
+		if (result.islanded || !result.converged) {
+			std::cerr << "Outage of " << result.branch << " is "
+				<< (result.islanded ? "islanded" : "not converged") << std::endl;
+			return 1;
+		}
+		if (!solveReference(result.branch, refMagnitude, refAngle)
+			|| !compare("Outage of " + result.branch, result.voltageMagnitude, result.voltageAngle,
+				refMagnitude, refAngle))
+			return 1;
+	}
+
+	return 0;
+}
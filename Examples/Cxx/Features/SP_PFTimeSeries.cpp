@@ -0,0 +1,126 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/PFTimeSeries.h>
+
+using namespace DPsim;
+using namespace CPS;
+using namespace CPS::SP;
+using namespace CPS::SP::Ph1;
+
+// Solves a day of load profiles of a radial feeder, once with a cold
+// start of every time step on a single segment and once warm started on
+// several segments in parallel. The voltages have to agree and the warm
+// start has to save Newton iterations. The voltages have to follow the
+// profiles.
+
+static const UInt numLoads = 4;
+static const Real timeStep = 300;
+static const UInt numSteps = 288;
+
+static SystemTopology makeFeeder() {
+	std::vector<SP::SimNode::Ptr> nodes;
+	for (UInt n = 0; n <= numLoads; n++)
+		nodes.push_back(SP::SimNode::make("n" + std::to_string(n)));
+	SystemTopology sys(50, SystemNodeList(nodes.begin(), nodes.end()), SystemComponentList{});
+
+	auto grid = externalGridInjection::make("grid");
+	grid->setParameters(1.0);
+	sys.connectComponentToNodes<Complex>(grid, { nodes[0] });
+	sys.addComponent(grid);
+
+	// Daily profile with a peak at noon, shifted for each load
+	for (UInt k = 0; k < numLoads; k++) {
+		auto line = PiLine::make("line" + std::to_string(k + 1));
+		line->setParameters(0.8, 2e-3, 1e-7);
+		line->setBaseVoltage(20e3);
+		sys.connectComponentToNodes<Complex>(line, { nodes[k], nodes[k + 1] });
+		sys.addComponent(line);
+
+		auto profile = std::make_shared<PowerProfileTable>(std::vector<String>{"load"}, 0, 900, 97);
+		for (UInt sample = 0; sample < 97; sample++) {
+			Real day = 2 * PI * (sample * 900. / 86400. - 0.5 + 0.1 * k);
+			Real p = (1 + 0.2 * k) * 1e6 * (1 + 0.6 * std::cos(day));
+			profile->setSample(0, sample, PQData{p, 0.3 * p});
+		}
+		auto load = Load::make("load" + std::to_string(k + 1));
+		load->setParameters(1e6, 0.3e6, 20e3);
+		load->setLoadProfile(profile, 0);
+		sys.connectComponentToNodes<Complex>(load, { nodes[k + 1] });
+		sys.addComponent(load);
+	}
+	return sys;
+}
+
+static std::shared_ptr<PFTimeSeries> solve(String name, UInt numSegments, Bool warmStart) {
+	Logger::setLogDir("logs/" + name);
+	auto series = std::make_shared<PFTimeSeries>(makeFeeder, name, 0, timeStep, numSteps);
+	series->setSolverConfiguration([](PFSolver& solver) { solver.setVDNode("n0"); });
+	series->setNumSegments(numSegments);
+	series->doWarmStart(warmStart);
+	series->run();
+	return series;
+}
+
+static UInt totalIterations(const PFTimeSeries& series) {
+	UInt total = 0;
+	for (UInt it : series.iterations())
+		total += it;
+	return total;
+}
+
+int main(int argc, char* argv[]) {
+	auto cold = solve("SP_PFTimeSeries_Cold", 1, false);
+	auto warm = solve("SP_PFTimeSeries_Warm", 4, true);
+
+	if (cold->numNotConverged() > 0 || warm->numNotConverged() > 0) {
+		std::cerr << cold->numNotConverged() << " cold and " << warm->numNotConverged()
+			<< " warm started steps did not converge" << std::endl;
+		return 1;
+	}
+
+	Real maxDiff = (cold->voltages() - warm->voltages()).cwiseAbs().maxCoeff();
+	if (maxDiff > 1e-6 * 20e3) {
+		std::cerr << "Warm started voltages differ by " << maxDiff << " V" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Newton iterations: " << totalIterations(*cold) << " cold, "
+		<< totalIterations(*warm) << " warm started" << std::endl;
+	if (totalIterations(*warm) >= totalIterations(*cold)) {
+		std::cerr << "Warm start does not save iterations" << std::endl;
+		return 1;
+	}
+
+	// The end of the feeder has the lowest voltage at the peak load of the
+	// last load, which is at 12:00 shifted by 0.1 days for each load
+	UInt last = numLoads;
+	const MatrixComp& v = cold->voltages();
+	UInt minStep = 0;
+	for (UInt step = 1; step < numSteps; step++) {
+		if (std::abs(v(step, last)) < std::abs(v(minStep, last)))
+			minStep = step;
+	}
+	Real peakTime = std::fmod(0.5 - 0.1 * (numLoads - 1) + 1, 1.) * 86400;
+	if (std::abs(minStep * timeStep - peakTime) > 3 * 3600) {
+		std::cerr << "Lowest voltage at " << minStep * timeStep << " s instead of around "
+			<< peakTime << " s" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,163 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ * DPsim
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *********************************************************************************/
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <DPsim.h>
+#include <cps/CSVReader.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+// Writes load profiles that are linear in time with rows at an irregular
+// interval, resamples them into a profile table and reads the table back
+// with a window that is much shorter than the profiles. The values are
+// requested forwards, backwards, between the samples and outside of the
+// table and compared to the analytic profiles, also by threads that share
+// the table. Loads that are assigned to the table get the same values,
+// also for weighting factors.
+
+static const UInt numProfiles = 5;
+static const Real tableStart = 10;
+static const Real tableStep = 5;
+static const Real tableEnd = 300;
+
+// Power of profile k in kW, the reactive power is twice the active power
+static Real profilePower(UInt k, Real time) {
+	return k + 1 + time / 100;
+}
+
+static void writeProfiles(const String& dir) {
+	std::experimental::filesystem::create_directories(dir);
+	for (UInt k = 0; k < numProfiles; k++) {
+		std::ofstream file(dir + "/Load_" + std::to_string(k) + ".csv");
+		file.precision(17);
+		file << "time,p,q\n";
+		for (Real time = 0; time < 400; time += 7)
+			file << time << "," << profilePower(k, time) << "," << 2 * profilePower(k, time) << "\n";
+	}
+}
+
+static Bool check(const String& what, Real value, Real expected) {
+	if (std::abs(value - expected) <= 1e-9 * std::abs(expected))
+		return true;
+	std::cerr << what << ": " << value << " instead of " << expected << std::endl;
+	return false;
+}
+
+// Compares the table with the profiles at the given times
+static Bool checkTable(PowerProfileTable& table, const std::vector<Real>& times) {
+	for (Real time : times) {
+		Real clamped = std::min(std::max(time, tableStart), tableEnd);
+		for (UInt k = 0; k < numProfiles; k++) {
+			UInt profile = table.profileIndex("Load_" + std::to_string(k));
+			PQData data = table.value(profile, time);
+			String what = "Load_" + std::to_string(k) + " at " + std::to_string(time);
+			if (!check(what + " P", data.p, 1000 * profilePower(k, clamped))
+				|| !check(what + " Q", data.q, 2000 * profilePower(k, clamped)))
+				return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	String simName = "SP_PowerProfileTable";
+	Logger::setLogDir("logs/"+simName);
+	String dir = "logs/" + simName;
+	writeProfiles(dir + "/profiles");
+
+	CSVReader reader(simName, dir + "/profiles", Logger::Level::off);
+	reader.writeLoadProfileTable(dir + "/profiles.bin", tableStart, tableStep, tableEnd);
+
+	std::vector<Real> forward, backward;
+	for (Real time = 0; time <= 320; time += 1.3)
+		forward.push_back(time);
+	backward.assign(forward.rbegin(), forward.rend());
+
+	PowerProfileTable table(dir + "/profiles.bin", 8);
+	if (table.numProfiles() != numProfiles || table.numSamples() != 59) {
+		std::cerr << "Profile table has " << table.numProfiles() << " profiles and "
+			<< table.numSamples() << " samples" << std::endl;
+		return 1;
+	}
+	if (!checkTable(table, forward) || !checkTable(table, backward))
+		return 1;
+
+	// Threads at distant times move the shared window concurrently
+	std::atomic<Bool> concurrent(true);
+	std::vector<std::thread> readers;
+	for (UInt reader = 0; reader < 4; reader++) {
+		readers.emplace_back([&, reader]() {
+			for (UInt repeat = 0; repeat < 20; repeat++) {
+				if (!checkTable(table, reader % 2 ? backward : forward))
+					concurrent = false;
+			}
+		});
+	}
+	for (auto& reader : readers)
+		reader.join();
+	if (!concurrent)
+		return 1;
+
+	// Hold returns the last sample at or before the requested time,
+	// times close to a sample are skipped as they depend on rounding
+	PowerProfileTable hold(dir + "/profiles.bin", 8, PowerProfileTable::Interpolation::Hold);
+	UInt first = hold.profileIndex("Load_0");
+	for (Real time : backward) {
+		if (std::abs(std::remainder(time - tableStart, tableStep)) < 1e-6)
+			continue;
+		Real sampleTime = tableStart + std::floor((time - tableStart) / tableStep) * tableStep;
+		sampleTime = std::min(std::max(sampleTime, tableStart), tableEnd);
+		if (!check("Hold at " + std::to_string(time), hold.value(first, time).p, 1000 * profilePower(0, sampleTime)))
+			return 1;
+	}
+
+	// Loads are matched by name, one of them uses weighting factors
+	auto tablePtr = std::make_shared<PowerProfileTable>(dir + "/profiles.bin", 8);
+	SystemComponentList loads;
+	for (UInt k = 0; k < numProfiles; k++)
+		loads.push_back(SP::Ph1::Load::make("Load_" + std::to_string(k)));
+	SystemTopology sys(50, SystemNodeList{}, loads);
+	reader.assignLoadProfileTable(sys, tablePtr);
+
+	auto factors = std::make_shared<PowerProfileTable>(std::vector<String>{"factor"},
+		tableStart, tableStep, 3, true);
+	for (UInt sample = 0; sample < 3; sample++)
+		factors->setSample(0, sample, PQData{0.5 * (sample + 1), 0.5 * (sample + 1)});
+	factors->save(dir + "/factors.bin");
+	auto scaled = SP::Ph1::Load::make("Scaled");
+	scaled->setParameters(1000, 400, 20e3);
+	scaled->setLoadProfile(std::make_shared<PowerProfileTable>(dir + "/factors.bin"), 0);
+
+	for (Real time : forward) {
+		for (UInt k = 0; k < numProfiles; k++) {
+			auto load = std::dynamic_pointer_cast<SP::Ph1::Load>(loads[k]);
+			load->updatePQ(time);
+			Real clamped = std::min(std::max(time, tableStart), tableEnd);
+			if (!check(load->name() + " P", load->attribute<Real>("P")->get(), 1000 * profilePower(k, clamped)))
+				return 1;
+		}
+		scaled->updatePQ(time);
+		Real factor = 0.5 * (1 + (std::min(std::max(time, tableStart), tableStart + 2 * tableStep) - tableStart) / tableStep);
+		if (!check("Scaled P", scaled->attribute<Real>("P")->get(), 1000 * factor)
+			|| !check("Scaled Q", scaled->attribute<Real>("Q")->get(), 400 * factor))
+			return 1;
+	}
+
+	return 0;
+}
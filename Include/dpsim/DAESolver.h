@@ -20,15 +20,26 @@
 
 #include <ida/ida.h>
 #include <ida/ida_direct.h>
+#include <ida/ida_spils.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
 #include <sundials/sundials_types.h>
 #include <nvector/nvector_serial.h>
 
+#ifdef WITH_KLU
+  #include <sunmatrix/sunmatrix_sparse.h>
+  #include <sunlinsol/sunlinsol_klu.h>
+#endif
+
 
 namespace DPsim {
 
 	/// Solver class which uses Differential Algebraic Equation(DAE) systems
 	class DAESolver : public Solver {
+	public:
+		/// Linear solver used in the Newton iterations of IDA
+		typedef Solver::DAELinearSolver LinearSolverType;
+
 	protected:
 		// General simulation parameters
         CPS::SystemTopology mSystem;
@@ -64,18 +75,45 @@ namespace DPsim {
         long int resEval=0;
         std::vector<CPS::DAEInterface::ResFn> mResidualFunctions;
 
+		// #### Sparse Jacobian ####
+		/// Selected linear solver
+		LinearSolverType mLinearSolverType;
+		/// Jacobian dF/dy + cj dF/dy' with the structural nonzeros of the residual
+		CPS::SparseMatrix mJacobian;
+		/// Column groups without common rows, perturbed together
+		std::vector<std::vector<Int>> mColumnGroups;
+		/// LU factorization of the Jacobian for the Krylov preconditioner
+		Eigen::SparseLU<CPS::SparseMatrix> mJacobianLU;
+		/// Work vectors for the finite differences
+		std::vector<double> mPerturbedState, mPerturbedDerivative, mPerturbedResidual;
+
 		/// Residual Function of entire System
 		static int residualFunctionWrapper(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid, void *user_data);
 		int residualFunction(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid);
+		/// Evaluate the residuals of all nodes and components
+		void evaluateResidual(Real time, const double state[], const double dstate_dt[], double resid[]);
+		/// Determine the sparsity pattern of the Jacobian by perturbing each
+		/// state and group the columns for the finite differences
+		void analyzeJacobianPattern(Real time, const double state[], const double dstate_dt[]);
+		/// Assemble the Jacobian by finite differences over the column groups
+		void assembleJacobian(Real time, Real cj, const double state[], const double dstate_dt[], const double resid[]);
+
+		static int jacobianWrapper(realtype ttime, realtype cj, N_Vector state, N_Vector dstate_dt, N_Vector resid,
+			SUNMatrix jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+		static int preconditionerSetupWrapper(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid,
+			realtype cj, void *user_data);
+		static int preconditionerSolveWrapper(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid,
+			N_Vector rvec, N_Vector zvec, realtype cj, realtype delta, void *user_data);
 
 	public:
 		/// Create solve object with given parameters
-        DAESolver(String name, CPS::SystemTopology system, Real dt, Real t0);
+        DAESolver(String name, CPS::SystemTopology system, Real dt, Real t0,
+			LinearSolverType linearSolver = LinearSolverType::Dense);
 		/// Deallocate all memory
 		~DAESolver();
 		/// Initialize Components & Nodes with inital values
 		void initialize(Real t0);
-		/// Solve system for the current time
+		/// Solve system for the current time and store the nodal voltages in the nodes
 		Real step(Real time);
 
 		CPS::Task::List getTasks();
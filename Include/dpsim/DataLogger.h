@@ -34,6 +34,22 @@ namespace DPsim {
 
 		std::map<String, CPS::AttributeBase::Ptr> mAttributes;
 
+		/// Values of one step copied by snapshot()
+		struct SnapshotBuffer {
+			Bool logged = false;
+			Real time = 0;
+			std::vector<Real> values;
+			/// Values of attributes that are neither integer nor real
+			std::vector<String> texts;
+		};
+		SnapshotBuffer mSnapshots[2];
+		/// Attributes in column order and their typed versions, resolved
+		/// by resolveColumns() before the simulation
+		std::vector<CPS::AttributeBase::Ptr> mColumns;
+		std::vector<CPS::Attribute<Real>::Ptr> mRealColumns;
+		std::vector<CPS::Attribute<Int>::Ptr> mIntColumns;
+
+		void logHeader();
 		void logDataLine(Real time, Real data);
 		void logDataLine(Real time, const Matrix& data);
 		void logDataLine(Real time, const MatrixComp& data);
@@ -70,6 +86,16 @@ namespace DPsim {
 		}
 
 		void log(Real time, Int timeStepCount);
+		/// Resolves the columns copied by snapshot(). Has to be called
+		/// before the simulation, attributes added afterwards are not
+		/// included in the snapshots.
+		void resolveColumns();
+		/// Copies the values logged in this step into one of two buffers,
+		/// so that the formatting and writing by writeSnapshot() can
+		/// overlap with the next step
+		void snapshot(UInt buffer, Real time, Int timeStepCount);
+		/// Writes a buffer filled by snapshot() to the log file
+		void writeSnapshot(UInt buffer);
 
 		CPS::Task::Ptr getTask();
 
@@ -81,6 +107,7 @@ namespace DPsim {
 					mAttributeDependencies.push_back(attr.second);
 				}
 				mModifiedAttributes.push_back(Scheduler::external);
+				mDeferrable = true;
 			}
 
 			void execute(Real time, Int timeStepCount);
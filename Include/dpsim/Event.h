@@ -10,6 +10,8 @@
 
 #include <deque>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include <dpsim/Config.h>
 #include <cps/Definitions.h>
@@ -124,8 +126,102 @@ namespace DPsim {
 	public:
 		///
 		void addEvent(Event::Ptr e);
+		/// Executes all events before the current time and returns their number
+		CPS::UInt handleEvents(CPS::Real currentTime);
+		/// Time of the next pending event or infinity if there is none
+		CPS::Real nextEventTime();
+	};
+
+	/// \brief Timing wheel for large numbers of setpoint changes.
+	///
+	/// Events are bucketed by the index of the time step in which they are
+	/// applied and refer to registered targets by index. Their handling
+	/// therefore neither allocates memory nor produces any output.
+	/// Like in the EventQueue, an event is applied before the first step
+	/// whose time is later than the event time.
+	class EventWheel : public SharedFactory<EventWheel> {
+	public:
+		using Ptr = std::shared_ptr<EventWheel>;
+
+		/// Time step of the simulation and number of steps covered by the wheel
+		EventWheel(CPS::Real timeStep, CPS::UInt numSlots = 1024);
+
+		/// Register a real attribute that is set by the events
+		CPS::UInt addTarget(const CPS::String& name, CPS::Attribute<CPS::Real>::Ptr attr);
+		/// Register a switch that is closed by events with nonzero value
+		CPS::UInt addTarget(const CPS::String& name, std::shared_ptr<CPS::Base::Ph1::Switch> sw);
+		/// Register a three-phase switch that is closed by events with nonzero value
+		CPS::UInt addTarget(const CPS::String& name, std::shared_ptr<CPS::Base::Ph3::Switch> sw);
+		/// Index of a registered target
+		CPS::UInt targetIndex(const CPS::String& name) const;
+
 		///
-		void handleEvents(CPS::Real currentTime);
+		void addEvent(CPS::Real time, CPS::UInt target, CPS::Real value);
+		/// Load events from CSV lines of the form "time,target,value"
+		/// where target is the name of a registered target.
+		void loadCSV(const CPS::String& filename);
+		/// Load events written by saveBinary
+		void loadBinary(const CPS::String& filename);
+		/// Write all pending events to a compact binary file
+		void saveBinary(const CPS::String& filename) const;
+
+		/// Applies all events before the current time and returns their number
+		CPS::UInt handleEvents(CPS::Real currentTime);
+		/// Number of events that have not been applied yet
+		std::size_t pendingEvents() const;
+
+	protected:
+		struct Target {
+			CPS::Attribute<CPS::Real>::Ptr attribute;
+			std::shared_ptr<CPS::Base::Ph1::Switch> switch1Ph;
+			std::shared_ptr<CPS::Base::Ph3::Switch> switch3Ph;
+		};
+		struct Entry {
+			CPS::UInt target;
+			CPS::Real value;
+		};
+		struct FarEntry {
+			long long step;
+			Entry entry;
+		};
+
+		CPS::Real mTimeStep;
+		/// Slots of the wheel, the slot of a step is the step index modulo the wheel size
+		std::vector<std::vector<Entry>> mSlots;
+		/// Index of the next step to be handled
+		long long mCurrentStep = 0;
+		/// Events beyond the wheel, sorted by step from mFarPos on
+		std::vector<FarEntry> mFarEvents;
+		std::size_t mFarPos = 0;
+		CPS::Bool mFarSorted = true;
+		/// Number of events in the wheel
+		std::size_t mWheelEvents = 0;
+
+		std::vector<Target> mTargets;
+		std::unordered_map<CPS::String, CPS::UInt> mTargetIndices;
+
+		CPS::UInt addTarget(const CPS::String& name, Target target);
+		/// Index of the step in which an event at the given time is applied
+		long long eventStep(CPS::Real time) const;
+		void sortFarEvents();
+		/// Moves events from the far list into the wheel once they are in range
+		void refillWheel();
+		void apply(const Entry& entry) {
+			const Target& target = mTargets[entry.target];
+			if (target.attribute)
+				target.attribute->set(entry.value);
+			else if (target.switch1Ph) {
+				if (entry.value != 0)
+					target.switch1Ph->close();
+				else
+					target.switch1Ph->open();
+			}
+			else {
+				if (entry.value != 0)
+					target.switch3Ph->closeSwitch();
+				else
+					target.switch3Ph->openSwitch();
+			}
+		}
 	};
 }
-
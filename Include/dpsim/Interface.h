@@ -60,6 +60,8 @@ namespace DPsim {
 
 		ShmemInterface mShmem;
 		Sample *mLastSample;
+		/// Samples filled by snapshotValues, one per buffer
+		Sample *mSnapshotSamples[2] = { nullptr, nullptr };
 
 		bool mOpened;
 		int mSequence;
@@ -158,6 +160,13 @@ namespace DPsim {
 		 */
 		void writeValues();
 
+		/// Fills a sample with the exported values of this step. The sample
+		/// is sent by writeSnapshot, which may run concurrently with the
+		/// next step.
+		void snapshotValues(UInt buffer, Real time, Int timeStepCount);
+		/// Sends the sample filled by snapshotValues for the given buffer
+		void writeSnapshot(UInt buffer);
+
 		CPS::Task::List getTasks();
 	};
 }
@@ -0,0 +1,108 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <dpsim/Solver.h>
+#include <cps/Logger.h>
+
+namespace DPsim {
+	/// \brief Factorization of an MNA system matrix.
+	///
+	/// Methods that do not apply to a matrix fall back to the LU
+	/// factorization of the real system. The mixed precision method
+	/// also switches to LU when the refinement stops converging.
+	class MnaFactorization {
+	protected:
+		/// Method of the current factorization
+		Solver::Factorization mMethod = Solver::Factorization::LU;
+		///
+		CPS::LUFactorized mLU;
+		/// LU of the phasor system that is represented by the real system
+		Eigen::PartialPivLU<MatrixComp> mComplexLU;
+		/// Right side vector of the phasor system
+		MatrixComp mComplexRightSide;
+		/// Solution of the phasor system
+		MatrixComp mComplexSolution;
+
+		/// LU of the system in single precision
+		Eigen::PartialPivLU<Eigen::MatrixXf> mSingleLU;
+		/// Double precision system used for the refinement residuals,
+		/// owned by the solver
+		const Matrix* mSystem = nullptr;
+		/// Infinity norm of the system matrix
+		Real mSystemNorm = 0;
+		/// Residual of the current solution
+		Matrix mResidual;
+		/// Scaled residual and correction in single precision
+		Eigen::VectorXf mSingleRightSide;
+		Eigen::VectorXf mSingleCorrection;
+		/// Cholesky factors of symmetric positive definite systems
+		Eigen::LLT<Matrix> mLLT;
+		/// LDLT factors of other symmetric systems
+		Eigen::LDLT<Matrix> mLDLT;
+		/// True if the symmetric system is positive definite
+		Bool mPositiveDefinite = false;
+		/// Inverse of the system matrix
+		Matrix mInverse;
+
+		/// Maximum number of refinement steps per solve
+		static const UInt mMaxRefinementSteps = 10;
+		/// Normwise backward error at which the refinement stops
+		static constexpr Real mRefinementTolerance = 1e-14;
+		/// Normwise backward error accepted for the probe solve of
+		/// factorizations without guaranteed stability
+		static constexpr Real mProbeTolerance = 1e-10;
+
+		/// Release the factors of the previous factorization
+		void reset();
+		/// Returns true if sys equals its transpose up to rounding
+		static Bool isSymmetric(const Matrix& sys);
+		/// Returns true if the solution of a probe system is accurate
+		Bool probeSolve(const Matrix& sys);
+		/// Solve with the single precision LU and refine the solution.
+		/// Returns false if the refinement does not converge.
+		Bool solveMixedPrecision(const Matrix& rightSide, Matrix& solution);
+
+	public:
+		/// Largest system size for which the inverse is precomputed
+		static const UInt maxInverseSize = 2048;
+		/// Memory limit in bytes for the inverses of all switch states
+		static const std::size_t maxInverseMemory = std::size_t(512) << 20;
+
+		/// Returns the phasor system if sys has the structure
+		/// [Re -Im; Im Re] created by the complex matrix stamps
+		static Bool complexSystem(const Matrix& sys, MatrixComp& complexSys);
+		/// Returns true if the inverses of numStates systems of the
+		/// given size stay within the limits
+		static Bool inverseFits(UInt size, std::size_t numStates);
+
+		/// Returns the fastest method for sys by timing each applicable
+		/// method. The factorization of all switch states is weighed
+		/// against the solves of numSteps steps, or only solves are
+		/// compared if numSteps is 0. Each measurement is repeated and the
+		/// fastest run counts, so no other work should run concurrently.
+		/// The decision and its reasons are logged.
+		static Solver::Factorization select(const Matrix& sys, std::size_t numStates, UInt numSteps, CPS::Logger::Log log);
+		///
+		static String methodName(Solver::Factorization method);
+
+		/// Factorize the system matrix. For the mixed precision method,
+		/// sys is referenced and has to outlive the factorization.
+		void compute(const Matrix& sys, Solver::Factorization method);
+		/// Factorize the phasor system with the complex LU
+		void compute(const MatrixComp& sys);
+		/// Solve the system for the given right side vector
+		void solve(const Matrix& rightSide, Matrix& solution);
+
+		/// Method of the current factorization
+		Solver::Factorization method() const { return mMethod; }
+		/// Factors of the LU method
+		const Matrix& matrixLU() const { return mLU.matrixLU(); }
+	};
+}
@@ -16,6 +16,7 @@
 
 #include <dpsim/Solver.h>
 #include <dpsim/DataLogger.h>
+#include <dpsim/MNAFactorization.h>
 #include <cps/AttributeList.h>
 #include <cps/Solver/MNASwitchInterface.h>
 #include <cps/SimSignalComp.h>
@@ -79,12 +80,32 @@ namespace DPsim {
 		std::vector<Matrix> mLeftSideVectorHarm;
 		std::vector< CPS::Attribute<Matrix>::Ptr > mLeftVectorHarmAttributes;
 
-		/// Map of system matrices where the key is the bitset describing the switch states
+		/// Map of system matrices where the key is the bitset describing the switch states.
+		/// Matrices factorized with the complex LU are released.
 		std::unordered_map< std::bitset<SWITCH_NUM>, Matrix > mSwitchedMatrices;
 		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector<Matrix> > mSwitchedMatricesHarm;
-		/// Map of LU factorizations related to the system matrices
-		std::unordered_map< std::bitset<SWITCH_NUM>, CPS::LUFactorized > mLuFactorizations;
+		/// Map of factorizations related to the system matrices
+		std::unordered_map< std::bitset<SWITCH_NUM>, MnaFactorization > mFactorizations;
 		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector<CPS::LUFactorized> > mLuFactorizationsHarm;
+		/// Keep the real system matrices for solvers that factorize them on their own
+		Bool mKeepSystemMatrices = false;
+		/// Result of the automatic selection, reused for all switch states and time steps
+		Factorization mSelectedFactorization = Factorization::Auto;
+
+		// #### Attributes related to adaptive time step ####
+		/// System matrices of inactive time steps where the key is the time step level
+		std::unordered_map< UInt, std::unordered_map< std::bitset<SWITCH_NUM>, Matrix > > mTimeStepMatrices;
+		/// Factorizations of inactive time steps where the key is the time step level
+		std::unordered_map< UInt, std::unordered_map< std::bitset<SWITCH_NUM>, MnaFactorization > > mTimeStepFactorizations;
+		/// Solution vectors of the two previous steps
+		Matrix mPrevLeftSideVector;
+		Matrix mPrevPrevLeftSideVector;
+		/// Time step of the previous step
+		Real mPrevTimeStep = 0;
+		/// Number of previous solutions available for the error estimate
+		UInt mNumPrevSolutions = 0;
+		/// Local error estimate of the last step
+		Real mLocalError = 0;
 
 		// #### Attributes related to switching ####
 		/// Index of the next switching event
@@ -119,8 +140,22 @@ namespace DPsim {
 		void createEmptySystemMatrix();
 		///
 		void updateSwitchStatus();
+		/// Stamps and factorizes the system matrices of all switch states for the current time step
+		void stampSwitchedMatrices();
+		/// Resolves the automatic factorization for sys and falls back
+		/// to LU if the selected method exceeds its limits. The automatic
+		/// selection is only benchmarked for the first system.
+		Factorization factorizationMethod(const Matrix& sys, std::size_t numStates);
+		/// Factorizes sys with the given method. For the complex LU only the
+		/// phasor system is factorized and sys is released.
+		void factorizeSystemMatrix(Matrix& sys, MnaFactorization& factorization, Factorization method);
+		/// Estimates the local error from the deviation of the solution
+		/// to the extrapolation of the two previous solutions
+		void updateLocalErrorEstimate();
 		/// Logging of system matrices and source vector
 		void logSystemMatrices();
+		/// Collects the components and subcomponents that provide admittance stamps
+		void collectAdmittanceComponents(CPS::MNAInterface::Ptr comp, CPS::MNAInterface::List& comps);
 	public:
 		/// This constructor should not be called by users.
 		MnaSolver(String name,
@@ -136,6 +171,20 @@ namespace DPsim {
 		void initialize();
 		/// Log left and right vector values for each simulation step
 		void log(Real time);
+		/// Switch to another time step, reusing cached system matrices if available
+		void setTimeStepLevel(UInt level);
+		///
+		Real localErrorEstimate() { return mLocalError; }
+		/// Store solution, source vector and switch states in a snapshot
+		void saveState(CPS::Snapshot& snapshot);
+		/// Restore solution, source vector and switch states from a snapshot
+		void loadState(CPS::Snapshot& snapshot);
+		/// Impedance matrices between the given nodes for each frequency in Hz.
+		/// Entry (i,j) is the voltage at node i for a unit current injected
+		/// at node j. Sources are set to zero and the solver has to be initialized.
+		/// Throws a SolverException if a component has no admittance stamp.
+		std::vector<MatrixComp> impedanceSweep(const std::vector<Real>& frequencies,
+			const CPS::TopologicalNode::List& nodes);
 
 		// #### Getter ####
 		///
@@ -144,7 +193,8 @@ namespace DPsim {
 		Matrix& rightSideVector() { return mRightSideVector; }
 		///
 		CPS::Task::List getTasks();
-		///
+		/// System matrix of the current switch state, empty if it was
+		/// factorized with the complex LU
 		Matrix& systemMatrix() {
 			return mSwitchedMatrices[mCurrentSwitchStatus];
 		}
@@ -58,6 +58,9 @@ namespace DPsim {
 
 		CPS::Task::List getTasks();
 
+		/// The factorized system matrix resides on the device and is not restamped
+		void setTimeStepLevel(UInt level) { throw UnsupportedSolverException(); }
+
 		class SolveTask : public CPS::Task {
 		public:
 			SolveTask(MnaSolverGpu<VarType>& solver, Bool steadyStateInit) :
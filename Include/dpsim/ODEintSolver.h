@@ -8,20 +8,23 @@
 
 #pragma once
 
-#include <iostream>
 #include <vector>
-#include <list>
 
 #include <dpsim/Solver.h>
+#include <dpsim/Scheduler.h>
 #include <cps/SystemTopology.h>
 #include <cps/Solver/ODEintInterface.h>
 
 #include <boost/numeric/odeint/stepper/runge_kutta4.hpp> //ODEInt Runge-Kutta stepper
-#include <boost/numeric/odeint/integrate/integrate_const.hpp>//ODEInt Integrator with constant time step
 
 namespace DPsim {
     /// Solver class which uses ODE systems
+    ///
+    /// All state is held per instance, so several solvers can integrate
+    /// different components concurrently.
     class ODEintSolver : public Solver {
+    public:
+        typedef std::vector<Real> State;
 
     protected:
         /// Pointer to current Component
@@ -29,35 +32,65 @@ namespace DPsim {
         /// Constant time step
         Real mTimestep;
         ///Problem Size
-        int ProbDim;
-        /// Stepper needed by ODEint
-        boost::numeric::odeint::runge_kutta4<std::vector<Real>> stepper;
-        /// Vector containing the solution at every timestep
-        std::vector<std::vector<Real>> solution;
-        /// Vector containing all timesteps
-        std::vector<Real> times;
+        Int mProbDim;
+        /// Stepper needed by ODEint, its temporaries are allocated on the first step
+        boost::numeric::odeint::runge_kutta4<State> mStepper;
         ///ODE of Component
-        std::vector<CPS::ODEintInterface::stateFnc> system;
-
-    private:
-        ///static pointer to current object; only one instance currently allowed
-        inline static ODEintSolver *self = nullptr;
-        /// State space of the System and corresponding static wrapper
-        static void StateSpaceWrapper( const std::vector<double> y, std::vector<double> ydot, double t);
+        std::vector<CPS::ODEintInterface::stateFnc> mSystem;
+        /// Current solution vector
+        State mCurrentSolution;
+        /// Keep the solution of every step
+        Bool mRetainHistory = false;
+        /// Solution at every step, only filled if mRetainHistory is set
+        std::vector<State> mSolutionHistory;
+        /// Time of every step, only filled if mRetainHistory is set
+        std::vector<Real> mTimeHistory;
 
+        /// State space of the system as seen by the stepper
+        void stateSpace(const State &y, State &ydot, Real t);
 
     public:
-        /// Current solution vector
-        std::vector<Real> curSolution;
         /// Create solve object with given parameters
-        ODEintSolver(String name,CPS::ODEintInterface::Ptr comp, Real dt, Real t0);
+        ODEintSolver(String name, CPS::ODEintInterface::Ptr comp, Real dt, Real t0);
+
+        /// Keep the solution of every step. The history is preallocated for
+        /// the given number of steps.
+        void setSolutionHistory(Bool retain, UInt expectedSteps = 0);
+        ///
+        const State& currentSolution() const { return mCurrentSolution; }
+        ///
+        const std::vector<State>& solutionHistory() const { return mSolutionHistory; }
+        ///
+        const std::vector<Real>& timeHistory() const { return mTimeHistory; }
 
         /// Solve system for the current time
         Real step(Real time);
 
-        /// Deallocate all memory
-        ~ODEintSolver();
+        class SolveTask : public CPS::Task {
+        public:
+            SolveTask(ODEintSolver& solver)
+            : Task(solver.mName + ".Solve"), mSolver(solver) {
+                // Components that exchange their state through attributes
+                // are ordered by them, all others run as external task
+                auto attrComp = std::dynamic_pointer_cast<CPS::AttributeList>(solver.mComponent);
+                if (attrComp && attrComp->attributes().count("ode_pre_state")
+                    && attrComp->attributes().count("ode_post_state")) {
+                    mAttributeDependencies.push_back(attrComp->attribute("ode_pre_state"));
+                    mModifiedAttributes.push_back(attrComp->attribute("ode_post_state"));
+                } else {
+                    mModifiedAttributes.push_back(Scheduler::external);
+                }
+            }
+
+            void execute(Real time, Int timeStepCount) { mSolver.step(time); }
+
+        private:
+            ODEintSolver& mSolver;
+        };
+
+        CPS::Task::List getTasks() {
+            return CPS::Task::List{std::make_shared<SolveTask>(*this)};
+        }
     };
 
 }
-
@@ -19,10 +19,12 @@ namespace DPsim {
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
 		void step(Real time, Int timeStepCount);
 		void stop();
+		UInt numThreads() const { return static_cast<UInt>(mNumThreads); }
 
 	private:
 		Int mNumThreads;
 		String mOutMeasurementFile;
-		std::vector<CPS::Task::List> mLevels;
+		/// Task levels for each rate phase
+		std::vector<std::vector<CPS::Task::List>> mLevels;
 	};
 };
@@ -0,0 +1,84 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+#include <cps/Task.h>
+
+namespace DPsim {
+	/// \brief Writes the outputs of a step while the next step is solved.
+	///
+	/// Each stage replaces an output task in the task graph by a task that
+	/// only copies the output values into one of two buffers. At the end of
+	/// the step, the output thread writes this buffer while the simulation
+	/// continues with the next step and fills the other buffer. A step only
+	/// waits for the output of the previous step to be finished before
+	/// handing over its own buffer.
+	class OutputPipeline {
+	public:
+		/// Copies the values of a step into the given buffer
+		typedef std::function<void(UInt buffer, Real time, Int timeStepCount)> SnapshotFunction;
+		/// Outputs the values of the given buffer
+		typedef std::function<void(UInt buffer)> WriteFunction;
+
+		~OutputPipeline() { stop(); }
+
+		/// Returns the task that takes the snapshot instead of the given
+		/// output task. It keeps the dependencies and rate of the output task.
+		CPS::Task::Ptr addStage(CPS::Task::Ptr outputTask, SnapshotFunction snapshot, WriteFunction write);
+		/// Remove all stages
+		void clear() { mStages.clear(); }
+		///
+		Bool empty() const { return mStages.empty(); }
+
+		/// Passes the snapshots of a finished step to the output thread
+		void push();
+		/// Waits until all snapshots are written and stops the output thread
+		void stop();
+
+	private:
+		struct Stage {
+			SnapshotFunction snapshot;
+			WriteFunction write;
+			/// A snapshot was taken into the buffer
+			Bool filled[2];
+		};
+
+		class SnapshotTask : public CPS::Task {
+		public:
+			SnapshotTask(OutputPipeline& pipeline, UInt stage, CPS::Task::Ptr outputTask);
+
+			void execute(Real time, Int timeStepCount);
+
+		private:
+			OutputPipeline& mPipeline;
+			UInt mStage;
+		};
+
+		void threadFunction();
+
+		std::vector<Stage> mStages;
+		std::thread mThread;
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		/// Buffer that is filled by the next snapshot
+		UInt mBackBuffer = 0;
+		/// Buffer that is written by the output thread
+		UInt mFrontBuffer = 1;
+		/// The front buffer is waiting for the output thread
+		Bool mPending = false;
+		Bool mStopping = false;
+	};
+}
@@ -50,6 +50,14 @@ namespace DPsim {
 
         /// Jacobian matrix
         CPS::Matrix mJ;
+        /// Jacobian with the structural nonzeros given by the admittance matrix
+        CPS::SparseMatrix mJSparse;
+        /// LU factorization of the Jacobian, the symbolic analysis is reused
+        Eigen::SparseLU<CPS::SparseMatrix> mJLU;
+        /// Flag whether the sparsity pattern of the Jacobian has been analyzed
+        CPS::Bool mJacobianAnalyzed = false;
+        /// Start each time step from the solution of the previous one
+        CPS::Bool mWarmStart = false;
         /// Solution vector
         CPS::Vector mX;
 	    /// Vector of mismatch values
@@ -110,6 +118,9 @@ namespace DPsim {
         void setBaseApparentPower();
         /// Determine bus type for all buses
         void determinePFBusType();
+        /// Determines the bus types again after a component changed its
+        /// bus type and discards everything that depends on them
+        virtual void updatePFBusTypes();
         /// Compose admittance matrix
 		void composeAdmittanceMatrix();
         /// Gets the real part of admittance matrix element
@@ -117,7 +128,9 @@ namespace DPsim {
         /// Gets the imaginary part of admittance matrix element
         CPS::Real B(int i, int j);
         /// Solves the powerflow problem
-        Bool solvePowerflow();
+        virtual Bool solvePowerflow();
+        /// Creates the sparsity pattern of the Jacobian and analyzes it
+        void analyzeJacobianPattern();
         /// Check whether below tolerance
         CPS::Bool checkConvergence();
         /// Logging for integer vectors
@@ -142,6 +155,13 @@ namespace DPsim {
         void setVDNode(CPS::String name);
         /// Allows to modify the powerflow bus type of a specific component
         void modifyPowerFlowBusComponent(CPS::String name, CPS::PowerflowBusType powerFlowBusType);
+        /// Start the Newton iterations from the last converged solution
+        void doWarmStart(Bool value = true) { mWarmStart = value; }
+        /// Updates the profiles, solves the powerflow for the given time
+        /// and stores the solution in the nodes. Returns true if converged.
+        Bool solveTimeStep(Real time);
+        /// Number of iterations of the last solution
+        CPS::UInt iterations() const { return mIterations; }
 
         class SolveTask : public CPS::Task {
 		public:
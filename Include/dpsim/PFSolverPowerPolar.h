@@ -13,7 +13,55 @@
 namespace DPsim {
     /// Powerflow solver class considering power mismatch and voltages in polar coordinates.
     class PFSolverPowerPolar : public PFSolver {
+    public:
+        /// Iteration scheme of the powerflow
+        enum class Method { NewtonRaphson, FastDecoupled };
+
+        /// Solution of the system with one branch removed
+        struct ContingencyResult {
+            /// Name of the removed line or transformer
+            CPS::String branch;
+            CPS::Bool converged = false;
+            /// Some buses lost the connection to all VD buses
+            CPS::Bool islanded = false;
+            CPS::UInt iterations = 0;
+            /// Voltage magnitudes in per unit, indexed by matrix node index
+            CPS::Vector voltageMagnitude;
+            /// Voltage angles in rad, indexed by matrix node index
+            CPS::Vector voltageAngle;
+        };
+
     protected:
+        /// Change of the admittance matrix caused by a branch outage
+        struct BranchOutage {
+            CPS::UInt buses[2];
+            CPS::MatrixComp deltaY;
+        };
+        /// Branch outage applied as low-rank update to a factorized decoupled matrix
+        struct DecoupledUpdate {
+            /// Rows of the decoupled matrix touched by the outage
+            std::vector<CPS::UInt> positions;
+            /// Change of the matrix at these rows
+            CPS::Matrix delta;
+            /// Inverse of the unmodified matrix applied to the touched unit vectors
+            CPS::Matrix factors;
+            /// Factorized capacitance matrix of the Woodbury identity
+            Eigen::FullPivLU<CPS::Matrix> capacitance;
+        };
+
+        /// Iteration scheme used by solvePowerflow
+        Method mMethod = Method::NewtonRaphson;
+        /// Maximum number of fast-decoupled iterations
+        CPS::UInt mMaxDecoupledIterations = 100;
+        /// Decoupled matrix relating active power and voltage angles
+        CPS::SparseMatrix mBp;
+        /// Decoupled matrix relating reactive power and voltage magnitudes
+        CPS::SparseMatrix mBpp;
+        Eigen::SparseLU<CPS::SparseMatrix> mBpLU;
+        Eigen::SparseLU<CPS::SparseMatrix> mBppLU;
+        /// Flag whether the decoupled matrices are factorized
+        CPS::Bool mDecoupledFactorized = false;
+
         /// Solution vector of active power
         CPS::Vector sol_P;
         /// Solution vector of reactive power
@@ -41,6 +89,31 @@ namespace DPsim {
         void setSolution();
         /// Calculate mismatch
         void calculateMismatch();
+        /// Solves the powerflow problem with the selected method
+        Bool solvePowerflow() override;
+        /// Also discards the factorized decoupled matrices
+        void updatePFBusTypes() override;
+
+        // Fast-decoupled methods
+        /// Build and factorize the decoupled matrices from the admittance matrix
+        void factorizeDecoupledMatrices();
+        /// Fast-decoupled iterations starting from the given voltages,
+        /// optionally with a branch removed from the system
+        CPS::Bool solveFastDecoupled(CPS::Vector& V, CPS::Vector& D,
+            const BranchOutage* outage, CPS::UInt& iterations) const;
+        /// Active and reactive power injections for the given voltages
+        void calculatePowerInjections(const CPS::Vector& V, const CPS::Vector& D,
+            const BranchOutage* outage, CPS::Vector& P, CPS::Vector& Q) const;
+        /// Prepare the low-rank update of a decoupled matrix for a branch outage
+        void prepareDecoupledUpdate(const Eigen::SparseLU<CPS::SparseMatrix>& lu,
+            CPS::UInt size, const BranchOutage& outage, DecoupledUpdate& update) const;
+        /// Solve with a decoupled matrix and an optional low-rank update
+        CPS::Vector solveDecoupled(const Eigen::SparseLU<CPS::SparseMatrix>& lu,
+            const DecoupledUpdate* update, const CPS::Vector& rhs) const;
+        /// Admittance change for removing the given line or transformer
+        BranchOutage branchOutage(CPS::SimPowerComp<CPS::Complex>::Ptr branch) const;
+        /// Check whether all buses are still connected to a VD bus
+        CPS::Bool isIslanded(const BranchOutage& outage) const;
 
         // Helper methods
         /// Resize solution vector
@@ -70,5 +143,14 @@ namespace DPsim {
         PFSolverPowerPolar(CPS::String name, CPS::SystemTopology system, CPS::Real timeStep, CPS::Logger::Level logLevel);
         ///
 		virtual ~PFSolverPowerPolar() { };
+
+        /// Select the iteration scheme of the powerflow
+        void setMethod(Method method) { mMethod = method; }
+        /// Solves the base case at the given time and then each case with
+        /// one of the given lines or transformers removed. The cases are
+        /// solved in parallel with the fast-decoupled method. An empty list
+        /// selects all lines and transformers.
+        std::vector<ContingencyResult> screenContingencies(Real time,
+            const std::vector<CPS::String>& branches = std::vector<CPS::String>());
     };
 }
@@ -0,0 +1,83 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <functional>
+
+#include <dpsim/PFSolverPowerPolar.h>
+
+namespace DPsim {
+	/// \brief Quasi-static time-series powerflow over a horizon of time steps.
+	///
+	/// The horizon is split into segments that are solved in parallel.
+	/// Each segment works on its own copy of the system, created by the
+	/// system factory, and starts every time step from the solution of
+	/// the previous one.
+	class PFTimeSeries {
+	public:
+		typedef std::function<CPS::SystemTopology()> SystemFactory;
+		typedef std::function<void(PFSolver&)> SolverConfiguration;
+
+	protected:
+		///
+		String mName;
+		///
+		SystemFactory mSystemFactory;
+		/// Optional settings applied to each segment solver
+		SolverConfiguration mConfigure;
+		///
+		Real mStartTime;
+		///
+		Real mTimeStep;
+		///
+		UInt mNumSteps;
+		///
+		CPS::Logger::Level mLogLevel;
+		/// Number of segments, zero to use one per thread
+		UInt mNumSegments = 0;
+		/// Start from the solution of the previous time step
+		Bool mWarmStart = true;
+
+		/// Complex node voltages, one row per time step
+		MatrixComp mVoltages;
+		/// Newton iterations for each time step
+		std::vector<UInt> mIterations;
+		/// Convergence flag for each time step, not a vector<bool>
+		/// since the segments write concurrently
+		std::vector<char> mConverged;
+		/// Node names in the order of the voltage columns
+		std::vector<String> mNodeNames;
+
+	public:
+		PFTimeSeries(SystemFactory systemFactory, String name,
+			Real startTime, Real timeStep, UInt numSteps,
+			CPS::Logger::Level logLevel = CPS::Logger::Level::off);
+
+		/// Settings like the VD node that are applied to each solver
+		void setSolverConfiguration(SolverConfiguration configure) { mConfigure = configure; }
+		/// Number of horizon segments solved in parallel
+		void setNumSegments(UInt numSegments) { mNumSegments = numSegments; }
+		///
+		void doWarmStart(Bool value = true) { mWarmStart = value; }
+
+		/// Solve the powerflow for all time steps of the horizon
+		void run();
+
+		///
+		const MatrixComp& voltages() const { return mVoltages; }
+		///
+		const std::vector<String>& nodeNames() const { return mNodeNames; }
+		///
+		const std::vector<UInt>& iterations() const { return mIterations; }
+		///
+		Bool converged(UInt step) const { return mConverged[step] != 0; }
+		/// Number of time steps that did not converge
+		UInt numNotConverged() const;
+	};
+}
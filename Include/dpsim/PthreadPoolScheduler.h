@@ -31,15 +31,17 @@ namespace DPsim {
 
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
 		void step(Real time, Int timeStepCount);
+		UInt numThreads() const { return static_cast<UInt>(mThreads.size()); }
 
 	private:
 		static void* poolThreadFunction(void* data);
 
 		std::vector<pthread_t> mThreads;
 
-		CPS::Task::List mTasks;
-		Edges mInEdges;
-		Edges mOutEdges;
+		/// Tasks and dependencies per rate phase
+		std::vector<CPS::Task::List> mTasks;
+		std::vector<Edges> mInEdges;
+		std::vector<Edges> mOutEdges;
 
 		struct queue_signalled mOutQueue;
 		struct queue_signalled mDoneQueue;
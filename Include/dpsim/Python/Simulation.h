@@ -104,6 +104,10 @@ namespace Python {
 		static PyObject* addEventFD(Simulation *self, PyObject *args);
 		static PyObject* removeEventFD(Simulation *self, PyObject *args);
 		static PyObject* setScheduler(Simulation *self, PyObject *args, PyObject *kwargs);
+		static PyObject* setThreadBudget(Simulation *self, PyObject *args);
+		static PyObject* setDAELinearSolver(Simulation *self, PyObject *args);
+		static PyObject* setPipelinedOutput(Simulation *self, PyObject *args);
+		static PyObject* setStepDeadline(Simulation *self, PyObject *args);
 
 		// Setters
 		static int setFinalTime(Simulation *self, PyObject *val, void *ctx);
@@ -128,6 +132,10 @@ namespace Python {
 		static const char *docAddEventFD;
 		static const char *docRemoveEventFD;
 		static const char *docSetScheduler;
+		static const char *docSetThreadBudget;
+		static const char *docSetDAELinearSolver;
+		static const char *docSetPipelinedOutput;
+		static const char *docSetStepDeadline;
 		static const char *docState;
 		static const char *docName;
 		static PyMethodDef methods[];
@@ -24,6 +24,8 @@ namespace DPsim {
 	// TODO extend / subclass
 	class SchedulingException {};
 
+	class FusedTask;
+
 	class Scheduler {
 	public:
 		/// Edges describe the dependency from the first task to a list of other tasks
@@ -52,6 +54,15 @@ namespace DPsim {
 		virtual void step(Real time, Int timeStepCount) = 0;
 		/// Called on simulation stop to reliably clean up e.g. running helper threads
 		virtual void stop() {}
+		/// Continues with the given step instead of the following one,
+		/// e.g. after the simulation state was restored from a snapshot
+		virtual void reset(Int timeStepCount) {}
+		/// Number of threads executing tasks concurrently
+		virtual UInt numThreads() const { return 1; }
+
+		/// Largest number of tasks in one level of the dependency graph,
+		/// i.e. the number of tasks that can be executed concurrently
+		UInt graphWidth(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
 
 		/// Helper function that resolves the task-attribute dependencies to task-task dependencies
 		/// and inserts a root task
@@ -63,10 +74,31 @@ namespace DPsim {
 		// TODO is it really fine to use nullptr or should we create a special sentinel attribute?
 		static CPS::AttributeBase::Ptr external;
 
+		/// Least common multiple of two rate divisors
+		static UInt commonRateDivisor(UInt a, UInt b);
+
 		TaskTime getAveragedMeasurement(CPS::Task::Ptr task) {
 			return getAveragedMeasurement(task.get());
 		}
 
+		/// Fuse small tasks until each task takes at least the given time.
+		/// Tasks without a measurement are assumed to take defaultTime.
+		/// A granularity of zero disables the fusion.
+		void setTaskGranularity(TaskTime granularity,
+			TaskTime defaultTime = std::chrono::nanoseconds(500)) {
+			mTaskGranularity = granularity;
+			mDefaultTaskTime = defaultTime;
+		}
+
+		/// Skip deferrable tasks that are not expected to finish before the
+		/// deadline, measured from the start of each step. Deferrable tasks
+		/// without dependent critical tasks are postponed to the end of the
+		/// step. Zero disables the deadline. Has to be set before the
+		/// schedule is created.
+		void setStepDeadline(TaskTime deadline) { mStepDeadline = deadline; }
+		/// Number of times each deferrable task was skipped
+		std::unordered_map<String, UInt> shedTasks() const;
+
 		/// Root task that has a dependency on the external attribute
 		/// which means that it should not be removed from the task graph
 		class Root : public CPS::Task {
@@ -87,11 +119,53 @@ namespace DPsim {
 		/// executed in parallel
 		static void levelSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges, std::vector<CPS::Task::List>& levels);
 
+		/// Determines the number of rate phases after which the schedule repeats,
+		/// i.e. the least common multiple of the rate divisors of all tasks.
+		/// Throws if it exceeds maxRatePhases.
+		void initRatePhases(const CPS::Task::List& tasks);
+		/// Extracts the tasks that are executed in the given rate phase together with
+		/// the dependencies among them, keeping the order of the task list.
+		/// Dependencies via inactive tasks are replaced by dependencies on
+		/// their active predecessors.
+		static void filterRatePhase(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges,
+			UInt phase, CPS::Task::List& phaseTasks, Edges& phaseInEdges, Edges& phaseOutEdges);
+		/// Rate phase which is executed in the given time step
+		UInt ratePhase(Int timeStepCount) const {
+			return static_cast<UInt>(timeStepCount) % mNumRatePhases;
+		}
+
+		/// Merges chains and independent tasks of the same level of the
+		/// topologically sorted task graph into fused tasks until each task
+		/// reaches the task granularity. Expected execution times are taken
+		/// from the measurements, which are extended by the fused tasks.
+		void fuseTasks(CPS::Task::List& tasks, Edges& inEdges, Edges& outEdges,
+			std::unordered_map<String, TaskTime::rep>& measurements);
+		/// Returns true if small tasks should be fused
+		Bool fuseTasksEnabled() const { return mTaskGranularity > TaskTime::zero(); }
+
+		/// Returns true if deferrable tasks are skipped at the deadline
+		Bool deadlineEnabled() const { return mStepDeadline > TaskTime::zero(); }
+		/// Prepares the execution time estimates of the deferrable tasks
+		void initDeadline(const CPS::Task::List& tasks);
+		/// Moves deferrable tasks behind the critical tasks if no critical
+		/// task depends on them, keeping the topological order
+		void postponeDeferrable(CPS::Task::List& tasks, const Edges& outEdges);
+		/// Marks the start of a step, from which the deadline is measured
+		void startStep() { mStepStart = std::chrono::steady_clock::now(); }
+		/// Executes a deferrable task if it is expected to finish before the deadline
+		void executeDeferrable(CPS::Task* task, Real time, Int timeStepCount);
+		/// Logs the skipped deferrable tasks
+		void logShedTasks();
+
+		/// Clears the measurements of the tasks and of the tasks fused into them
 		void initMeasurements(const CPS::Task::List& tasks);
+		/// Enables the measurement of the tasks fused into the measured tasks
+		void measureFusedTasks(Bool measure);
 		/// Not thread-safe for multiple calls with same task, but should only
 		/// be called once for each task in each step anyway
 		void updateMeasurement(CPS::Task* task, TaskTime time);
-		/// Write measurement data to file
+		/// Write measurement data to file. Fused tasks are written as the
+		/// tasks they contain.
 		void writeMeasurements(CPS::String filename);
 		/// Read measurement data from file to use it for the scheduling
 		void readMeasurements(CPS::String filename, std::unordered_map<CPS::String, TaskTime::rep>& measurements);
@@ -100,6 +174,16 @@ namespace DPsim {
 
 		///
 		CPS::Task::Ptr mRoot;
+		/// Number of rate phases, a separate schedule is created for each phase
+		UInt mNumRatePhases = 1;
+		/// Largest number of rate phases, each of them holds a full schedule
+		static const UInt maxRatePhases = 1024;
+		/// Minimum expected execution time of a task after fusion
+		TaskTime mTaskGranularity = TaskTime::zero();
+		/// Expected execution time of tasks without measurement
+		TaskTime mDefaultTaskTime = std::chrono::nanoseconds(500);
+		/// Time after the start of a step by which all tasks should be finished
+		TaskTime mStepDeadline = TaskTime::zero();
 
 	private:
 		/// Log level
@@ -110,6 +194,20 @@ namespace DPsim {
 		// longer simulations (risk of high memory requirements and integer
 		// overflow)
 		std::unordered_map<CPS::Task*, std::vector<TaskTime>> mMeasurements;
+		/// Measured fused tasks, filled before the simulation
+		std::unordered_map<CPS::Task*, FusedTask*> mFusedTasks;
+
+		struct DeferrableTask {
+			/// Conservative estimate of the execution time
+			TaskTime expected = TaskTime::zero();
+			/// Number of skipped executions
+			UInt shed = 0;
+		};
+		/// Only contains deferrable tasks, filled before the simulation
+		/// so that it can be accessed by multiple threads
+		std::unordered_map<CPS::Task*, DeferrableTask> mDeferrableTasks;
+		/// Start of the current step
+		std::chrono::steady_clock::time_point mStepStart;
 	};
 
 	/// A barrier is used to synchronize threads. Threads running into the barrier
@@ -203,6 +301,30 @@ namespace DPsim {
 		std::vector<Barrier*> mBarriers;
 	};
 
+	/// Sequence of tasks that is scheduled and executed like a single task.
+	/// It is named after all of its tasks, so that fused tasks of different
+	/// rate phases only share a name if they contain the same tasks.
+	class FusedTask : public CPS::Task {
+	public:
+		typedef std::shared_ptr<FusedTask> Ptr;
+
+		FusedTask(const CPS::Task::List& tasks);
+		void execute(Real time, Int timeStepCount);
+
+		const CPS::Task::List& tasks() const { return mTasks; }
+		/// Measures the execution time of each task in every execution
+		void measureTasks(Bool measure) {
+			mTaskTimes.assign(measure ? mTasks.size() : 0, Scheduler::TaskTime::zero());
+		}
+		/// Execution times of the tasks in the last execution,
+		/// empty if they are not measured
+		const std::vector<Scheduler::TaskTime>& taskTimes() const { return mTaskTimes; }
+
+	private:
+		CPS::Task::List mTasks;
+		std::vector<Scheduler::TaskTime> mTaskTimes;
+	};
+
 	class Counter {
 	public:
 		Counter() : mValue(0) {}
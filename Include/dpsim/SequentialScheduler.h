@@ -28,7 +28,8 @@ namespace DPsim {
 		void stop();
 
 	private:
-		CPS::Task::List mSchedule;
+		/// Sorted task lists for each rate phase
+		std::vector<CPS::Task::List> mSchedules;
 
 		std::unordered_map<size_t, std::vector<std::chrono::nanoseconds>> mMeasurements;
 		std::vector<std::chrono::nanoseconds> mStepMeasurements;
@@ -20,6 +20,7 @@
 
 #include <dpsim/Config.h>
 #include <dpsim/DataLogger.h>
+#include <dpsim/OutputPipeline.h>
 #include <dpsim/Solver.h>
 #include <dpsim/Scheduler.h>
 #include <dpsim/Event.h>
@@ -58,6 +59,8 @@ namespace DPsim {
 		Int mTimeStepCount = 0;
 		/// The simulation event queue
 		EventQueue mEvents;
+		/// Timing wheels for high-volume setpoint changes
+		std::vector<EventWheel::Ptr> mEventWheels;
 		/// System list
 		CPS::SystemTopology mSystem;
 
@@ -100,14 +103,42 @@ namespace DPsim {
 		Real mSteadStIniTimeLimit = 10;
 		/// steady state initialization accuracy limit
 		Real mSteadStIniAccLimit = 0.0001;
+		/// steady state initialization time step, zero to use the simulation time step
+		Real mSteadStIniTimeStep = 0;
 		/// Determines if steady-state initialization
 		/// should be executed prior to the simulation.
 		/// By default the initialization is disabled.
 		Bool mSteadyStateInit = false;
 
+		/// Factorization method of the MNA system matrices
+		Solver::Factorization mFactorization = Solver::Factorization::LU;
+		/// Linear solver of DAE solvers
+		Solver::DAELinearSolver mDAELinearSolver = Solver::DAELinearSolver::Dense;
+
+		// #### adaptive time step ####
+		/// Determines if the time step is adapted during the simulation
+		Bool mAdaptiveTimeStep = false;
+		/// Time steps the simulation can switch between in ascending order
+		std::vector<Real> mTimeStepLevels;
+		/// Index of the active time step in mTimeStepLevels
+		UInt mTimeStepLevel = 0;
+		/// Local error relative to the solution above which the time step is reduced
+		Real mAdaptiveTimeStepTol = 0.001;
+		/// Minimum number of steps before the time step is increased again
+		UInt mAdaptiveTimeStepHold = 10;
+		/// Number of steps since the last time step change
+		UInt mStepsSinceTimeStepChange = 0;
+
 		// #### Task dependencies und scheduling ####
 		/// Scheduler used for task scheduling
 		std::shared_ptr<Scheduler> mScheduler;
+		/// Number of cores shared by the scheduler threads and the
+		/// parallel kernels inside tasks, 0 to use all cores
+		UInt mThreadBudget = 0;
+		/// OpenMP and Eigen thread counts of the process before the budget
+		/// was applied, 0 if the budget is not applied
+		UInt mPrevMaxThreads = 0;
+		Int mPrevEigenThreads = 0;
 		/// List of all tasks to be scheduled
 		CPS::Task::List mTasks;
 		/// Task dependencies as incoming / outgoing edges
@@ -134,6 +165,14 @@ namespace DPsim {
 
 		/// The data loggers
 		DataLogger::List mLoggers;
+		/// Only copy the values of data loggers and interface exports in the
+		/// task graph and write them while the next step is solved
+		Bool mPipelinedOutput = false;
+		/// Output thread for pipelined output
+		OutputPipeline mOutputPipeline;
+		/// Time after the start of a step in seconds, after which deferrable
+		/// tasks are skipped, zero to execute all tasks
+		Real mStepDeadline = 0;
 
 		/// Creates system matrix according to
 		Simulation(String name,
@@ -145,6 +184,12 @@ namespace DPsim {
 		void createSolvers(CPS::SystemTopology& system, CPS::IdentifiedObject::List& tearComponents);
 
 		void prepSchedule();
+		/// Split the given number of cores between the scheduler threads and
+		/// the kernel threads of Eigen according to the task graph width
+		void distributeThreads(UInt cores);
+		/// Select the time step of the next step from the local error
+		/// estimates of the solvers and the pending events
+		void updateTimeStep(Bool eventHandled);
 	public:
 		/// Simulation logger
 		CPS::Logger::Log mLog;
@@ -164,7 +209,7 @@ namespace DPsim {
 			CPS::IdentifiedObject::List tearComponents = CPS::IdentifiedObject::List());
 
 		/// Desctructor
-		virtual ~Simulation() { }
+		virtual ~Simulation() { restoreThreads(); }
 
 		// #### Simulation Settings ####
 		///
@@ -197,9 +242,40 @@ namespace DPsim {
 		void setSteadStIniTimeLimit(Real v) { mSteadStIniTimeLimit = v; }
 		/// set steady state initialization accuracy limit
 		void setSteadStIniAccLimit(Real v) { mSteadStIniAccLimit = v; }
+		/// set steady state initialization time step
+		void setSteadStIniTimeStep(Real v) { mSteadStIniTimeStep = v; }
+
+		// #### adaptive time step ####
+		/// activate adaptive time step. Without explicit time steps,
+		/// the simulation switches between 1, 10 and 100 times the time step.
+		void doAdaptiveTimeStep(Bool f) { mAdaptiveTimeStep = f; }
+		/// set time steps the simulation can switch between
+		void setAdaptiveTimeSteps(std::vector<Real> timeSteps) { mTimeStepLevels = timeSteps; }
+		/// set local error tolerance relative to the solution
+		void setAdaptiveTimeStepTol(Real v) { mAdaptiveTimeStepTol = v; }
+		/// set minimum number of steps before the time step is increased again
+		void setAdaptiveTimeStepHold(UInt v) { mAdaptiveTimeStepHold = v; }
 
 		///
 		void doHarmonicParallelization(Bool parallel) { mHarmParallel = parallel; }
+		/// set factorization method of the MNA system matrices
+		void setFactorization(Solver::Factorization method) { mFactorization = method; }
+		/// set linear solver of DAE solvers
+		void setDAELinearSolver(Solver::DAELinearSolver solver) { mDAELinearSolver = solver; }
+		/// set number of cores used by the simulation, 0 for all cores
+		void setThreadBudget(UInt cores) { mThreadBudget = cores; }
+		/// Number of cores used by the simulation
+		UInt threadBudget() const;
+		/// Restore the OpenMP and Eigen thread counts of the process
+		/// that were changed to apply the thread budget
+		void restoreThreads();
+		/// Write data loggers and interface exports of a step while the next
+		/// step is solved. The task graph only copies the output values.
+		void setPipelinedOutput(Bool enabled) { mPipelinedOutput = enabled; }
+		/// Skip deferrable tasks such as data loggers when they would finish
+		/// later than the given time in seconds after the start of a step,
+		/// e.g. to keep a real-time simulation running on occasional spikes
+		void setStepDeadline(Real deadline) { mStepDeadline = deadline; }
 
 		// #### Simulation Control ####
 		/// Create solver instances etc.
@@ -214,11 +290,26 @@ namespace DPsim {
 		void schedule();
 		/// Reset internal state of simulation
 		void reset();
+		/// Store the states of all components and solvers in a snapshot
+		void checkpoint(CPS::Snapshot& snapshot);
+		/// Continue the simulation from a snapshot of this simulation.
+		/// Pending events and data loggers are not part of the snapshot.
+		void restore(CPS::Snapshot& snapshot);
+
+		/// Impedance matrices between the given nodes for each frequency in Hz,
+		/// computed from the admittance stamps of the components. Requires
+		/// a single MNA solver, so subnets must not be split.
+		std::vector<MatrixComp> impedanceSweep(const std::vector<Real>& frequencies,
+			const CPS::TopologicalNode::List& nodes);
 
 		/// Schedule an event in the simulation
 		void addEvent(Event::Ptr e) {
 			mEvents.addEvent(e);
 		}
+		/// Apply the setpoint changes of an event wheel in the simulation
+		void addEventWheel(EventWheel::Ptr wheel) {
+			mEventWheels.push_back(wheel);
+		}
 		/// Add a new data logger
 		void addLogger(DataLogger::Ptr logger) {
 			mLoggers.push_back(logger);
@@ -247,6 +338,7 @@ namespace DPsim {
 		Real timeStep() const { return mTimeStep; }
 		DataLogger::List& loggers() { return mLoggers; }
 		std::shared_ptr<Scheduler> scheduler() { return mScheduler; }
+		OutputPipeline& outputPipeline() { return mOutputPipeline; }
 		std::vector<Real>& stepTimes() { return mStepTimes; }
 	};
 }
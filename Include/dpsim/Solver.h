@@ -15,6 +15,7 @@
 #include <dpsim/Definitions.h>
 #include <dpsim/Config.h>
 #include <cps/Logger.h>
+#include <cps/Snapshot.h>
 #include <cps/SystemTopology.h>
 #include <cps/Task.h>
 
@@ -38,6 +39,8 @@ namespace DPsim {
 		Real mTimeStep;
 		///
 		Bool mFrequencyParallel = false;
+		/// The solver's tasks are executed every mRateDivisor-th simulation step
+		UInt mRateDivisor = 1;
 		/// Switch to trigger steady-state initialization
 
 		// #### steady state initialization ####
@@ -45,9 +48,17 @@ namespace DPsim {
 		Real mSteadStIniTimeLimit = 10;
 		/// steady state initialization accuracy limit
 		Real mSteadStIniAccLimit = 0.0001;
+		/// steady state initialization time step, zero to use the simulation time step
+		Real mSteadStIniTimeStep = 0;
 		/// flag to activate steady state initialization
 		Bool mSteadyStateInit = false;
 
+		// #### adaptive time step ####
+		/// Time steps the solver can switch between, empty for a fixed time step
+		std::vector<Real> mTimeStepLevels;
+		/// Index of the active time step in mTimeStepLevels
+		UInt mTimeStepLevel = 0;
+
 	public:
 		typedef std::shared_ptr<Solver> Ptr;
 		typedef std::vector<Ptr> List;
@@ -64,9 +75,53 @@ namespace DPsim {
 
 		enum class Type { MNA, DAE, NRP };
 
+		/// Factorization of the linear system of MNA solvers
+		enum class Factorization {
+			/// LU with partial pivoting of the real system
+			LU,
+			/// LU of the phasor system in complex arithmetic for DP and SP,
+			/// which has half the size of its real representation
+			ComplexLU,
+			/// LU in single precision with iterative refinement against
+			/// the double precision system, LU if refinement fails
+			MixedPrecision,
+			/// Cholesky or LDLT of symmetric real systems, such as EMT
+			/// networks of passive elements and sources
+			Symmetric,
+			/// Precomputed inverse, so that each solve is a matrix-vector
+			/// product with fixed cost. Limited to small systems.
+			Inverse,
+			/// Chosen by MNA solvers from the structure of the system
+			/// and short benchmarks of the applicable methods
+			Auto
+		};
+
+		/// Linear solver used in the Newton iterations of DAE solvers
+		enum class DAELinearSolver {
+			/// Dense matrix and LU factorization
+			Dense,
+			/// Sparse Jacobian from the residual structure, factorized by KLU.
+			/// Falls back to Krylov if sundials was built without KLU.
+			Sparse,
+			/// Jacobian-free GMRES, preconditioned with a sparse LU of the
+			/// Jacobian from the residual structure
+			Krylov
+		};
+
+	protected:
+		/// Factorization method of the system matrices
+		Factorization mFactorization = Factorization::LU;
+		/// Number of steps the solver is expected to run, 0 if unknown
+		UInt mExpectedSteps = 0;
+
+	public:
 		virtual CPS::Task::List getTasks() = 0;
 		/// Log results
 		virtual void log(Real time) { };
+		/// Store the solver state in a snapshot
+		virtual void saveState(CPS::Snapshot& snapshot) { }
+		/// Restore the solver state from a snapshot
+		virtual void loadState(CPS::Snapshot& snapshot) { }
 
 		// #### Solver settings ####
 		///
@@ -77,6 +132,12 @@ namespace DPsim {
 		void doFrequencyParallelization(Bool freqParallel) {
 			mFrequencyParallel = freqParallel;
 		}
+		/// Execute the solver's tasks only every n-th simulation step
+		void setRateDivisor(UInt divisor) {
+			mRateDivisor = divisor > 0 ? divisor : 1;
+		}
+		///
+		UInt rateDivisor() const { return mRateDivisor; }
 
 		///
 		virtual void setSystem(CPS::SystemTopology system) {}
@@ -91,5 +152,27 @@ namespace DPsim {
 		void setSteadStIniTimeLimit(Real v) { mSteadStIniTimeLimit = v; }
 		/// set steady state initialization accuracy limit
 		void setSteadStIniAccLimit(Real v) { mSteadStIniAccLimit = v; }
+		/// set steady state initialization time step
+		void setSteadStIniTimeStep(Real v) { mSteadStIniTimeStep = v; }
+
+		// #### adaptive time step ####
+		/// Set the time steps the solver can switch between in ascending
+		/// order. The solver starts with the smallest one.
+		void setTimeStepLevels(const std::vector<Real>& timeSteps) {
+			mTimeStepLevels = timeSteps;
+			mTimeStepLevel = 0;
+			if (!mTimeStepLevels.empty())
+				mTimeStep = mTimeStepLevels.front();
+		}
+		/// Switch to the time step with the given index in the time step levels
+		virtual void setTimeStepLevel(UInt level) { throw UnsupportedSolverException(); }
+		/// Estimated local error of the last step relative to the solution
+		virtual Real localErrorEstimate() { return 0; }
+
+		// #### linear system ####
+		/// Set the factorization method of the system matrices
+		void setFactorization(Factorization method) { mFactorization = method; }
+		/// Set the number of steps, used to weigh setup against solve costs
+		void setExpectedSteps(UInt steps) { mExpectedSteps = steps; }
 	};
 }
@@ -17,11 +17,17 @@ namespace DPsim {
 
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
 
+	protected:
+		void scheduleTasks(const std::unordered_map<String, TaskTime::rep>& measurements, TaskLists& schedules) const;
+
 	private:
-		void scheduleLevel(const CPS::Task::List& tasks, const std::unordered_map<String, TaskTime::rep>& measurements, const Edges& inEdges);
-		void sortTasksByType(CPS::Task::List::iterator begin, CPS::Task::List::iterator end);
+		void scheduleLevel(const CPS::Task::List& tasks, const std::unordered_map<String, TaskTime::rep>& measurements, const Edges& inEdges, UInt phase, TaskLists& schedules) const;
+		static void sortTasksByType(CPS::Task::List::iterator begin, CPS::Task::List::iterator end);
 
 		String mInMeasurementFile;
 		Bool mSortTaskTypes;
+		/// Levels of the tasks and dependencies per rate phase
+		std::vector<std::vector<CPS::Task::List>> mLevels;
+		std::vector<Edges> mPhaseInEdges;
 	};
 };
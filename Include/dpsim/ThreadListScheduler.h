@@ -17,7 +17,18 @@ namespace DPsim {
 
 		void createSchedule(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges);
 
+	protected:
+		void scheduleTasks(const std::unordered_map<String, TaskTime::rep>& measurements, TaskLists& schedules) const;
+
 	private:
+		/// Creates the HLFET list schedule of the tasks executed in one rate phase
+		void scheduleList(const CPS::Task::List& tasks, const Edges& inEdges, const Edges& outEdges,
+			const std::unordered_map<String, TaskTime::rep>& measurements, UInt phase, TaskLists& schedules) const;
+
 		String mInMeasurementFile;
+		/// Tasks and dependencies per rate phase
+		std::vector<CPS::Task::List> mPhaseTasks;
+		std::vector<Edges> mPhaseInEdges;
+		std::vector<Edges> mPhaseOutEdges;
 	};
 };
@@ -10,6 +10,8 @@
 
 #include <dpsim/Scheduler.h>
 
+#include <future>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -21,29 +23,105 @@ namespace DPsim {
 
 		void step(Real time, Int timeStepCount);
 		virtual void stop();
+		void reset(Int timeStepCount);
+		UInt numThreads() const { return static_cast<UInt>(mNumThreads); }
+
+		/// \brief Schedule with task times measured during the simulation.
+		///
+		/// The simulation starts with the default schedule and measures the
+		/// tasks during the first tuningSteps steps. The schedule is then
+		/// recreated from the measured times in the background and activated
+		/// at a step boundary. With a retune period, the times are measured
+		/// again every retunePeriod steps and the schedule is recreated when
+		/// they deviate from the times of the current schedule by more than
+		/// the drift tolerance, e.g. after a switching event.
+		void setOnlineTuning(UInt tuningSteps, UInt retunePeriod = 0, Real driftTolerance = 0.2);
+		/// Number of schedules recreated from measured task times and activated so far
+		UInt tunedSchedules() const { return mTunedSchedules; }
 
 	protected:
-		void finishSchedule(const Edges& inEdges);
-		void scheduleTask(int thread, CPS::Task::Ptr task);
+		/// Task lists per rate phase and thread
+		typedef std::vector<std::vector<CPS::Task::List>> TaskLists;
+
+		void finishSchedule(const TaskLists& schedules, const Edges& inEdges);
+		void scheduleTask(TaskLists& schedules, int thread, CPS::Task::Ptr task, UInt phase = 0) const;
+		/// Distributes the tasks of all rate phases with scheduleTask based on
+		/// the expected execution times. Needs to be implemented for online tuning.
+		/// Called from a background thread, so it must not modify the scheduler.
+		virtual void scheduleTasks(const std::unordered_map<String, TaskTime::rep>& measurements, TaskLists& schedules) const {
+			throw SchedulingException();
+		}
+		/// Returns true if the schedule is tuned with measured task times
+		Bool onlineTuning() const { return mTuningSteps > 0; }
 
 		Int mNumThreads;
 
 	private:
+		struct ScheduleEntry {
+			CPS::Task* task;
+			Counter endCounter;
+			std::vector<Counter*> reqCounters;
+		};
+		/// Executable schedule with synchronization counters
+		struct Schedule {
+			/// Schedule entries per rate phase and thread
+			std::vector<std::vector<std::vector<ScheduleEntry>>> entries;
+			/// Executions of each rate phase before the schedule was activated
+			std::vector<Int> phaseCountOffsets;
+			/// Task lists the entries were created from
+			TaskLists tasks;
+			/// Task times the schedule was created with, empty for the initial schedule
+			std::unordered_map<String, TaskTime::rep> measurements;
+		};
+
 		void doStep(Int scheduleIdx);
+		/// Number of times the phase of the step has been executed by the
+		/// active schedule including this step
+		Int phaseCount(Int timeStepCount) const {
+			return timeStepCount / static_cast<Int>(mNumRatePhases) + 1 - mSchedule->phaseCountOffsets[ratePhase(timeStepCount)];
+		}
+		/// Lets the counters of the active schedule start at zero in the given step
+		void rebase(Int timeStepCount);
 		static void threadFunction(ThreadScheduler* sched, Int idx);
 
+		/// Creates the schedule entries from the task lists
+		std::unique_ptr<Schedule> createEntries(const TaskLists& schedules, const Edges& inEdges) const;
+		/// Waits until all threads finished the last step
+		void waitForThreads();
+		/// Starts the recreation of the schedule or activates the recreated
+		/// schedule at the beginning of a step
+		void tune(Int timeStepCount);
+		/// Averaged task times measured since the last call
+		std::unordered_map<String, TaskTime::rep> collectMeasurements();
+
 		String mOutMeasurementFile;
 		Barrier mStartBarrier;
 
 		std::vector<std::thread> mThreads;
+		/// Active schedule
+		std::unique_ptr<Schedule> mSchedule;
 
-		std::vector<CPS::Task::List> mTempSchedules;
-		struct ScheduleEntry {
-			CPS::Task* task;
-			Counter endCounter;
-			std::vector<Counter*> reqCounters;
-		};
-		std::vector<ScheduleEntry*> mSchedules;
+		/// Scheduled tasks and their dependencies
+		CPS::Task::List mScheduledTasks;
+		Edges mScheduleInEdges;
+		/// Schedule recreated in the background
+		std::future<std::unique_ptr<Schedule>> mPendingSchedule;
+		/// Steps measured before the first schedule is created, 0 disables tuning
+		UInt mTuningSteps = 0;
+		/// Steps between measurements for the retuning, 0 disables retuning
+		UInt mRetunePeriod = 0;
+		/// Relative deviation of the task times that leads to a new schedule
+		Real mDriftTolerance = 0.2;
+		/// Step at which the measured times are evaluated next
+		Int mNextTuning = 0;
+		/// Activated schedules created by the online tuning
+		UInt mTunedSchedules = 0;
+		/// Measure task times in each step
+		Bool mMeasure = false;
+		/// Steps started by the main thread
+		Int mStepsStarted = 0;
+		/// Incremented by the other threads after each step
+		Counter mFinishedThreads;
 
 		Bool mJoining = false;
 		Real mTime = 0;
@@ -16,6 +16,7 @@
 #endif
 
 #include <cstdlib>
+#include <exception>
 #include <list>
 #include <vector>
 #include <experimental/filesystem>
@@ -126,5 +127,35 @@ fs::path findFile(const fs::path &name,
 std::list<fs::path> findFiles(std::list<fs::path> filennames,
 	const fs::path &hint, const std::string &useEnv = std::string());
 
+/// Number of threads used by parallelFor
+UInt maxThreads();
+/// Limit the number of threads used by parallelFor and OpenMP regions
+void setMaxThreads(UInt threads);
+
+/// Calls func(i) for i in [0, count), in parallel if OpenMP is available.
+/// Exceptions are collected and the one of the lowest index is rethrown
+/// after all calls returned.
+template<typename Func>
+void parallelFor(std::size_t count, Func func) {
+	std::vector<std::exception_ptr> errors(count);
+	Int num = static_cast<Int>(count);
+
+#ifdef WITH_OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (Int i = 0; i < num; i++) {
+		try {
+			func(static_cast<std::size_t>(i));
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+	}
+
+	for (auto& error : errors) {
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
+
 }
 }
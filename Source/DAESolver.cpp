@@ -6,6 +6,9 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+#include <limits>
+
 #include <dpsim/DAESolver.h>
 #include <cps/SimPowerComp.h>
 #include <cps/Solver/MNAInterface.h>
@@ -15,10 +18,11 @@ using namespace CPS;
 
 //#define NVECTOR_DATA(vec) NV_DATA_S (vec) // Returns pointer to the first element of array vec
 
-DAESolver::DAESolver(String name, CPS::SystemTopology system, Real dt, Real t0) :
+DAESolver::DAESolver(String name, CPS::SystemTopology system, Real dt, Real t0, LinearSolverType linearSolver) :
 	Solver(name, CPS::Logger::Level::info),
 	mSystem(system),
-	mTimestep(dt) {
+	mTimestep(dt),
+	mLinearSolverType(linearSolver) {
 
     // Defines offset vector of the residual which is composed as follows:
     // mOffset[0] = # nodal voltage equations
@@ -164,10 +168,41 @@ void DAESolver::initialize(Real t0) {
 //		throw CPS::Exception();
 //	}
     std::cout << "Call IDA Solver Stuff" << std::endl;
-    // Allocate and connect Matrix A and solver LS to IDA
-    A = SUNDenseMatrix(mNEQ, mNEQ);
-    LS = SUNDenseLinearSolver(state, A);
-    ret = IDADlsSetLinearSolver(mem, LS, A);
+#ifndef WITH_KLU
+    if (mLinearSolverType == LinearSolverType::Sparse) {
+        mSLog->warn("Sundials was built without KLU, using the preconditioned Krylov solver");
+        mLinearSolverType = LinearSolverType::Krylov;
+    }
+#endif
+    if (mLinearSolverType == LinearSolverType::Dense) {
+        // Allocate and connect Matrix A and solver LS to IDA
+        A = SUNDenseMatrix(mNEQ, mNEQ);
+        LS = SUNDenseLinearSolver(state, A);
+        ret = IDADlsSetLinearSolver(mem, LS, A);
+    } else {
+        analyzeJacobianPattern(t0, sval, s_dtval);
+        mSLog->info("Jacobian with {} nonzeros, assembled from {} residual evaluations",
+            mJacobian.nonZeros(), mColumnGroups.size());
+#ifdef WITH_KLU
+        if (mLinearSolverType == LinearSolverType::Sparse) {
+            A = SUNSparseMatrix(mNEQ, mNEQ, mJacobian.nonZeros(), CSC_MAT);
+            LS = SUNKLU(state, A);
+            ret = IDADlsSetLinearSolver(mem, LS, A);
+            ret = IDADlsSetJacFn(mem, &DAESolver::jacobianWrapper);
+        }
+#endif
+        if (mLinearSolverType == LinearSolverType::Krylov) {
+            // Jacobian-vector products are approximated by IDA
+            LS = SUNSPGMR(state, PREC_LEFT, 0);
+            ret = IDASpilsSetLinearSolver(mem, LS);
+            ret = IDASpilsSetPreconditioner(mem, &DAESolver::preconditionerSetupWrapper,
+                &DAESolver::preconditionerSolveWrapper);
+        }
+    }
+    if (ret != IDA_SUCCESS) {
+        mSLog->error("Setting up the IDA linear solver failed with {}", ret);
+        throw SolverException();
+    }
 
     //Optional IDA input functions
     //ret = IDASetMaxNumSteps(mem, -1);  //Max. number of timesteps until tout (-1 = unlimited)
@@ -184,10 +219,19 @@ int DAESolver::residualFunctionWrapper(realtype ttime, N_Vector state, N_Vector
 
 int DAESolver::residualFunction(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid)
 {
+    evaluateResidual(ttime, NV_DATA_S(state), NV_DATA_S(dstate_dt), NV_DATA_S(resid));
+
+    // If successful; positive value if recoverable error, negative if fatal error
+    // TODO: Error handling
+    return 0;
+}
+
+void DAESolver::evaluateResidual(Real time, const double state[], const double dstate_dt[], double resid[]) {
     mOffsets[0] = 0; // Reset Offset
     mOffsets[1] = 0; // Reset Offset
-    double *residual = NV_DATA_S(resid);
-    double *tempstate = NV_DATA_S(state);
+    // Components add their currents to the nodal equations
+    std::fill(resid, resid + mNEQ, 0.);
+
     // Solve for all node Voltages
     for (auto node : mNodes) {
 
@@ -196,17 +240,131 @@ int DAESolver::residualFunction(realtype ttime, N_Vector state, N_Vector dstate_
         tempVolt += std::real(node->singleVoltage());
 
 
-        residual[mOffsets[0]] = tempVolt - tempstate[mOffsets[0]];
+        resid[mOffsets[0]] = tempVolt - state[mOffsets[0]];
         mOffsets[0] += 1;
     }
 
     // Call all registered component residual functions
     for (auto resFn : mResidualFunctions) {
-        resFn(ttime, NV_DATA_S(state), NV_DATA_S(dstate_dt), NV_DATA_S(resid), mOffsets);
+        resFn(time, state, dstate_dt, resid, mOffsets);
     }
+}
 
-    // If successful; positive value if recoverable error, negative if fatal error
-    // TODO: Error handling
+void DAESolver::analyzeJacobianPattern(Real time, const double state[], const double dstate_dt[]) {
+    std::vector<double> y(state, state + mNEQ), yp(dstate_dt, dstate_dt + mNEQ);
+    std::vector<double> base(mNEQ), perturbed(mNEQ);
+    evaluateResidual(time, y.data(), yp.data(), base.data());
+
+    // A residual depends on a state if it changes when the state or its
+    // derivative is perturbed. The diagonal is always kept.
+    std::vector<std::vector<Int>> rows(mNEQ);
+    for (Int j = 0; j < mNEQ; j++) {
+        std::vector<Bool> depends(mNEQ, false);
+        depends[j] = true;
+        for (auto vec : { &y, &yp }) {
+            Real orig = (*vec)[j];
+            (*vec)[j] += 1e-3 * std::max(1., std::abs(orig));
+            evaluateResidual(time, y.data(), yp.data(), perturbed.data());
+            (*vec)[j] = orig;
+            for (Int i = 0; i < mNEQ; i++)
+                if (perturbed[i] != base[i])
+                    depends[i] = true;
+        }
+        for (Int i = 0; i < mNEQ; i++)
+            if (depends[i])
+                rows[j].push_back(i);
+    }
+
+    std::vector<Eigen::Triplet<Real>> entries;
+    for (Int j = 0; j < mNEQ; j++)
+        for (auto i : rows[j])
+            entries.push_back(Eigen::Triplet<Real>(i, j, 1.));
+    mJacobian.resize(mNEQ, mNEQ);
+    mJacobian.setFromTriplets(entries.begin(), entries.end());
+    mJacobian.makeCompressed();
+    mJacobianLU.analyzePattern(mJacobian);
+
+    // Greedy grouping of columns that do not share a row, so that each
+    // group needs a single residual evaluation
+    mColumnGroups.clear();
+    std::vector<std::vector<Bool>> usedRows;
+    for (Int j = 0; j < mNEQ; j++) {
+        UInt group = 0;
+        for (; group < mColumnGroups.size(); group++) {
+            Bool conflict = false;
+            for (auto i : rows[j])
+                conflict = conflict || usedRows[group][i];
+            if (!conflict)
+                break;
+        }
+        if (group == mColumnGroups.size()) {
+            mColumnGroups.push_back(std::vector<Int>());
+            usedRows.push_back(std::vector<Bool>(mNEQ, false));
+        }
+        mColumnGroups[group].push_back(j);
+        for (auto i : rows[j])
+            usedRows[group][i] = true;
+    }
+
+    mPerturbedState.resize(mNEQ);
+    mPerturbedDerivative.resize(mNEQ);
+    mPerturbedResidual.resize(mNEQ);
+}
+
+void DAESolver::assembleJacobian(Real time, Real cj, const double state[], const double dstate_dt[], const double resid[]) {
+    const Real eps = std::sqrt(std::numeric_limits<Real>::epsilon());
+
+    for (auto& group : mColumnGroups) {
+        std::copy(state, state + mNEQ, mPerturbedState.begin());
+        std::copy(dstate_dt, dstate_dt + mNEQ, mPerturbedDerivative.begin());
+        for (auto j : group) {
+            Real h = eps * std::max(1., std::abs(state[j]));
+            mPerturbedState[j] += h;
+            mPerturbedDerivative[j] += cj * h;
+        }
+        evaluateResidual(time, mPerturbedState.data(), mPerturbedDerivative.data(), mPerturbedResidual.data());
+
+        // Columns of a group have disjoint rows
+        for (auto j : group) {
+            Real h = mPerturbedState[j] - state[j];
+            for (SparseMatrix::InnerIterator it(mJacobian, j); it; ++it)
+                it.valueRef() = (mPerturbedResidual[it.row()] - resid[it.row()]) / h;
+        }
+    }
+}
+
+int DAESolver::jacobianWrapper(realtype ttime, realtype cj, N_Vector state, N_Vector dstate_dt, N_Vector resid,
+    SUNMatrix jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3) {
+#ifdef WITH_KLU
+    DAESolver *self = reinterpret_cast<DAESolver *>(user_data);
+    self->assembleJacobian(ttime, cj, NV_DATA_S(state), NV_DATA_S(dstate_dt), NV_DATA_S(resid));
+
+    // Both matrices are stored column-wise with the same pattern
+    const SparseMatrix& J = self->mJacobian;
+    std::copy(J.outerIndexPtr(), J.outerIndexPtr() + J.outerSize() + 1, SUNSparseMatrix_IndexPointers(jac));
+    std::copy(J.innerIndexPtr(), J.innerIndexPtr() + J.nonZeros(), SUNSparseMatrix_IndexValues(jac));
+    std::copy(J.valuePtr(), J.valuePtr() + J.nonZeros(), SUNSparseMatrix_Data(jac));
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int DAESolver::preconditionerSetupWrapper(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid,
+    realtype cj, void *user_data) {
+    DAESolver *self = reinterpret_cast<DAESolver *>(user_data);
+    self->assembleJacobian(ttime, cj, NV_DATA_S(state), NV_DATA_S(dstate_dt), NV_DATA_S(resid));
+    self->mJacobianLU.factorize(self->mJacobian);
+    // A positive value lets IDA retry with a smaller step
+    return self->mJacobianLU.info() == Eigen::Success ? 0 : 1;
+}
+
+int DAESolver::preconditionerSolveWrapper(realtype ttime, N_Vector state, N_Vector dstate_dt, N_Vector resid,
+    N_Vector rvec, N_Vector zvec, realtype cj, realtype delta, void *user_data) {
+    DAESolver *self = reinterpret_cast<DAESolver *>(user_data);
+    Eigen::Map<Vector> r(NV_DATA_S(rvec), self->mNEQ);
+    Eigen::Map<Vector> z(NV_DATA_S(zvec), self->mNEQ);
+    z = self->mJacobianLU.solve(r);
     return 0;
 }
 
@@ -217,6 +375,10 @@ Real DAESolver::step(Real time) {
     int ret = IDASolve(mem, NextTime, &tret, state, dstate_dt, IDA_NORMAL);  // TODO: find alternative to IDA_NORMAL
 
     if (ret == IDA_SUCCESS) {
+        // The nodal voltages are the first entries of the state vector
+        realtype *sval = N_VGetArrayPointer_Serial(state);
+        for (std::size_t n = 0; n < mNodes.size(); n++)
+            mNodes[n]->setVoltage(Complex(sval[n], 0));
         return NextTime;
     }
     else {
@@ -241,5 +403,6 @@ DAESolver::~DAESolver() {
     N_VDestroy(state);
     N_VDestroy(dstate_dt);
     SUNLinSolFree(LS);
-    SUNMatDestroy(A);
+    if (A)
+        SUNMatDestroy(A);
 }
@@ -127,28 +127,81 @@ void DataLogger::logEMTNodeValues(Real time, const Matrix& data) {
 	logDataLine(time, data);
 }
 
-void DataLogger::log(Real time, Int timeStepCount) {
-	if (!mEnabled || !(timeStepCount % mDownsampling == 0))
-		return;
-
+void DataLogger::logHeader() {
 	if (mLogFile.tellp() == std::ofstream::pos_type(0)) {
 		mLogFile << std::right << std::setw(14) << "time";
 		for (auto it : mAttributes)
 			mLogFile << ", " << std::right << std::setw(13) << it.first;
 		mLogFile << '\n';
 	}
+}
+
+void DataLogger::log(Real time, Int timeStepCount) {
+	if (!mEnabled || !(timeStepCount % mDownsampling == 0))
+		return;
 
+	logHeader();
 	mLogFile << std::scientific << std::right << std::setw(14) << time;
 	for (auto it : mAttributes)
 		mLogFile << ", " << std::right << std::setw(13) << it.second->toString();
 	mLogFile << '\n';
 }
 
+void DataLogger::resolveColumns() {
+	mColumns.clear();
+	mRealColumns.clear();
+	mIntColumns.clear();
+	for (auto it : mAttributes) {
+		mColumns.push_back(it.second);
+		mRealColumns.push_back(std::dynamic_pointer_cast<CPS::Attribute<Real>>(it.second));
+		mIntColumns.push_back(std::dynamic_pointer_cast<CPS::Attribute<Int>>(it.second));
+	}
+}
+
+void DataLogger::snapshot(UInt buffer, Real time, Int timeStepCount) {
+	auto& snap = mSnapshots[buffer];
+	snap.logged = mEnabled && timeStepCount % mDownsampling == 0;
+	if (!snap.logged)
+		return;
+
+	snap.time = time;
+	snap.values.resize(mColumns.size());
+	snap.texts.clear();
+	for (UInt col = 0; col < mColumns.size(); col++) {
+		if (mRealColumns[col])
+			snap.values[col] = mRealColumns[col]->getByValue();
+		else if (mIntColumns[col])
+			snap.values[col] = mIntColumns[col]->getByValue();
+		else
+			snap.texts.push_back(mColumns[col]->toString());
+	}
+}
+
+void DataLogger::writeSnapshot(UInt buffer) {
+	auto& snap = mSnapshots[buffer];
+	if (!snap.logged)
+		return;
+
+	logHeader();
+	mLogFile << std::scientific << std::right << std::setw(14) << snap.time;
+	auto text = snap.texts.begin();
+	for (UInt col = 0; col < snap.values.size(); col++) {
+		// Same formatting as the toString() of the attributes
+		String value = mRealColumns[col] ? std::to_string(snap.values[col])
+			: mIntColumns[col] ? std::to_string(static_cast<Int>(snap.values[col]))
+			: *text++;
+		mLogFile << ", " << std::right << std::setw(13) << value;
+	}
+	mLogFile << '\n';
+}
+
 void DataLogger::Step::execute(Real time, Int timeStepCount) {
 	mLogger.log(time, timeStepCount);
 }
 
 CPS::Task::Ptr DataLogger::getTask() {
+	// The downsampling is checked in each step instead of using a rate
+	// divisor, which would multiply the schedules of all tasks
 	return std::make_shared<DataLogger::Step>(*this);
 }
 
@@ -6,6 +6,15 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
 #include <dpsim/Event.h>
 
 using namespace DPsim;
@@ -15,16 +24,251 @@ void EventQueue::addEvent(Event::Ptr e) {
 	mEvents.push(e);
 }
 
-void EventQueue::handleEvents(Real currentTime) {
-	Event::Ptr e;
+UInt EventQueue::handleEvents(Real currentTime) {
+	UInt handled = 0;
 
 	while (!mEvents.empty()) {
-		e = mEvents.top();
+		const Event::Ptr& e = mEvents.top();
 		if (e->mTime >= currentTime)
 			break;
 
 		e->execute();
-		std::cout << currentTime << ": Handle event" << std::endl;
 		mEvents.pop();
+		handled++;
+	}
+	return handled;
+}
+
+Real EventQueue::nextEventTime() {
+	if (mEvents.empty())
+		return std::numeric_limits<Real>::infinity();
+
+	return mEvents.top()->mTime;
+}
+
+EventWheel::EventWheel(Real timeStep, UInt numSlots) :
+	mTimeStep(timeStep), mSlots(numSlots > 0 ? numSlots : 1) {
+	if (timeStep <= 0)
+		throw SystemError("Event wheel requires a positive time step");
+}
+
+UInt EventWheel::addTarget(const String& name, Target target) {
+	if (mTargetIndices.count(name))
+		throw SystemError("Event target " + name + " already exists");
+
+	UInt idx = static_cast<UInt>(mTargets.size());
+	mTargets.push_back(target);
+	mTargetIndices[name] = idx;
+	return idx;
+}
+
+UInt EventWheel::addTarget(const String& name, Attribute<Real>::Ptr attr) {
+	return addTarget(name, Target{attr, nullptr, nullptr});
+}
+
+UInt EventWheel::addTarget(const String& name, std::shared_ptr<Base::Ph1::Switch> sw) {
+	return addTarget(name, Target{nullptr, sw, nullptr});
+}
+
+UInt EventWheel::addTarget(const String& name, std::shared_ptr<Base::Ph3::Switch> sw) {
+	return addTarget(name, Target{nullptr, nullptr, sw});
+}
+
+UInt EventWheel::targetIndex(const String& name) const {
+	auto it = mTargetIndices.find(name);
+	if (it == mTargetIndices.end())
+		throw SystemError("Unknown event target " + name);
+	return it->second;
+}
+
+long long EventWheel::eventStep(Real time) const {
+	// Tolerate rounding errors for events at multiples of the time step
+	return static_cast<long long>(std::floor(time / mTimeStep + 1e-9)) + 1;
+}
+
+void EventWheel::addEvent(Real time, UInt target, Real value) {
+	if (target >= mTargets.size())
+		throw SystemError("Unknown event target index " + std::to_string(target));
+
+	// Events in the past are applied in the next step
+	long long step = std::max(eventStep(time), mCurrentStep);
+	if (step < mCurrentStep + static_cast<long long>(mSlots.size())) {
+		mSlots[step % mSlots.size()].push_back({target, value});
+		mWheelEvents++;
+	} else {
+		if (mFarSorted && mFarEvents.size() > mFarPos && mFarEvents.back().step > step)
+			mFarSorted = false;
+		mFarEvents.push_back({step, {target, value}});
+	}
+}
+
+void EventWheel::sortFarEvents() {
+	if (!mFarSorted) {
+		std::stable_sort(mFarEvents.begin() + mFarPos, mFarEvents.end(),
+			[](const FarEntry& a, const FarEntry& b) { return a.step < b.step; });
+		mFarSorted = true;
+	}
+}
+
+void EventWheel::refillWheel() {
+	sortFarEvents();
+
+	long long end = mCurrentStep + static_cast<long long>(mSlots.size());
+	while (mFarPos < mFarEvents.size() && mFarEvents[mFarPos].step < end) {
+		auto& far = mFarEvents[mFarPos++];
+		mSlots[far.step % mSlots.size()].push_back(far.entry);
+		mWheelEvents++;
+	}
+
+	if (mFarPos == mFarEvents.size()) {
+		mFarEvents.clear();
+		mFarPos = 0;
+	}
+}
+
+UInt EventWheel::handleEvents(Real currentTime) {
+	// Step index of the current time, events of this step are applied as well
+	long long step = static_cast<long long>(std::floor(currentTime / mTimeStep + 0.5));
+	UInt handled = 0;
+
+	while (mCurrentStep <= step) {
+		// Slots keep their capacity, so the wheel does not allocate after warm-up
+		auto& slot = mSlots[mCurrentStep % mSlots.size()];
+		for (auto& entry : slot)
+			apply(entry);
+		handled += static_cast<UInt>(slot.size());
+		mWheelEvents -= slot.size();
+		slot.clear();
+		mCurrentStep++;
+
+		// Skip empty steps if the wheel is empty
+		if (mWheelEvents == 0 && mCurrentStep <= step) {
+			sortFarEvents();
+			if (mFarPos == mFarEvents.size())
+				mCurrentStep = step + 1;
+			else
+				mCurrentStep = std::min(step + 1, mFarEvents[mFarPos].step);
+		}
+
+		// Events beyond the wheel always have to be later than the
+		// events in the wheel, so that events of a step keep their order
+		if (mFarPos < mFarEvents.size())
+			refillWheel();
+	}
+	return handled;
+}
+
+std::size_t EventWheel::pendingEvents() const {
+	return mWheelEvents + mFarEvents.size() - mFarPos;
+}
+
+void EventWheel::loadCSV(const String& filename) {
+	std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
+	if (!file.is_open())
+		throw SystemError("Cannot open event file " + filename);
+
+	String content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	const char *pos = content.c_str();
+	const char *end = pos + content.size();
+	std::size_t lineNum = 0;
+	String name;
+
+	while (pos < end) {
+		const char *lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+		if (!lineEnd)
+			lineEnd = end;
+		lineNum++;
+
+		const char *sep1 = static_cast<const char*>(std::memchr(pos, ',', lineEnd - pos));
+		const char *sep2 = sep1 ? static_cast<const char*>(std::memchr(sep1 + 1, ',', lineEnd - sep1 - 1)) : nullptr;
+		if (sep2) {
+			char *numEnd;
+			Real time = std::strtod(pos, &numEnd);
+			// Lines without a numeric time, like a header, are skipped
+			if (numEnd != pos) {
+				name.assign(sep1 + 1, sep2);
+				Real value = std::strtod(sep2 + 1, &numEnd);
+				if (numEnd == sep2 + 1)
+					throw SystemError("Invalid value in line " + std::to_string(lineNum) + " of " + filename);
+				addEvent(time, targetIndex(name), value);
+			}
+		}
+		else if (lineEnd - pos > 1)
+			throw SystemError("Invalid line " + std::to_string(lineNum) + " in " + filename);
+
+		pos = lineEnd + 1;
+	}
+}
+
+// Binary files start with a header of magic, format version and number
+// of events followed by records of event time, target index and value.
+// All fields have a fixed width in the byte order of the machine.
+static const std::uint32_t eventFileMagic = 0x56455044; // "DPEV"
+static const std::uint32_t eventFileVersion = 1;
+static const std::size_t eventHeaderSize = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+static const std::size_t eventRecordSize = sizeof(double) + sizeof(std::uint32_t) + sizeof(double);
+
+void EventWheel::saveBinary(const String& filename) const {
+	std::ofstream file(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!file.is_open())
+		throw SystemError("Cannot open event file " + filename);
+
+	auto writeEvent = [&file](Real time, const Entry& entry) {
+		double fileTime = time, value = entry.value;
+		std::uint32_t target = static_cast<std::uint32_t>(entry.target);
+		file.write(reinterpret_cast<const char*>(&fileTime), sizeof(fileTime));
+		file.write(reinterpret_cast<const char*>(&target), sizeof(target));
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+
+	std::uint64_t count = pendingEvents();
+	file.write(reinterpret_cast<const char*>(&eventFileMagic), sizeof(eventFileMagic));
+	file.write(reinterpret_cast<const char*>(&eventFileVersion), sizeof(eventFileVersion));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+	// Store the time in the middle of the step before the one the event is applied in
+	for (std::size_t i = 0; i < mSlots.size(); i++) {
+		long long step = mCurrentStep + static_cast<long long>(i);
+		for (auto& entry : mSlots[step % mSlots.size()])
+			writeEvent((step - 0.5) * mTimeStep, entry);
+	}
+	for (std::size_t i = mFarPos; i < mFarEvents.size(); i++)
+		writeEvent((mFarEvents[i].step - 0.5) * mTimeStep, mFarEvents[i].entry);
+}
+
+void EventWheel::loadBinary(const String& filename) {
+	std::ifstream file(filename, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+	if (!file.is_open())
+		throw SystemError("Cannot open event file " + filename);
+	std::streamoff fileSize = file.tellg();
+	file.seekg(0);
+
+	std::uint32_t magic = 0, version = 0;
+	std::uint64_t count = 0;
+	file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	file.read(reinterpret_cast<char*>(&count), sizeof(count));
+	if (!file || magic != eventFileMagic)
+		throw SystemError("Invalid event file " + filename);
+	if (version != eventFileVersion)
+		throw SystemError("Unsupported version " + std::to_string(version) + " of event file " + filename);
+
+	// The count is checked before anything is allocated for it
+	std::uint64_t dataSize = static_cast<std::uint64_t>(fileSize) - eventHeaderSize;
+	if (count != dataSize / eventRecordSize || dataSize % eventRecordSize != 0)
+		throw SystemError("Event file " + filename + " does not contain " + std::to_string(count) + " events");
+
+	std::vector<char> records(static_cast<std::size_t>(dataSize));
+	file.read(records.data(), records.size());
+	if (static_cast<std::size_t>(file.gcount()) != records.size())
+		throw SystemError("Event file " + filename + " is truncated");
+
+	for (const char *rec = records.data(); rec < records.data() + records.size(); rec += eventRecordSize) {
+		double time, value;
+		std::uint32_t target;
+		std::memcpy(&time, rec, sizeof(time));
+		std::memcpy(&target, rec + sizeof(time), sizeof(target));
+		std::memcpy(&value, rec + sizeof(time) + sizeof(target), sizeof(value));
+		addEvent(time, target, value);
 	}
 }
@@ -144,6 +144,42 @@ void Interface::writeValues() {
 	}
 }
 
+void Interface::snapshotValues(UInt buffer, Real time, Int timeStepCount) {
+	Sample *sample = nullptr;
+	if (timeStepCount % mDownsampling == 0) {
+		if (shmem_int_alloc(&mShmem, &sample, 1) < 1) {
+			mLog->error("Fatal error: pool underrun in: {} <-> {} at sequence no {}", mWName, mRName, mSequence);
+			close();
+			std::exit(1);
+		}
+
+		for (auto exp : mExports) {
+			exp(sample);
+		}
+
+		sample->sequence = mSequence++;
+		sample->flags |= (int) SampleFlags::HAS_DATA;
+		clock_gettime(CLOCK_REALTIME, &sample->ts.origin);
+	}
+	mSnapshotSamples[buffer] = sample;
+}
+
+void Interface::writeSnapshot(UInt buffer) {
+	Sample *sample = mSnapshotSamples[buffer];
+	if (!sample)
+		return;
+
+	Int ret = 0;
+	do {
+		ret = shmem_int_write(&mShmem, &sample, 1);
+	} while (ret == 0);
+	if (ret < 0)
+		mLog->error("Failed to write samples to interface");
+
+	sample_copy(mLastSample, sample);
+	mSnapshotSamples[buffer] = nullptr;
+}
+
 void Interface::PreStep::execute(Real time, Int timeStepCount) {
 	if (timeStepCount % mIntf.mDownsampling == 0)
 		mIntf.readValues(mIntf.mSync);
@@ -283,6 +319,7 @@ void Interface::exportComplex(Attribute<Complex>::Ptr attr, UInt idx) {
 }
 
 Task::List Interface::getTasks() {
+	// The downsampling is checked in each step, see DataLogger::getTask
 	return Task::List({
 		std::make_shared<Interface::PreStep>(*this),
 		std::make_shared<Interface::PostStep>(*this)
@@ -0,0 +1,282 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <chrono>
+#include <limits>
+
+#include <dpsim/MNAFactorization.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+constexpr Real MnaFactorization::mRefinementTolerance;
+constexpr Real MnaFactorization::mProbeTolerance;
+const UInt MnaFactorization::maxInverseSize;
+const std::size_t MnaFactorization::maxInverseMemory;
+
+Bool MnaFactorization::inverseFits(UInt size, std::size_t numStates) {
+	std::size_t bytes = sizeof(Real) * std::size_t(size) * size;
+	return size <= maxInverseSize && (bytes == 0 || numStates <= maxInverseMemory / bytes);
+}
+
+Bool MnaFactorization::complexSystem(const Matrix& sys, MatrixComp& complexSys) {
+	if (sys.rows() % 2 != 0 || sys.rows() != sys.cols())
+		return false;
+
+	Eigen::Index n = sys.rows() / 2;
+	if (sys.topLeftCorner(n, n) != sys.bottomRightCorner(n, n)
+		|| sys.topRightCorner(n, n) != -sys.bottomLeftCorner(n, n))
+		return false;
+
+	complexSys.resize(n, n);
+	complexSys.real() = sys.topLeftCorner(n, n);
+	complexSys.imag() = sys.bottomLeftCorner(n, n);
+	return true;
+}
+
+Bool MnaFactorization::isSymmetric(const Matrix& sys) {
+	if (sys.rows() != sys.cols() || sys.size() == 0)
+		return false;
+	return (sys - sys.transpose()).cwiseAbs().maxCoeff() <= 1e-14 * sys.cwiseAbs().maxCoeff();
+}
+
+Bool MnaFactorization::probeSolve(const Matrix& sys) {
+	Matrix probe = Matrix::Ones(sys.rows(), 1);
+	Matrix rightSide = sys * probe, solution;
+	solve(rightSide, solution);
+	Real norm = sys.cwiseAbs().rowwise().sum().maxCoeff();
+	return (rightSide - sys * solution).lpNorm<Eigen::Infinity>()
+		<= mProbeTolerance * (norm * solution.lpNorm<Eigen::Infinity>() + rightSide.lpNorm<Eigen::Infinity>());
+}
+
+void MnaFactorization::reset() {
+	mMethod = Solver::Factorization::LU;
+	mLU = CPS::LUFactorized();
+	mComplexLU = Eigen::PartialPivLU<MatrixComp>();
+	mSingleLU = Eigen::PartialPivLU<Eigen::MatrixXf>();
+	mSystem = nullptr;
+	mLLT = Eigen::LLT<Matrix>();
+	mLDLT = Eigen::LDLT<Matrix>();
+	mInverse.resize(0, 0);
+}
+
+void MnaFactorization::compute(const MatrixComp& sys) {
+	reset();
+	mComplexLU.compute(sys);
+	mComplexRightSide.resize(sys.rows(), 1);
+	mComplexSolution.resize(sys.rows(), 1);
+	mMethod = Solver::Factorization::ComplexLU;
+}
+
+void MnaFactorization::compute(const Matrix& sys, Solver::Factorization method) {
+	reset();
+
+	if (method == Solver::Factorization::ComplexLU) {
+		MatrixComp complexSys;
+		if (complexSystem(sys, complexSys)) {
+			compute(complexSys);
+			return;
+		}
+	}
+	else if (method == Solver::Factorization::MixedPrecision) {
+		mSingleLU.compute(sys.cast<float>());
+		mSystem = &sys;
+		mSystemNorm = sys.cwiseAbs().rowwise().sum().maxCoeff();
+		mResidual.resize(sys.rows(), 1);
+		mSingleRightSide.resize(sys.rows());
+		mSingleCorrection.resize(sys.rows());
+
+		// Ill-conditioned systems are detected with a known solution
+		// before the simulation relies on the single precision factors
+		Matrix probe = Matrix::Ones(sys.rows(), 1), solution;
+		if (solveMixedPrecision(sys * probe, solution)) {
+			mMethod = Solver::Factorization::MixedPrecision;
+			return;
+		}
+		mSingleLU = Eigen::PartialPivLU<Eigen::MatrixXf>();
+		mSystem = nullptr;
+	}
+	else if (method == Solver::Factorization::Symmetric && isSymmetric(sys)) {
+		// Networks without sources are usually positive definite, voltage
+		// sources and other virtual nodes make the system indefinite
+		mLLT.compute(sys);
+		mPositiveDefinite = mLLT.info() == Eigen::Success;
+		if (!mPositiveDefinite) {
+			mLLT = Eigen::LLT<Matrix>();
+			mLDLT.compute(sys);
+		}
+		mMethod = Solver::Factorization::Symmetric;
+		// LDLT only pivots on the diagonal and can be unstable
+		if (probeSolve(sys))
+			return;
+		mLLT = Eigen::LLT<Matrix>();
+		mLDLT = Eigen::LDLT<Matrix>();
+		mMethod = Solver::Factorization::LU;
+	}
+	else if (method == Solver::Factorization::Inverse) {
+		mLU.compute(sys);
+		mInverse = mLU.inverse();
+		mMethod = Solver::Factorization::Inverse;
+		// The explicit inverse amplifies rounding errors of
+		// ill-conditioned systems
+		if (probeSolve(sys)) {
+			mLU = CPS::LUFactorized();
+			return;
+		}
+		mInverse.resize(0, 0);
+		mMethod = Solver::Factorization::LU;
+		return;
+	}
+
+	mLU.compute(sys);
+}
+
+Bool MnaFactorization::solveMixedPrecision(const Matrix& rightSide, Matrix& solution) {
+	mSingleRightSide = rightSide.col(0).cast<float>();
+	mSingleCorrection = mSingleLU.solve(mSingleRightSide);
+	solution = mSingleCorrection.cast<Real>();
+	Real rightSideNorm = rightSide.lpNorm<Eigen::Infinity>();
+
+	for (UInt step = 0; ; step++) {
+		mResidual = rightSide;
+		mResidual.noalias() -= *mSystem * solution;
+		Real residualNorm = mResidual.lpNorm<Eigen::Infinity>();
+		if (!std::isfinite(residualNorm))
+			return false;
+		if (residualNorm <= mRefinementTolerance * (mSystemNorm * solution.lpNorm<Eigen::Infinity>() + rightSideNorm))
+			return true;
+		if (step == mMaxRefinementSteps)
+			return false;
+
+		// Scale the residual to stay in the range of single precision
+		mSingleRightSide = (mResidual.col(0) / residualNorm).cast<float>();
+		mSingleCorrection = mSingleLU.solve(mSingleRightSide);
+		solution += residualNorm * mSingleCorrection.cast<Real>();
+	}
+}
+
+void MnaFactorization::solve(const Matrix& rightSide, Matrix& solution) {
+	if (mMethod == Solver::Factorization::ComplexLU) {
+		Eigen::Index n = mComplexRightSide.rows();
+		mComplexRightSide.real() = rightSide.topRows(n);
+		mComplexRightSide.imag() = rightSide.bottomRows(n);
+		mComplexSolution = mComplexLU.solve(mComplexRightSide);
+		solution.resize(rightSide.rows(), 1);
+		solution.topRows(n) = mComplexSolution.real();
+		solution.bottomRows(n) = mComplexSolution.imag();
+	}
+	else if (mMethod == Solver::Factorization::MixedPrecision) {
+		if (solveMixedPrecision(rightSide, solution))
+			return;
+
+		// Continue in double precision for this and all later steps
+		mLU.compute(*mSystem);
+		mSingleLU = Eigen::PartialPivLU<Eigen::MatrixXf>();
+		mSystem = nullptr;
+		mMethod = Solver::Factorization::LU;
+		solution = mLU.solve(rightSide);
+	}
+	else if (mMethod == Solver::Factorization::Inverse) {
+		solution.noalias() = mInverse * rightSide;
+	}
+	else if (mMethod == Solver::Factorization::Symmetric) {
+		if (mPositiveDefinite)
+			solution = mLLT.solve(rightSide);
+		else
+			solution = mLDLT.solve(rightSide);
+	}
+	else {
+		solution = mLU.solve(rightSide);
+	}
+}
+
+String MnaFactorization::methodName(Solver::Factorization method) {
+	switch (method) {
+		case Solver::Factorization::LU: return "LU";
+		case Solver::Factorization::ComplexLU: return "complex LU";
+		case Solver::Factorization::MixedPrecision: return "mixed precision LU";
+		case Solver::Factorization::Symmetric: return "symmetric";
+		case Solver::Factorization::Inverse: return "inverse";
+		case Solver::Factorization::Auto: return "automatic";
+	}
+	return "unknown";
+}
+
+Solver::Factorization MnaFactorization::select(const Matrix& sys, std::size_t numStates, UInt numSteps, CPS::Logger::Log log) {
+	using Clock = std::chrono::steady_clock;
+	UInt size = static_cast<UInt>(sys.rows());
+	Real density = sys.size() > 0 ? Real((sys.array() != 0).count()) / sys.size() : 0;
+	Bool symmetric = isSymmetric(sys);
+	MatrixComp complexSys;
+	Bool complex = complexSystem(sys, complexSys);
+
+	log->info("Selecting factorization for {} switch states of size {} and {} steps: {:.1f}% nonzeros, {}symmetric, {}phasor structure",
+		numStates, size, numSteps, 100 * density, symmetric ? "" : "not ", complex ? "" : "no ");
+
+	std::vector<Solver::Factorization> candidates = {
+		Solver::Factorization::LU, Solver::Factorization::MixedPrecision };
+	if (complex)
+		candidates.push_back(Solver::Factorization::ComplexLU);
+	if (symmetric)
+		candidates.push_back(Solver::Factorization::Symmetric);
+	if (inverseFits(size, numStates))
+		candidates.push_back(Solver::Factorization::Inverse);
+	else
+		log->info("Skipping inverse: exceeds size or memory limit");
+
+	// The factorization is computed once per switch state during
+	// initialization, the solve runs in every step. Both are timed
+	// repeatedly and the fastest run is taken to suppress outliers.
+	// The right side has the magnitude of a real excitation.
+	Matrix rightSide = sys * Matrix::Ones(size, 1), solution;
+	Solver::Factorization best = Solver::Factorization::LU;
+	Real bestCost = std::numeric_limits<Real>::infinity();
+	for (auto method : candidates) {
+		MnaFactorization factorization;
+		Real computeTime = std::numeric_limits<Real>::infinity();
+		for (UInt run = 0; run < 3; run++) {
+			auto start = Clock::now();
+			factorization.compute(sys, method);
+			computeTime = std::min(computeTime,
+				std::chrono::duration<Real>(Clock::now() - start).count());
+		}
+		if (factorization.method() != method) {
+			log->info("Skipping {}: not applicable to this system", methodName(method));
+			continue;
+		}
+
+		// Each batch repeats the solve for at least 1 ms
+		factorization.solve(rightSide, solution);
+		Real solveTime = std::numeric_limits<Real>::infinity();
+		for (UInt batch = 0; batch < 5; batch++) {
+			UInt runs = 0;
+			Real batchTime = 0;
+			auto start = Clock::now();
+			do {
+				factorization.solve(rightSide, solution);
+				runs++;
+				batchTime = std::chrono::duration<Real>(Clock::now() - start).count();
+			} while (batchTime < 1e-3 && runs < 1000);
+			solveTime = std::min(solveTime, batchTime / runs);
+		}
+
+		Real cost = numSteps > 0
+			? numStates * computeTime + numSteps * solveTime
+			: solveTime;
+		log->info("Candidate {}: {:.3g} s factorization per state, {:.3g} s per solve, estimated {:.3g} s",
+			methodName(method), computeTime, solveTime, cost);
+		if (cost < bestCost) {
+			best = method;
+			bestCost = cost;
+		}
+	}
+
+	log->info("Selected {} factorization with the lowest estimated {}", methodName(best),
+		numSteps > 0 ? "total time" : "solve time");
+	return best;
+}
@@ -9,6 +9,7 @@
 
 #include <dpsim/MNASolver.h>
 #include <dpsim/SequentialScheduler.h>
+#include <dpsim/Utils.h>
 
 using namespace DPsim;
 using namespace CPS;
@@ -44,6 +45,20 @@ void MnaSolver<VarType>::initialize() {
 	// We need to differentiate between power and signal components and
 	// ground nodes should be ignored.
 	identifyTopologyObjects();
+	if (!mTimeStepLevels.empty()) {
+		// Time step changes are applied by restamping the system matrix
+		if (mFrequencyParallel || mSimSignalComps.size() > 0) {
+			mSLog->error("Adaptive time step is not supported with frequency parallelization or signal components");
+			throw SolverException();
+		}
+		for (auto comp : mMNAComponents) {
+			if (!comp->mnaSupportsTimeStepUpdate()) {
+				auto idObj = std::dynamic_pointer_cast<IdentifiedObject>(comp);
+				mSLog->error("Component {:s} does not support adaptive time steps", idObj->name());
+				throw SolverException();
+			}
+		}
+	}
 	// These steps complete the network information.
 	createVirtualNodes();
 	assignMatrixNodeIndices();
@@ -94,26 +109,33 @@ void MnaSolver<VarType>::initialize() {
 template <>
 void MnaSolver<Real>::initializeComponents() {
 	mSLog->info("-- Initialize components from power flow");
-	for (auto comp : mMNAComponents) {
-		auto pComp = std::dynamic_pointer_cast<SimPowerComp<Real>>(comp);
-		if (!pComp)	continue;
-		pComp->initializeFromPowerflow(mSystem.mSystemFrequency);
-	}
+	// Components only depend on the power flow results of their nodes
+	Utils::parallelFor(mMNAComponents.size(), [this](std::size_t i) {
+		auto pComp = std::dynamic_pointer_cast<SimPowerComp<Real>>(mMNAComponents[i]);
+		if (pComp)
+			pComp->initializeFromPowerflow(mSystem.mSystemFrequency);
+	});
 
 	// Initialize signal components.
+	// Components executed at a lower rate integrate with a larger time step.
 	for (auto comp : mSimSignalComps)
-		comp->initialize(mSystem.mSystemOmega, mTimeStep);
+		comp->initialize(mSystem.mSystemOmega, mTimeStep * comp->rateDivisor());
 
 	// Initialize MNA specific parts of components.
+	// Components only initialize their own states and tasks.
+	auto leftVector = attribute<Matrix>("left_vector");
+	Utils::parallelFor(mMNAComponents.size(), [&](std::size_t i) {
+		mMNAComponents[i]->mnaInitialize(mSystem.mSystemOmega, mTimeStep, leftVector);
+	});
+	Utils::parallelFor(mSwitches.size(), [&](std::size_t i) {
+		mSwitches[i]->mnaInitialize(mSystem.mSystemOmega, mTimeStep, leftVector);
+	});
 	for (auto comp : mMNAComponents) {
-		comp->mnaInitialize(mSystem.mSystemOmega, mTimeStep, attribute<Matrix>("left_vector"));
 		const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
 		if (stamp.size() != 0) {
 			mRightVectorStamps.push_back(&stamp);
 		}
 	}
-	for (auto comp : mSwitches)
-		comp->mnaInitialize(mSystem.mSystemOmega, mTimeStep, attribute<Matrix>("left_vector"));
 }
 
 template <>
@@ -121,25 +143,25 @@ void MnaSolver<Complex>::initializeComponents() {
 	mSLog->info("-- Initialize components from power flow");
 
 	// Initialize power components with frequencies and from powerflow results
-	for (auto comp : mMNAComponents) {
-		auto pComp = std::dynamic_pointer_cast<SimPowerComp<Complex>>(comp);
-		if (!pComp)	continue;
-		pComp->initializeFromPowerflow(mSystem.mSystemFrequency);
-	}
+	// Components only depend on the power flow results of their nodes
+	Utils::parallelFor(mMNAComponents.size(), [this](std::size_t i) {
+		auto pComp = std::dynamic_pointer_cast<SimPowerComp<Complex>>(mMNAComponents[i]);
+		if (pComp)
+			pComp->initializeFromPowerflow(mSystem.mSystemFrequency);
+	});
 
 	// Initialize signal components.
+	// Components executed at a lower rate integrate with a larger time step.
 	for (auto comp : mSimSignalComps)
-		comp->initialize(mSystem.mSystemOmega, mTimeStep);
+		comp->initialize(mSystem.mSystemOmega, mTimeStep * comp->rateDivisor());
 
 	mSLog->info("-- Initialize MNA properties of components");
+	// Components only initialize their own states and tasks.
 	if (mFrequencyParallel) {
 		// Initialize MNA specific parts of components.
-		for (auto comp : mMNAComponents) {
-			// Initialize MNA specific parts of components.
-			comp->mnaInitializeHarm(mSystem.mSystemOmega, mTimeStep, mLeftVectorHarmAttributes);
-			const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
-			if (stamp.size() != 0) mRightVectorStamps.push_back(&stamp);
-		}
+		Utils::parallelFor(mMNAComponents.size(), [this](std::size_t i) {
+			mMNAComponents[i]->mnaInitializeHarm(mSystem.mSystemOmega, mTimeStep, mLeftVectorHarmAttributes);
+		});
 		// Initialize nodes
 		for (UInt nodeIdx = 0; nodeIdx < mNodes.size(); nodeIdx++) {
 			mNodes[nodeIdx]->mnaInitializeHarm(mLeftVectorHarmAttributes);
@@ -147,15 +169,19 @@ void MnaSolver<Complex>::initializeComponents() {
 	}
 	else {
 		// Initialize MNA specific parts of components.
-		for (auto comp : mMNAComponents) {
-			comp->mnaInitialize(mSystem.mSystemOmega, mTimeStep, attribute<Matrix>("left_vector"));
-			const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
-			if (stamp.size() != 0) {
-				mRightVectorStamps.push_back(&stamp);
-			}
+		auto leftVector = attribute<Matrix>("left_vector");
+		Utils::parallelFor(mMNAComponents.size(), [&](std::size_t i) {
+			mMNAComponents[i]->mnaInitialize(mSystem.mSystemOmega, mTimeStep, leftVector);
+		});
+		Utils::parallelFor(mSwitches.size(), [&](std::size_t i) {
+			mSwitches[i]->mnaInitialize(mSystem.mSystemOmega, mTimeStep, leftVector);
+		});
+	}
+	for (auto comp : mMNAComponents) {
+		const Matrix& stamp = comp->template attribute<Matrix>("right_vector")->get();
+		if (stamp.size() != 0) {
+			mRightVectorStamps.push_back(&stamp);
 		}
-		for (auto comp : mSwitches)
-			comp->mnaInitialize(mSystem.mSystemOmega, mTimeStep, attribute<Matrix>("left_vector"));
 	}
 }
 
@@ -209,18 +235,15 @@ void MnaSolver<VarType>::initializeSystem() {
 						Logger::matrixToString(mSwitchedMatrices[std::bitset<SWITCH_NUM>(0)]));
 				}
 			}
-			mLuFactorizations[std::bitset<SWITCH_NUM>(0)] = Eigen::PartialPivLU<Matrix>(mSwitchedMatrices[std::bitset<SWITCH_NUM>(0)]);
+			Factorization method = factorizationMethod(mSwitchedMatrices[std::bitset<SWITCH_NUM>(0)], 1);
+			factorizeSystemMatrix(mSwitchedMatrices[std::bitset<SWITCH_NUM>(0)],
+				mFactorizations[std::bitset<SWITCH_NUM>(0)], method);
+			if (mFactorizations[std::bitset<SWITCH_NUM>(0)].method() != method)
+				mSLog->warn("System matrix does not support the selected factorization, using LU");
 		}
 		else {
 			// Generate switching state dependent system matrices
-			for (auto& sys : mSwitchedMatrices) {
-				for (auto comp : mMNAComponents)
-					comp->mnaApplySystemMatrixStamp(sys.second);
-				for (UInt i = 0; i < mSwitches.size(); i++)
-					mSwitches[i]->mnaApplySwitchSystemMatrixStamp(sys.second, sys.first[i]);
-				// Compute LU-factorization for system matrix
-				mLuFactorizations[sys.first] = Eigen::PartialPivLU<Matrix>(sys.second);
-			}
+			stampSwitchedMatrices();
 			updateSwitchStatus();
 		}
 		// Initialize source vector for debugging
@@ -245,6 +268,139 @@ void MnaSolver<VarType>::updateSwitchStatus() {
 	}
 }
 
+template <typename VarType>
+void MnaSolver<VarType>::stampSwitchedMatrices() {
+	UInt size = static_cast<UInt>(mLeftSideVector.rows());
+	std::size_t numStates = 1ULL << mSwitches.size();
+
+	// Create all map entries up front so that the switching states
+	// can be factorized concurrently
+	std::vector<Matrix*> systems(numStates);
+	std::vector<MnaFactorization*> factorizations(numStates);
+	for (std::size_t i = 0; i < numStates; i++) {
+		systems[i] = &mSwitchedMatrices[std::bitset<SWITCH_NUM>(i)];
+		factorizations[i] = &mFactorizations[std::bitset<SWITCH_NUM>(i)];
+	}
+
+	// Stamping is cheap, but components log their stamps,
+	// so it is done serially to keep the logs in order
+	for (std::size_t i = 0; i < numStates; i++) {
+		Matrix& sys = *systems[i];
+		sys = Matrix::Zero(size, size);
+		for (auto comp : mMNAComponents)
+			comp->mnaApplySystemMatrixStamp(sys);
+		for (UInt s = 0; s < mSwitches.size(); s++)
+			mSwitches[s]->mnaApplySwitchSystemMatrixStamp(sys, std::bitset<SWITCH_NUM>(i)[s]);
+	}
+
+	Factorization method = factorizationMethod(*systems[0], numStates);
+	Utils::parallelFor(numStates, [&](std::size_t i) {
+		factorizeSystemMatrix(*systems[i], *factorizations[i], method);
+	});
+
+	for (std::size_t i = 0; i < numStates; i++) {
+		if (factorizations[i]->method() != method) {
+			mSLog->warn("System matrix of switch state {:s} does not support the selected factorization, using LU",
+				std::bitset<SWITCH_NUM>(i).to_string());
+		}
+	}
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::factorizeSystemMatrix(Matrix& sys, MnaFactorization& factorization, Factorization method) {
+	MatrixComp complexSys;
+	if (method == Factorization::ComplexLU && !mKeepSystemMatrices
+		&& MnaFactorization::complexSystem(sys, complexSys)) {
+		// Release the real system, which has twice the size
+		sys.resize(0, 0);
+		factorization.compute(complexSys);
+		return;
+	}
+	factorization.compute(sys, method);
+}
+
+template <typename VarType>
+Solver::Factorization MnaSolver<VarType>::factorizationMethod(const Matrix& sys, std::size_t numStates) {
+	UInt size = static_cast<UInt>(sys.rows());
+	if (mFactorization == Factorization::Auto) {
+		// The other switch states and time steps share the sparsity
+		// pattern, so the result of the first benchmark is kept
+		if (mSelectedFactorization == Factorization::Auto)
+			mSelectedFactorization = MnaFactorization::select(sys, numStates, mExpectedSteps, mSLog);
+		return mSelectedFactorization;
+	}
+	if (mFactorization == Factorization::Inverse && !MnaFactorization::inverseFits(size, numStates)) {
+		mSLog->warn("Inverses of {} system matrices of size {} exceed the size or memory limit, using LU",
+			numStates, size);
+		return Factorization::LU;
+	}
+	return mFactorization;
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::setTimeStepLevel(UInt level) {
+	if (level == mTimeStepLevel || level >= mTimeStepLevels.size())
+		return;
+
+	// Keep the system of the current time step for later reuse
+	mSwitchedMatrices.swap(mTimeStepMatrices[mTimeStepLevel]);
+	mFactorizations.swap(mTimeStepFactorizations[mTimeStepLevel]);
+
+	mTimeStepLevel = level;
+	mTimeStep = mTimeStepLevels[level];
+	for (auto comp : mMNAComponents)
+		comp->mnaUpdateTimeStep(mTimeStep);
+
+	mSwitchedMatrices.swap(mTimeStepMatrices[level]);
+	mFactorizations.swap(mTimeStepFactorizations[level]);
+	if (mSwitchedMatrices.empty()) {
+		mSLog->debug("Factorize system matrices for time step {:e}", mTimeStep);
+		stampSwitchedMatrices();
+	}
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::updateLocalErrorEstimate() {
+	if (mNumPrevSolutions >= 2) {
+		Real ratio = mTimeStep / mPrevTimeStep;
+		Matrix deviation = mLeftSideVector - mPrevLeftSideVector
+			- ratio * (mPrevLeftSideVector - mPrevPrevLeftSideVector);
+		mLocalError = deviation.lpNorm<Eigen::Infinity>()
+			/ (1. + mLeftSideVector.lpNorm<Eigen::Infinity>());
+	} else {
+		mNumPrevSolutions++;
+	}
+	mPrevPrevLeftSideVector.swap(mPrevLeftSideVector);
+	mPrevLeftSideVector = mLeftSideVector;
+	mPrevTimeStep = mTimeStep;
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::saveState(CPS::Snapshot& snapshot) {
+	AttributeList::saveState(snapshot);
+	snapshot.write(mRightSideVector);
+	snapshot.write(static_cast<unsigned long long>(mCurrentSwitchStatus.to_ullong()));
+	snapshot.write(mTimeStepLevel);
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::loadState(CPS::Snapshot& snapshot) {
+	AttributeList::loadState(snapshot);
+	snapshot.read(mRightSideVector);
+	unsigned long long switchStatus;
+	snapshot.read(switchStatus);
+	mCurrentSwitchStatus = std::bitset<SWITCH_NUM>(switchStatus);
+	UInt timeStepLevel;
+	snapshot.read(timeStepLevel);
+	if (!mTimeStepLevels.empty())
+		setTimeStepLevel(timeStepLevel);
+
+	// Restart the error estimate from the restored solution
+	mNumPrevSolutions = 0;
+	for (auto node : mNodes)
+		node->mnaUpdateVoltage(mLeftSideVector);
+}
+
 template <typename VarType>
 void MnaSolver<VarType>::identifyTopologyObjects() {
 	for (auto baseNode : mSystem.mNodes) {
@@ -407,21 +563,43 @@ template <typename VarType>
 void MnaSolver<VarType>::steadyStateInitialization() {
 	mSLog->info("--- Run steady-state initialization ---");
 
-	DataLogger initLeftVectorLog(mName + "_InitLeftVector", mLogLevel != CPS::Logger::Level::off);
-	DataLogger initRightVectorLog(mName + "_InitRightVector", mLogLevel != CPS::Logger::Level::off);
+	// Intermediate solutions are only logged for debugging
+	Bool logInit = mLogLevel <= CPS::Logger::Level::debug;
+	DataLogger initLeftVectorLog(mName + "_InitLeftVector", logInit);
+	DataLogger initRightVectorLog(mName + "_InitRightVector", logInit);
 
 	TopologicalPowerComp::Behaviour initBehaviourPowerComps = TopologicalPowerComp::Behaviour::Initialization;
 	SimSignalComp::Behaviour initBehaviourSignalComps = SimSignalComp::Behaviour::Initialization;
 
-	// TODO: enable use of timestep distinct from simulation timestep
+	// A larger time step accelerates the initialization
+	// if all components can follow the time step change.
 	Real initTimeStep = mTimeStep;
+	if (mSteadStIniTimeStep > 0 && mSteadStIniTimeStep != mTimeStep) {
+		Bool supported = mSimSignalComps.size() == 0;
+		for (auto comp : mMNAComponents)
+			supported = supported && comp->mnaSupportsTimeStepUpdate();
+
+		if (supported) {
+			initTimeStep = mSteadStIniTimeStep;
+			for (auto comp : mMNAComponents)
+				comp->mnaUpdateTimeStep(initTimeStep);
+		}
+		else {
+			mSLog->warn("Components do not support a distinct initialization time step");
+		}
+	}
+
+	// In EMT, the solution is compared to the one of the previous period
+	// because the waveforms are not constant in steady state.
+	UInt periodSteps = 1;
+	if (mDomain == CPS::Domain::EMT)
+		periodSteps = std::max(1, static_cast<Int>(std::round(1. / (mSystem.mSystemFrequency * initTimeStep))));
 
 	Int timeStepCount = 0;
 	Real time = 0;
 	Real maxDiff = 1.0;
 	Real max = 1.0;
-	Matrix diff = Matrix::Zero(2 * mNumNodes, 1);
-	Matrix prevLeftSideVector = Matrix::Zero(2 * mNumNodes, 1);
+	std::vector<Matrix> prevLeftSideVectors(periodSteps);
 
 	mSLog->info("Time step is {:f}s for steady-state initialization", initTimeStep);
 
@@ -455,6 +633,7 @@ void MnaSolver<VarType>::steadyStateInitialization() {
 	// TODO signal components should be moved out of MNA solver
 	for (auto comp : mSimSignalComps) {
 		for (auto task : comp->getTasks()) {
+			task->setRateDivisor(comp->rateDivisor());
 			tasks.push_back(task);
 		}
 	}
@@ -469,13 +648,15 @@ void MnaSolver<VarType>::steadyStateInitialization() {
 
 		sched.step(time, timeStepCount);
 
-		if (mDomain == CPS::Domain::EMT) {
-			initLeftVectorLog.logEMTNodeValues(time, leftSideVector());
-			initRightVectorLog.logEMTNodeValues(time, rightSideVector());
-		}
-		else {
-			initLeftVectorLog.logPhasorNodeValues(time, leftSideVector());
-			initRightVectorLog.logPhasorNodeValues(time, rightSideVector());
+		if (logInit) {
+			if (mDomain == CPS::Domain::EMT) {
+				initLeftVectorLog.logEMTNodeValues(time, leftSideVector());
+				initRightVectorLog.logEMTNodeValues(time, rightSideVector());
+			}
+			else {
+				initLeftVectorLog.logPhasorNodeValues(time, leftSideVector());
+				initRightVectorLog.logPhasorNodeValues(time, rightSideVector());
+			}
 		}
 
 		// Calculate new simulation time
@@ -483,17 +664,25 @@ void MnaSolver<VarType>::steadyStateInitialization() {
 		timeStepCount++;
 
 		// Calculate difference
-		diff = prevLeftSideVector - mLeftSideVector;
+		Matrix& prevLeftSideVector = prevLeftSideVectors[timeStepCount % periodSteps];
+		if (prevLeftSideVector.size() > 0) {
+			maxDiff = (prevLeftSideVector - mLeftSideVector).lpNorm<Eigen::Infinity>();
+			max = mLeftSideVector.lpNorm<Eigen::Infinity>();
+			// If difference is smaller than some epsilon, break
+			if (maxDiff <= mSteadStIniAccLimit * max)
+				break;
+		}
 		prevLeftSideVector = mLeftSideVector;
-		maxDiff = diff.lpNorm<Eigen::Infinity>();
-		max = mLeftSideVector.lpNorm<Eigen::Infinity>();
-		// If difference is smaller than some epsilon, break
-		if ((maxDiff / max) < mSteadStIniAccLimit)
-			break;
 	}
 
 	mSLog->info("Max difference: {:f} or {:f}% at time {:f}", maxDiff, maxDiff / max, time);
 
+	// Restore the simulation time step
+	if (initTimeStep != mTimeStep) {
+		for (auto comp : mMNAComponents)
+			comp->mnaUpdateTimeStep(mTimeStep);
+	}
+
 	// Reset system for actual simulation
 	mRightSideVector.setZero();
 
@@ -516,6 +705,7 @@ Task::List MnaSolver<VarType>::getTasks() {
 	// TODO signal components should be moved out of MNA solver
 	for (auto comp : mSimSignalComps) {
 		for (auto task : comp->getTasks()) {
+			task->setRateDivisor(comp->rateDivisor());
 			l.push_back(task);
 		}
 	}
@@ -540,14 +730,17 @@ void MnaSolver<VarType>::SolveTask::execute(Real time, Int timeStepCount) {
 		mSolver.mRightSideVector += *stamp;
 
 	if (mSolver.mSwitchedMatrices.size() > 0)
-		mSolver.mLeftSideVector = mSolver.mLuFactorizations[mSolver.mCurrentSwitchStatus].solve(mSolver.mRightSideVector);
+		mSolver.mFactorizations[mSolver.mCurrentSwitchStatus].solve(mSolver.mRightSideVector, mSolver.mLeftSideVector);
 
 	// TODO split into separate task? (dependent on x, updating all v attributes)
 	for (UInt nodeIdx = 0; nodeIdx < mSolver.mNumNetNodes; nodeIdx++)
 		mSolver.mNodes[nodeIdx]->mnaUpdateVoltage(mSolver.mLeftSideVector);
 
-	if (!mSteadyStateInit)
+	if (!mSteadyStateInit) {
 		mSolver.updateSwitchStatus();
+		if (!mSolver.mTimeStepLevels.empty())
+			mSolver.updateLocalErrorEstimate();
+	}
 
 	// Components' states will be updated by the post-step tasks
 }
@@ -598,7 +791,8 @@ void MnaSolver<VarType>::logSystemMatrices() {
 	else {
 		if (mSwitches.size() < 1) {
 			mSLog->info("System matrix: \n{}", mSwitchedMatrices[std::bitset<SWITCH_NUM>(0)]);
-			mSLog->info("LU decomposition: \n{}",	mLuFactorizations[std::bitset<SWITCH_NUM>(0)].matrixLU());
+			if (mFactorizations[std::bitset<SWITCH_NUM>(0)].method() == Solver::Factorization::LU)
+				mSLog->info("LU decomposition: \n{}",	mFactorizations[std::bitset<SWITCH_NUM>(0)].matrixLU());
 		}
 		else {
 			mSLog->info("Initial switch status: {:s}", mCurrentSwitchStatus.to_string());
@@ -606,8 +800,9 @@ void MnaSolver<VarType>::logSystemMatrices() {
 			for (auto sys : mSwitchedMatrices) {
 				mSLog->info("Switching System matrix {:s} \n{:s}",
 					sys.first.to_string(), Logger::matrixToString(sys.second));
-				mSLog->info("LU Factorization for System Matrix {:s} \n{:s}",
-					sys.first.to_string(), Logger::matrixToString(mLuFactorizations[sys.first].matrixLU()));
+				if (mFactorizations[sys.first].method() == Solver::Factorization::LU)
+					mSLog->info("LU Factorization for System Matrix {:s} \n{:s}",
+						sys.first.to_string(), Logger::matrixToString(mFactorizations[sys.first].matrixLU()));
 			}
 		}
 		mSLog->info("Right side vector: \n{}", mRightSideVector);
@@ -621,5 +816,113 @@ void MnaSolver<VarType>::LogTask::execute(Real time, Int timeStepCount) {
 
 }
 
+template <typename VarType>
+void MnaSolver<VarType>::collectAdmittanceComponents(MNAInterface::Ptr comp, MNAInterface::List& comps) {
+	if (comp->mnaSupportsAdmittanceStamp()) {
+		comps.push_back(comp);
+		return;
+	}
+
+	auto pComp = std::dynamic_pointer_cast<SimPowerComp<VarType>>(comp);
+	if (pComp && pComp->hasSubComponents()) {
+		for (auto subComp : pComp->subComponents()) {
+			auto mnaSubComp = std::dynamic_pointer_cast<MNAInterface>(subComp);
+			if (mnaSubComp)
+				collectAdmittanceComponents(mnaSubComp, comps);
+		}
+		return;
+	}
+
+	auto idObj = std::dynamic_pointer_cast<IdentifiedObject>(comp);
+	mSLog->error("Component {} has no admittance stamp for the frequency sweep",
+		idObj ? idObj->name() : "");
+	throw SolverException();
+}
+
+template <typename VarType>
+std::vector<MatrixComp> MnaSolver<VarType>::impedanceSweep(const std::vector<Real>& frequencies,
+	const TopologicalNode::List& nodes) {
+
+	MNAInterface::List comps;
+	for (auto comp : mMNAComponents)
+		collectAdmittanceComponents(comp, comps);
+	for (auto sw : mSwitches)
+		collectAdmittanceComponents(sw, comps);
+
+	// Injection points of the unit currents
+	std::vector<UInt> injections;
+	for (auto node : nodes) {
+		if (node->isGround()) {
+			mSLog->error("Frequency sweep at ground node {}", node->name());
+			throw SolverException();
+		}
+		injections.push_back(node->matrixNodeIndex());
+	}
+	Int size = mNumMatrixNodeIndices;
+	MatrixComp rhs = MatrixComp::Zero(size, injections.size());
+	for (UInt i = 0; i < injections.size(); i++)
+		rhs(injections[i], i) = 1;
+
+	std::vector<MatrixComp> impedances(frequencies.size());
+	if (frequencies.empty())
+		return impedances;
+
+	// The stamps have the same entries at all frequencies, so the pattern
+	// and the position of each entry in it are determined once
+	MNAInterface::AdmittanceStamp stamp;
+	for (auto comp : comps)
+		comp->mnaApplyAdmittanceStamp(2. * PI * frequencies[0], stamp);
+	SparseMatrixComp pattern(size, size);
+	pattern.setFromTriplets(stamp.begin(), stamp.end());
+	pattern.makeCompressed();
+
+	std::vector<Int> positions;
+	for (auto& entry : stamp) {
+		auto begin = pattern.innerIndexPtr() + pattern.outerIndexPtr()[entry.col()];
+		auto end = pattern.innerIndexPtr() + pattern.outerIndexPtr()[entry.col() + 1];
+		positions.push_back(static_cast<Int>(std::lower_bound(begin, end, entry.row()) - pattern.innerIndexPtr()));
+	}
+
+	// Each thread works on a block of frequencies with its own matrix and
+	// factorization, the symbolic analysis is done once per block
+	std::size_t numBlocks = std::min<std::size_t>(Utils::maxThreads(), frequencies.size());
+	Utils::parallelFor(numBlocks, [&](std::size_t block) {
+		std::size_t first = block * frequencies.size() / numBlocks;
+		std::size_t last = (block + 1) * frequencies.size() / numBlocks;
+
+		SparseMatrixComp admittance = pattern;
+		Eigen::SparseLU<SparseMatrixComp> lu;
+		lu.analyzePattern(admittance);
+
+		MNAInterface::AdmittanceStamp values;
+		for (std::size_t f = first; f < last; f++) {
+			values.clear();
+			for (auto comp : comps)
+				comp->mnaApplyAdmittanceStamp(2. * PI * frequencies[f], values);
+			if (values.size() != positions.size()) {
+				mSLog->error("Admittance stamps changed with the frequency");
+				throw SolverException();
+			}
+
+			std::fill(admittance.valuePtr(), admittance.valuePtr() + admittance.nonZeros(), Complex(0, 0));
+			for (std::size_t e = 0; e < values.size(); e++)
+				admittance.valuePtr()[positions[e]] += values[e].value();
+
+			lu.factorize(admittance);
+			if (lu.info() != Eigen::Success) {
+				mSLog->error("Singular admittance matrix at {} Hz", frequencies[f]);
+				throw SolverException();
+			}
+			MatrixComp voltages = lu.solve(rhs);
+
+			impedances[f] = MatrixComp(injections.size(), injections.size());
+			for (UInt i = 0; i < injections.size(); i++)
+				impedances[f].row(i) = voltages.row(injections[i]);
+		}
+	});
+
+	return impedances;
+}
+
 template class DPsim::MnaSolver<Real>;
 template class DPsim::MnaSolver<Complex>;
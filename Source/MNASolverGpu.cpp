@@ -12,6 +12,8 @@ MnaSolverGpu<VarType>::MnaSolverGpu(String name,
     MnaSolver<VarType>(name, domain, logLevel),
     mCusolverHandle(nullptr), mStream(nullptr) {
 
+    // The system matrix is copied to the device for its own LU
+    this->mKeepSystemMatrices = true;
     mDeviceCopy = {};
 
     cusolverStatus_t status = CUSOLVER_STATUS_SUCCESS;
@@ -12,48 +12,55 @@
 using namespace DPsim;
 
 ODEintSolver::ODEintSolver(String name, CPS::ODEintInterface::Ptr comp, Real dt, Real t0) :
-        mComponent(comp), mTimestep(dt){
-        times.push_back(t0);
-        self = this; // sets static pointer to current object
-        ProbDim = comp->num_states();
+        Solver(name, CPS::Logger::Level::info),
+        mComponent(comp), mTimestep(dt) {
+        mProbDim = comp->num_states();
 
-        curSolution.resize(ProbDim);
+        mCurrentSolution.resize(mProbDim);
 
         //register all system functions
-        system.push_back(
+        mSystem.push_back(
                 [comp](const double y[],  double ydot[],  const double t){
                     comp->odeint(y, ydot, t);
                 });
-
 }
 
-
+void ODEintSolver::setSolutionHistory(Bool retain, UInt expectedSteps) {
+    mRetainHistory = retain;
+    mSolutionHistory.clear();
+    mTimeHistory.clear();
+    if (retain) {
+        mSolutionHistory.reserve(expectedSteps);
+        mTimeHistory.reserve(expectedSteps);
+    } else {
+        mSolutionHistory.shrink_to_fit();
+        mTimeHistory.shrink_to_fit();
+    }
+}
 
 Real ODEintSolver::step(Real time) {
 
     mComponent->pre_step(); ///write inital values into the mState Vector
-    curSolution.assign(mComponent->state_vector(), mComponent->state_vector()+ProbDim);
+    const double *state = mComponent->state_vector();
+    std::copy(state, state + mProbDim, mCurrentSolution.begin());
     Real NextTime = time + mTimestep;
 
-    std::cout<<"Current Time "<<NextTime<<std::endl;
+    ///solve ODE for time + mTimestep
+    mStepper.do_step([this](const State &y, State &ydot, Real t) { stateSpace(y, ydot, t); },
+        mCurrentSolution, time, mTimestep);
+    mComponent->set_state_vector(mCurrentSolution);///Writes the current solution back into the component
 
-    stepper.do_step(&ODEintSolver::StateSpaceWrapper,curSolution, time, mTimestep); ///solve ODE for time + mTimestep TODO: implement sysfunc
-    mComponent->set_state_vector(curSolution);///Writes the current solution back into the component
-    solution.push_back(curSolution); /// Logs current solution
-    times.push_back(time); ///Logs current time
+    if (mRetainHistory) {
+        mSolutionHistory.push_back(mCurrentSolution);
+        mTimeHistory.push_back(NextTime);
+    }
 
-    // TODO: add proper logging
     mComponent->post_step();
     return NextTime;
 }
 
-void ODEintSolver::StateSpaceWrapper( const std::vector<double> y, std::vector<double> ydot, double t){
-
-        for(auto comp : self->system){ // call system functions of the components with the state vector
-                comp(y.data(), ydot.data(), t);
-        }
+void ODEintSolver::stateSpace(const State &y, State &ydot, Real t) {
+    for (auto &fnc : mSystem) { // call system functions of the components with the state vector
+        fnc(y.data(), ydot.data(), t);
+    }
 }
-
-ODEintSolver::~ODEintSolver() {
-}
-
@@ -18,43 +18,61 @@ OpenMPLevelScheduler::OpenMPLevelScheduler(Int threads, String outMeasurementFil
 	if (threads >= 0)
 		mNumThreads = threads;
 	else
-		mNumThreads = omp_get_num_threads();
+		mNumThreads = omp_get_max_threads();
 }
 
 void OpenMPLevelScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
 	Task::List ordered;
+	Task::List phaseTasks;
+	Edges phaseInEdges, phaseOutEdges;
+	std::unordered_map<String, TaskTime::rep> measurements;
 
 	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
-	Scheduler::levelSchedule(ordered, inEdges, outEdges, mLevels);
+	Scheduler::initRatePhases(ordered);
 
-	if (!mOutMeasurementFile.empty())
+	mLevels.resize(mNumRatePhases);
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		Scheduler::filterRatePhase(ordered, inEdges, outEdges, phase, phaseTasks, phaseInEdges, phaseOutEdges);
+		if (fuseTasksEnabled())
+			Scheduler::fuseTasks(phaseTasks, phaseInEdges, phaseOutEdges, measurements);
+		Scheduler::levelSchedule(phaseTasks, phaseInEdges, phaseOutEdges, mLevels[phase]);
+	}
+
+	if (!mOutMeasurementFile.empty()) {
 		Scheduler::initMeasurements(tasks);
+		for (auto& phaseLevels : mLevels) {
+			for (auto& level : phaseLevels)
+				Scheduler::initMeasurements(level);
+		}
+		Scheduler::measureFusedTasks(true);
+	}
 }
 
 void OpenMPLevelScheduler::step(Real time, Int timeStepCount) {
 	size_t i = 0, level = 0;
 	std::chrono::steady_clock::time_point start, end;
+	std::vector<Task::List>& levels = mLevels[ratePhase(timeStepCount)];
 
 	if (!mOutMeasurementFile.empty()) {
 		#pragma omp parallel shared(time,timeStepCount) private(level, i, start, end) num_threads(mNumThreads)
-		for (level = 0; level < mLevels.size(); level++) {
+		for (level = 0; level < levels.size(); level++) {
 			{
 				#pragma omp for schedule(static)
-				for (i = 0; i < mLevels[level].size(); i++) {
+				for (i = 0; i < levels[level].size(); i++) {
 					start = std::chrono::steady_clock::now();
-					mLevels[level][i]->execute(time, timeStepCount);
+					levels[level][i]->execute(time, timeStepCount);
 					end = std::chrono::steady_clock::now();
-					updateMeasurement(mLevels[level][i].get(), end-start);
+					updateMeasurement(levels[level][i].get(), end-start);
 				}
 			}
 		}
 	} else {
 		#pragma omp parallel shared(time,timeStepCount) private(level, i) num_threads(mNumThreads)
-		for (level = 0; level < mLevels.size(); level++) {
+		for (level = 0; level < levels.size(); level++) {
 			{
 				#pragma omp for schedule(static)
-				for (i = 0; i < mLevels[level].size(); i++) {
-					mLevels[level][i]->execute(time, timeStepCount);
+				for (i = 0; i < levels[level].size(); i++) {
+					levels[level][i]->execute(time, timeStepCount);
 				}
 			}
 		}
@@ -0,0 +1,83 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/OutputPipeline.h>
+
+using namespace DPsim;
+
+OutputPipeline::SnapshotTask::SnapshotTask(OutputPipeline& pipeline, UInt stage, CPS::Task::Ptr outputTask) :
+	Task(outputTask->toString() + ".Snapshot"), mPipeline(pipeline), mStage(stage) {
+	mAttributeDependencies = outputTask->getAttributeDependencies();
+	mModifiedAttributes = outputTask->getModifiedAttributes();
+	mRateDivisor = outputTask->rateDivisor();
+	mDeferrable = outputTask->isDeferrable();
+}
+
+void OutputPipeline::SnapshotTask::execute(Real time, Int timeStepCount) {
+	// The output thread only accesses the front buffer
+	auto& stage = mPipeline.mStages[mStage];
+	stage.snapshot(mPipeline.mBackBuffer, time, timeStepCount);
+	stage.filled[mPipeline.mBackBuffer] = true;
+}
+
+CPS::Task::Ptr OutputPipeline::addStage(CPS::Task::Ptr outputTask, SnapshotFunction snapshot, WriteFunction write) {
+	mStages.push_back({snapshot, write, { false, false }});
+	return std::make_shared<SnapshotTask>(*this, static_cast<UInt>(mStages.size() - 1), outputTask);
+}
+
+void OutputPipeline::push() {
+	if (mStages.empty())
+		return;
+
+	if (!mThread.joinable())
+		mThread = std::thread(&OutputPipeline::threadFunction, this);
+
+	std::unique_lock<std::mutex> lk(mMutex);
+	mCondition.wait(lk, [this]() { return !mPending; });
+	mFrontBuffer = mBackBuffer;
+	mBackBuffer = 1 - mBackBuffer;
+	mPending = true;
+	lk.unlock();
+	mCondition.notify_all();
+}
+
+void OutputPipeline::stop() {
+	if (!mThread.joinable())
+		return;
+
+	{
+		std::unique_lock<std::mutex> lk(mMutex);
+		mStopping = true;
+	}
+	mCondition.notify_all();
+	mThread.join();
+	mStopping = false;
+}
+
+void OutputPipeline::threadFunction() {
+	std::unique_lock<std::mutex> lk(mMutex);
+	while (true) {
+		mCondition.wait(lk, [this]() { return mPending || mStopping; });
+		// Pending outputs are written before stopping
+		if (!mPending)
+			return;
+
+		UInt buffer = mFrontBuffer;
+		lk.unlock();
+		for (auto& stage : mStages) {
+			// Stages with a lower rate are not executed in every step
+			if (stage.filled[buffer])
+				stage.write(buffer);
+			stage.filled[buffer] = false;
+		}
+		lk.lock();
+
+		mPending = false;
+		mCondition.notify_all();
+	}
+}
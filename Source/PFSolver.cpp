@@ -133,6 +133,10 @@ void PFSolver::determinePFBusType() {
 	mPQBusIndices.clear();
 	mPVBusIndices.clear();
 	mVDBusIndices.clear();
+	mPQBuses.clear();
+	mPVBuses.clear();
+	mVDBuses.clear();
+	mPQPVBusIndices.clear();
 
     // Determine powerflow bus type of each node through analysis of system topology
 	for (auto node : mSystem.mNodes) {
@@ -225,16 +229,28 @@ void PFSolver::determinePFBusType() {
     mSLog->info("VD Buses: {}", logVector(mVDBusIndices));
 }
 
+void PFSolver::updatePFBusTypes() {
+	determinePFBusType();
+	mJ.setZero(mNumUnknowns,mNumUnknowns);
+	mX.setZero(mNumUnknowns);
+	mF.setZero(mNumUnknowns);
+	mJacobianAnalyzed = false;
+	solutionInitialized = false;
+	solutionComplexInitialized = false;
+}
+
 void PFSolver::setVDNode(CPS::String name) {
 	if (!mExternalGrids.empty()) {
 		if (mExternalGrids[0]->node(0)->name() == name) {
 			mExternalGrids[0]->modifyPowerFlowBusType(CPS::PowerflowBusType::VD);
+			updatePFBusTypes();
 		}
 	} else {
 		for (auto gen : mSynchronGenerators) {
 			if (gen->node(0)->name() == name)
 			{
 				gen->modifyPowerFlowBusType(CPS::PowerflowBusType::VD);
+				updatePFBusTypes();
 				return;
 			}
 		}
@@ -251,6 +267,7 @@ void PFSolver::modifyPowerFlowBusComponent(CPS::String name, CPS::PowerflowBusTy
 				gen->modifyPowerFlowBusType(powerFlowBusType);
 		}
 	}
+	updatePFBusTypes();
 }
 
 void PFSolver::composeAdmittanceMatrix() {
@@ -305,12 +322,18 @@ Bool PFSolver::solvePowerflow() {
     for (unsigned i = 1; i < mMaxIterations && !isConverged; ++i) {
 
         calculateJacobian();
-		auto sparseJ = mJ.sparseView();
+		if (!mJacobianAnalyzed)
+			analyzeJacobianPattern();
 
-		// Solve system mJ*mX = mF
-        Eigen::SparseLU<SparseMatrix>lu(sparseJ);
+		// The pattern does not depend on the solution, only the values are updated
+		for (Int col = 0; col < mJSparse.outerSize(); col++) {
+			for (SparseMatrix::InnerIterator it(mJSparse, col); it; ++it)
+				it.valueRef() = mJ.coeff(it.row(), it.col());
+		}
 
-		mX = lu.solve(mF);	/* code */
+		// Solve system mJ*mX = mF
+		mJLU.factorize(mJSparse);
+		mX = mJLU.solve(mF);
 
 		// Calculate new solution based on mX increments obtained from equation system
 		updateSolution();
@@ -328,11 +351,55 @@ Bool PFSolver::solvePowerflow() {
 	return isConverged;
 }
 
+void PFSolver::analyzeJacobianPattern() {
+	UInt npqpv = mNumPQBuses + mNumPVBuses;
+
+	// Position of each bus in the unknowns, -1 for VD buses
+	std::vector<Int> position(mSystem.mNodes.size(), -1);
+	for (UInt a = 0; a < npqpv; a++)
+		position[mPQPVBusIndices[a]] = a;
+
+	// Rows and columns of a bus: angle / active power and for PQ buses
+	// additionally voltage magnitude / reactive power
+	auto unknowns = [&](UInt a) {
+		std::vector<UInt> idx = { a };
+		if (a < mNumPQBuses)
+			idx.push_back(a + npqpv);
+		return idx;
+	};
+
+	std::vector<Eigen::Triplet<Real>> entries;
+	for (UInt a = 0; a < npqpv; a++) {
+		std::vector<Int> coupled = { static_cast<Int>(a) };
+		for (SparseMatrixCompRow::InnerIterator it(mY, mPQPVBusIndices[a]); it; ++it) {
+			Int b = position[it.col()];
+			if (b >= 0 && b != static_cast<Int>(a))
+				coupled.push_back(b);
+		}
+		for (auto row : unknowns(a)) {
+			for (auto b : coupled) {
+				for (auto col : unknowns(b))
+					entries.push_back(Eigen::Triplet<Real>(row, col, 0));
+			}
+		}
+	}
+
+	mJSparse.resize(mNumUnknowns, mNumUnknowns);
+	mJSparse.setFromTriplets(entries.begin(), entries.end());
+	mJSparse.makeCompressed();
+	mJLU.analyzePattern(mJSparse);
+	mJacobianAnalyzed = true;
+}
+
+Bool PFSolver::solveTimeStep(Real time) {
+	generateInitialSolution(time, mWarmStart && isConverged);
+	solvePowerflow();
+	setSolution();
+	return isConverged;
+}
+
 void PFSolver::SolveTask::execute(Real time, Int timeStepCount) {
-	// apply keepLastSolution to save computation time
-    mSolver.generateInitialSolution(time);
-	mSolver.solvePowerflow();
-	mSolver.setSolution();
+	mSolver.solveTimeStep(time);
 }
 
 Task::List PFSolver::getTasks() {
@@ -7,6 +7,7 @@
  *********************************************************************************/
 
 #include <dpsim/PFSolverPowerPolar.h>
+#include <dpsim/Utils.h>
 
 using namespace DPsim;
 using namespace CPS;
@@ -15,9 +16,22 @@ using namespace CPS;
 PFSolverPowerPolar::PFSolverPowerPolar(CPS::String name, CPS::SystemTopology system, CPS::Real timeStep, CPS::Logger::Level logLevel)
     : PFSolver(name, system, timeStep, logLevel){ }
 
+void PFSolverPowerPolar::updatePFBusTypes() {
+	PFSolver::updatePFBusTypes();
+	mDecoupledFactorized = false;
+}
+
 void PFSolverPowerPolar::generateInitialSolution(Real time, bool keep_last_solution) {
-	resize_sol(mSystem.mNodes.size());
-	resize_complex_sol(mSystem.mNodes.size());
+	if (keep_last_solution && solutionInitialized) {
+		// Keep voltages of the last solution, the injections are recomputed
+		sol_P.setZero();
+		sol_Q.setZero();
+		sol_S_complex.setZero();
+	} else {
+		keep_last_solution = false;
+		resize_sol(mSystem.mNodes.size());
+		resize_complex_sol(mSystem.mNodes.size());
+	}
 
     // update all components for the new time
     for (auto comp : mSystem.mComponents) {
@@ -442,3 +456,276 @@ CPS::Real PFSolverPowerPolar::sol_Vi(UInt k) {
 CPS::Complex PFSolverPowerPolar::sol_Vcx(UInt k) {
 	return CPS::Complex(sol_Vr(k), sol_Vi(k));
 }
+
+Bool PFSolverPowerPolar::solvePowerflow() {
+	if (mMethod == Method::NewtonRaphson)
+		return PFSolver::solvePowerflow();
+
+	if (!mDecoupledFactorized)
+		factorizeDecoupledMatrices();
+	isConverged = solveFastDecoupled(sol_V, sol_D, nullptr, mIterations);
+	return isConverged;
+}
+
+void PFSolverPowerPolar::factorizeDecoupledMatrices() {
+	UInt npqpv = mNumPQBuses + mNumPVBuses;
+
+	// Position of each bus in the unknowns, -1 for VD buses
+	std::vector<Int> position(mSystem.mNodes.size(), -1);
+	for (UInt a = 0; a < npqpv; a++)
+		position[mPQPVBusIndices[a]] = a;
+
+	// Both matrices are the negative susceptance matrix, reduced to the
+	// angles of PQ and PV buses and the magnitudes of PQ buses
+	std::vector<Eigen::Triplet<Real>> bp, bpp;
+	for (UInt a = 0; a < npqpv; a++) {
+		for (SparseMatrixCompRow::InnerIterator it(mY, mPQPVBusIndices[a]); it; ++it) {
+			Int b = position[it.col()];
+			if (b < 0)
+				continue;
+			bp.push_back(Eigen::Triplet<Real>(a, b, -it.value().imag()));
+			if (a < mNumPQBuses && static_cast<UInt>(b) < mNumPQBuses)
+				bpp.push_back(Eigen::Triplet<Real>(a, b, -it.value().imag()));
+		}
+	}
+
+	mBp.resize(npqpv, npqpv);
+	mBp.setFromTriplets(bp.begin(), bp.end());
+	mBp.makeCompressed();
+	mBpLU.compute(mBp);
+
+	mBpp.resize(mNumPQBuses, mNumPQBuses);
+	mBpp.setFromTriplets(bpp.begin(), bpp.end());
+	mBpp.makeCompressed();
+	mBppLU.compute(mBpp);
+
+	if (mBpLU.info() != Eigen::Success || (mNumPQBuses > 0 && mBppLU.info() != Eigen::Success))
+		throw SystemError("Decoupled powerflow matrices are singular");
+	mDecoupledFactorized = true;
+}
+
+void PFSolverPowerPolar::calculatePowerInjections(const Vector& V, const Vector& D,
+	const BranchOutage* outage, Vector& P, Vector& Q) const {
+
+	VectorComp v(V.size());
+	for (Int k = 0; k < V.size(); k++)
+		v(k) = std::polar(V(k), D(k));
+
+	VectorComp current = mY * v;
+	if (outage) {
+		for (UInt i = 0; i < 2; i++)
+			for (UInt j = 0; j < 2; j++)
+				current(outage->buses[i]) += outage->deltaY(i, j) * v(outage->buses[j]);
+	}
+
+	VectorComp power = v.array() * current.conjugate().array();
+	P = power.real();
+	Q = power.imag();
+}
+
+Bool PFSolverPowerPolar::solveFastDecoupled(Vector& V, Vector& D,
+	const BranchOutage* outage, UInt& iterations) const {
+
+	UInt npqpv = mNumPQBuses + mNumPVBuses;
+
+	DecoupledUpdate updateBp, updateBpp;
+	if (outage) {
+		prepareDecoupledUpdate(mBpLU, npqpv, *outage, updateBp);
+		prepareDecoupledUpdate(mBppLU, mNumPQBuses, *outage, updateBpp);
+	}
+
+	Vector P, Q;
+	Vector dP(npqpv), dQ(mNumPQBuses);
+	iterations = 0;
+	while (true) {
+		calculatePowerInjections(V, D, outage, P, Q);
+		for (UInt a = 0; a < npqpv; a++) {
+			UInt k = mPQPVBusIndices[a];
+			dP(a) = (Pesp.coeff(k) - P(k)) / V(k);
+		}
+		for (UInt a = 0; a < mNumPQBuses; a++) {
+			UInt k = mPQPVBusIndices[a];
+			dQ(a) = (Qesp.coeff(k) - Q(k)) / V(k);
+		}
+
+		Real mismatch = std::max(
+			npqpv > 0 ? dP.cwiseAbs().maxCoeff() : 0.,
+			mNumPQBuses > 0 ? dQ.cwiseAbs().maxCoeff() : 0.);
+		if (mismatch < mTolerance)
+			return true;
+		if (iterations == mMaxDecoupledIterations || !std::isfinite(mismatch))
+			return false;
+		iterations++;
+
+		// Angle update from the active power mismatch
+		Vector dD = solveDecoupled(mBpLU, outage ? &updateBp : nullptr, dP);
+		for (UInt a = 0; a < npqpv; a++)
+			D(mPQPVBusIndices[a]) += dD(a);
+
+		if (mNumPQBuses == 0)
+			continue;
+
+		// Magnitude update from the reactive power mismatch at the new angles
+		calculatePowerInjections(V, D, outage, P, Q);
+		for (UInt a = 0; a < mNumPQBuses; a++) {
+			UInt k = mPQPVBusIndices[a];
+			dQ(a) = (Qesp.coeff(k) - Q(k)) / V(k);
+		}
+		Vector dV = solveDecoupled(mBppLU, outage ? &updateBpp : nullptr, dQ);
+		for (UInt a = 0; a < mNumPQBuses; a++)
+			V(mPQPVBusIndices[a]) += dV(a);
+	}
+}
+
+void PFSolverPowerPolar::prepareDecoupledUpdate(const Eigen::SparseLU<SparseMatrix>& lu,
+	UInt size, const BranchOutage& outage, DecoupledUpdate& update) const {
+
+	// Rows of the outaged buses in the reduced matrix
+	std::vector<UInt> index;
+	for (UInt i = 0; i < 2; i++) {
+		for (UInt a = 0; a < size; a++) {
+			if (mPQPVBusIndices[a] == outage.buses[i]) {
+				update.positions.push_back(a);
+				index.push_back(i);
+			}
+		}
+	}
+
+	UInt rank = static_cast<UInt>(update.positions.size());
+	if (rank == 0)
+		return;
+
+	update.delta = Matrix(rank, rank);
+	Matrix unit = Matrix::Zero(size, rank);
+	for (UInt i = 0; i < rank; i++) {
+		unit(update.positions[i], i) = 1;
+		for (UInt j = 0; j < rank; j++)
+			update.delta(i, j) = -outage.deltaY(index[i], index[j]).imag();
+	}
+
+	// Woodbury identity for B + U delta U^T
+	update.factors = lu.solve(unit);
+	Matrix capacitance = Matrix::Identity(rank, rank);
+	for (UInt i = 0; i < rank; i++)
+		for (UInt j = 0; j < rank; j++)
+			for (UInt l = 0; l < rank; l++)
+				capacitance(i, j) += update.delta(i, l) * update.factors(update.positions[l], j);
+	update.capacitance.compute(capacitance);
+}
+
+Vector PFSolverPowerPolar::solveDecoupled(const Eigen::SparseLU<SparseMatrix>& lu,
+	const DecoupledUpdate* update, const Vector& rhs) const {
+
+	Vector x = lu.solve(rhs);
+	if (!update || update->positions.empty())
+		return x;
+
+	UInt rank = static_cast<UInt>(update->positions.size());
+	Vector ux(rank);
+	for (UInt i = 0; i < rank; i++)
+		ux(i) = x(update->positions[i]);
+	Vector correction = update->capacitance.solve(update->delta * ux);
+	return x - update->factors * correction;
+}
+
+PFSolverPowerPolar::BranchOutage PFSolverPowerPolar::branchOutage(SimPowerComp<Complex>::Ptr branch) const {
+	auto pfBranch = std::dynamic_pointer_cast<PFSolverInterfaceBranch>(branch);
+	if (!pfBranch)
+		throw SystemError("Component " + branch->name() + " is not a powerflow branch");
+
+	BranchOutage outage;
+	outage.buses[0] = branch->matrixNodeIndex(0);
+	outage.buses[1] = branch->matrixNodeIndex(1);
+
+	// Stamp the branch alone and remove its contribution
+	SparseMatrixCompRow stamp(mY.rows(), mY.cols());
+	pfBranch->pfApplyAdmittanceMatrixStamp(stamp);
+	outage.deltaY = MatrixComp(2, 2);
+	for (UInt i = 0; i < 2; i++)
+		for (UInt j = 0; j < 2; j++)
+			outage.deltaY(i, j) = -stamp.coeff(outage.buses[i], outage.buses[j]);
+	return outage;
+}
+
+Bool PFSolverPowerPolar::isIslanded(const BranchOutage& outage) const {
+	UInt n = mSystem.mNodes.size();
+	std::vector<Bool> reached(n, false);
+	std::vector<UInt> queue(mVDBusIndices.begin(), mVDBusIndices.end());
+	for (auto k : queue)
+		reached[k] = true;
+
+	for (std::size_t q = 0; q < queue.size(); q++) {
+		UInt k = queue[q];
+		for (SparseMatrixCompRow::InnerIterator it(mY, k); it; ++it) {
+			UInt j = it.col();
+			if (reached[j])
+				continue;
+			// Connection between the outaged buses can remain through parallel branches
+			if ((k == outage.buses[0] && j == outage.buses[1]) || (k == outage.buses[1] && j == outage.buses[0])) {
+				UInt i0 = (k == outage.buses[0]) ? 0 : 1;
+				if (std::abs(it.value() + outage.deltaY(i0, 1 - i0)) <= 1e-9 * std::abs(it.value()))
+					continue;
+			}
+			reached[j] = true;
+			queue.push_back(j);
+		}
+	}
+	return queue.size() < n;
+}
+
+std::vector<PFSolverPowerPolar::ContingencyResult> PFSolverPowerPolar::screenContingencies(Real time,
+	const std::vector<String>& branches) {
+
+	std::vector<SimPowerComp<Complex>::Ptr> selected;
+	if (branches.empty()) {
+		for (auto line : mLines)
+			selected.push_back(line);
+		for (auto trafo : mTransformers)
+			selected.push_back(trafo);
+	} else {
+		for (auto& name : branches) {
+			SimPowerComp<Complex>::Ptr branch;
+			for (auto line : mLines)
+				if (line->name() == name)
+					branch = line;
+			for (auto trafo : mTransformers)
+				if (trafo->name() == name)
+					branch = trafo;
+			if (!branch)
+				throw SystemError("Unknown branch " + name);
+			selected.push_back(branch);
+		}
+	}
+
+	// Base case with the selected method, its solution is the initial
+	// guess for all contingencies
+	generateInitialSolution(time);
+	solvePowerflow();
+	setSolution();
+	mSLog->info("Base case {} in {} iterations", isConverged ? "converged" : "did not converge", mIterations);
+
+	if (!mDecoupledFactorized)
+		factorizeDecoupledMatrices();
+
+	// Stamping branches modifies their internal state, so it is done serially
+	std::vector<BranchOutage> outages;
+	for (auto branch : selected)
+		outages.push_back(branchOutage(branch));
+
+	std::vector<ContingencyResult> results(selected.size());
+	Utils::parallelFor(selected.size(), [&](std::size_t c) {
+		ContingencyResult& result = results[c];
+		result.branch = selected[c]->name();
+		result.voltageMagnitude = sol_V;
+		result.voltageAngle = sol_D;
+		result.islanded = isIslanded(outages[c]);
+		if (!result.islanded)
+			result.converged = solveFastDecoupled(result.voltageMagnitude, result.voltageAngle,
+				&outages[c], result.iterations);
+	});
+
+	for (auto& result : results)
+		mSLog->info("Outage of {}: {}", result.branch,
+			result.islanded ? "islanded" : result.converged ? "converged" : "did not converge");
+	return results;
+}
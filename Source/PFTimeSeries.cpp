@@ -0,0 +1,66 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+
+#include <dpsim/PFTimeSeries.h>
+#include <dpsim/Utils.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+PFTimeSeries::PFTimeSeries(SystemFactory systemFactory, String name,
+	Real startTime, Real timeStep, UInt numSteps, Logger::Level logLevel) :
+	mName(name), mSystemFactory(systemFactory), mStartTime(startTime),
+	mTimeStep(timeStep), mNumSteps(numSteps), mLogLevel(logLevel) { }
+
+void PFTimeSeries::run() {
+	UInt numSegments = mNumSegments > 0 ? mNumSegments : Utils::maxThreads();
+	numSegments = std::max<UInt>(1, std::min(numSegments, mNumSteps));
+
+	// Systems and solvers are created sequentially because the
+	// component constructors register their loggers globally.
+	std::vector<SystemTopology> systems;
+	std::vector<std::shared_ptr<PFSolverPowerPolar>> solvers;
+	for (UInt seg = 0; seg < numSegments; seg++) {
+		systems.push_back(mSystemFactory());
+		auto solver = std::make_shared<PFSolverPowerPolar>(
+			mName + "_" + std::to_string(seg), systems.back(), mTimeStep, mLogLevel);
+		if (mConfigure)
+			mConfigure(*solver);
+		solver->doWarmStart(mWarmStart);
+		solvers.push_back(solver);
+	}
+
+	mNodeNames.clear();
+	for (auto node : systems[0].mNodes)
+		mNodeNames.push_back(node->name());
+
+	UInt numNodes = static_cast<UInt>(mNodeNames.size());
+	mVoltages = MatrixComp::Zero(mNumSteps, numNodes);
+	mIterations.assign(mNumSteps, 0);
+	mConverged.assign(mNumSteps, 0);
+
+	Utils::parallelFor(numSegments, [&](std::size_t seg) {
+		UInt first = static_cast<UInt>(seg * mNumSteps / numSegments);
+		UInt last = static_cast<UInt>((seg + 1) * mNumSteps / numSegments);
+		auto& solver = *solvers[seg];
+		auto& nodes = systems[seg].mNodes;
+
+		for (UInt step = first; step < last; step++) {
+			mConverged[step] = solver.solveTimeStep(mStartTime + step * mTimeStep);
+			mIterations[step] = solver.iterations();
+			for (UInt n = 0; n < numNodes; n++)
+				mVoltages(step, n) = std::dynamic_pointer_cast<SimNode<Complex>>(nodes[n])->singleVoltage();
+		}
+	});
+}
+
+UInt PFTimeSeries::numNotConverged() const {
+	return static_cast<UInt>(std::count(mConverged.begin(), mConverged.end(), 0));
+}
@@ -41,14 +41,25 @@ PthreadPoolScheduler::~PthreadPoolScheduler() {
 void PthreadPoolScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
 	// TODO: we're not actually creating the schedule here, but just copying
 	// the dependency graph so we can do the schedule dynamically in every step
-	mTasks = tasks;
-	mInEdges = inEdges;
-	mOutEdges = outEdges;
+	Task::List ordered;
+	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
+	Scheduler::initRatePhases(ordered);
+
+	// Each rate phase only contains the tasks executed in it
+	std::unordered_map<String, TaskTime::rep> measurements;
+	mTasks.resize(mNumRatePhases);
+	mInEdges.resize(mNumRatePhases);
+	mOutEdges.resize(mNumRatePhases);
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		Scheduler::filterRatePhase(ordered, inEdges, outEdges, phase, mTasks[phase], mInEdges[phase], mOutEdges[phase]);
+		if (fuseTasksEnabled())
+			Scheduler::fuseTasks(mTasks[phase], mInEdges[phase], mOutEdges[phase], measurements);
+	}
 
 	// TODO Wastes memory, but guarantees that the writes always succeed.
 	// Figure out a smarter way to do this.
-	queue_signalled_init(&mOutQueue, tasks.size(), &memory_heap, QueueSignalledMode::POLLING);
-	queue_signalled_init(&mDoneQueue, tasks.size(), &memory_heap, QueueSignalledMode::POLLING);
+	queue_signalled_init(&mOutQueue, ordered.size(), &memory_heap, QueueSignalledMode::POLLING);
+	queue_signalled_init(&mDoneQueue, ordered.size(), &memory_heap, QueueSignalledMode::POLLING);
 
 	for (size_t i = 0; i < mThreads.size(); i++) {
 		if (pthread_create(&mThreads[i], NULL, poolThreadFunction, this))
@@ -62,33 +73,37 @@ void PthreadPoolScheduler::step(Real time, Int timeStepCount) {
 	mTime = time;
 	mTimeStepCount = timeStepCount;
 
+	UInt phase = ratePhase(timeStepCount);
+	auto& tasks = mTasks[phase];
+	auto& outEdges = mOutEdges[phase];
+
 	// copy incoming edges since we remove them during execution to mark a dependency as "done"
-	Edges inEdgesCpy = mInEdges;
+	Edges inEdgesCpy = mInEdges[phase];
 
 	// Basically topological sort, but instead of marking tasks as ready, send them to the worker pool,
 	// and check if another task can be run everytime a task finishes.
-	for (size_t i = 0; i < mTasks.size(); i++) {
-		if (inEdgesCpy[mTasks[i]].empty()) {
+	for (size_t i = 0; i < tasks.size(); i++) {
+		if (inEdgesCpy[tasks[i]].empty()) {
 			// TODO since mTasks already contains smart pointers, the additional
 			// indirection is kind of unnecessary and defeats the smart pointers'
 			// purpose (although it should at least be safe)
-			if (queue_signalled_push(&mOutQueue, &mTasks[i]) != 1)
+			if (queue_signalled_push(&mOutQueue, &tasks[i]) != 1)
 				throw SchedulingException();
-			//std::cout << "scheduler: pushed " << mTasks[i]->toString() << std::endl;
+			//std::cout << "scheduler: pushed " << tasks[i]->toString() << std::endl;
 		}
 	}
 
 	size_t done = 0;
 	Task::Ptr t;
 	void *p;
-	while (done != mTasks.size()) {
+	while (done != tasks.size()) {
 		if (queue_signalled_pull(&mDoneQueue, &p) != 1)
 			throw SchedulingException();
 		t = *static_cast<Task::Ptr*>(p);
 		//std::cout << "scheduler: " << t->toString() << " done" << std::endl;
 		done++;
-		for (size_t i = 0; i < mOutEdges[t].size(); i++) {
-			Task::Ptr after = mOutEdges[t][i];
+		for (size_t i = 0; i < outEdges[t].size(); i++) {
+			Task::Ptr after = outEdges[t][i];
 			for (auto edgeIt = inEdgesCpy[after].begin(); edgeIt != inEdgesCpy[after].end(); ++edgeIt) {
 				if (*edgeIt == t) {
 					inEdgesCpy[after].erase(edgeIt);
@@ -97,8 +112,8 @@ void PthreadPoolScheduler::step(Real time, Int timeStepCount) {
 			}
 			if (inEdgesCpy[after].empty()) {
 				// TODO: somewhat of a hack (see above), but should be safe
-				// since mOutEdges is not modified during a step
-				if (queue_signalled_push(&mOutQueue, &mOutEdges[t][i]) != 1)
+				// since the out edges are not modified during a step
+				if (queue_signalled_push(&mOutQueue, &outEdges[t][i]) != 1)
 					throw SchedulingException();
 				//std::cout << "scheduler: pushed " << after->toString() << std::endl;
 			}
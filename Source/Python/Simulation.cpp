@@ -115,6 +115,8 @@ void Python::Simulation::threadFunction(Python::Simulation *self)
 		}
 
 		if (self->state == State::stopping) {
+			self->sim->restoreThreads();
+
 			std::unique_lock<std::mutex> lk(*self->mut);
 			newState(self, State::stopped);
 			self->cond->notify_one();
@@ -123,6 +125,8 @@ void Python::Simulation::threadFunction(Python::Simulation *self)
 	}
 
 	self->sim->scheduler()->stop();
+	self->sim->outputPipeline().stop();
+	self->sim->restoreThreads();
 
 #ifdef WITH_SHMEM
 	for (auto ifm : self->sim->interfaces())
@@ -636,7 +640,9 @@ PyObject * Python::Simulation::removeEventFD(Simulation *self, PyObject *args) {
 const char *Python::Simulation::docSetScheduler =
 "set_scheduler(scheduler,...)\n"
 "Set the scheduler to be used for parallel simulation, as well as "
-"additional scheduler-specific parameters.\n";
+"additional scheduler-specific parameters. The thread_level and thread_list "
+"schedulers measure the task times during the first tuning_steps steps and "
+"reschedule the tasks accordingly, every retune_period steps if set.\n";
 PyObject* Python::Simulation::setScheduler(Simulation *self, PyObject *args, PyObject *kwargs)
 {
 	const char *outMeasurementFile = "";
@@ -645,16 +651,25 @@ PyObject* Python::Simulation::setScheduler(Simulation *self, PyObject *args, PyO
 	int threads = -1;
 	bool useConditionVariable = false;
 	bool sortTaskTypes = false;
+	unsigned int tuningSteps = 0;
+	unsigned int retunePeriod = 0;
 
-	const char *kwlist[] = {"scheduler", "threads", "out_measurement_file", "in_measurement_file", "use_condition_variable", "sort_task_types", nullptr};
+	const char *kwlist[] = {"scheduler", "threads", "out_measurement_file", "in_measurement_file", "use_condition_variable", "sort_task_types", "tuning_steps", "retune_period", nullptr};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|issbb", (char **) kwlist, &schedName, &threads, &outMeasurementFile, &inMeasurementFile, &useConditionVariable, &sortTaskTypes))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|issbbII", (char **) kwlist, &schedName, &threads, &outMeasurementFile, &inMeasurementFile, &useConditionVariable, &sortTaskTypes, &tuningSteps, &retunePeriod))
 		return nullptr;
 
+	// Scheduler threads are limited by the thread budget of the simulation
+	int budget = static_cast<int>(self->sim->threadBudget());
+	if (threads > budget)
+		threads = budget;
+
 	if (!strcmp(schedName, "sequential")) {
 		self->sim->setScheduler(std::make_shared<SequentialScheduler>(outMeasurementFile));
 	} else if (!strcmp(schedName, "omp_level")) {
 #ifdef WITH_OPENMP
+		if (threads <= 0)
+			threads = budget;
 		self->sim->setScheduler(std::make_shared<OpenMPLevelScheduler>(threads, outMeasurementFile));
 #else
 		PyErr_SetString(PyExc_NotImplementedError, "not implemented on this platform");
@@ -673,11 +688,15 @@ PyObject* Python::Simulation::setScheduler(Simulation *self, PyObject *args, PyO
 		// TODO sensible default (`nproc`?)
 		if (threads <= 0)
 			threads = 1;
-		self->sim->setScheduler(std::make_shared<ThreadLevelScheduler>(threads, outMeasurementFile, inMeasurementFile, useConditionVariable, sortTaskTypes));
+		auto sched = std::make_shared<ThreadLevelScheduler>(threads, outMeasurementFile, inMeasurementFile, useConditionVariable, sortTaskTypes);
+		sched->setOnlineTuning(tuningSteps, retunePeriod);
+		self->sim->setScheduler(sched);
 	} else if (!strcmp(schedName, "thread_list")) {
 		if (threads <= 0)
 			threads = 1;
-		self->sim->setScheduler(std::make_shared<ThreadListScheduler>(threads, outMeasurementFile, inMeasurementFile, useConditionVariable));
+		auto sched = std::make_shared<ThreadListScheduler>(threads, outMeasurementFile, inMeasurementFile, useConditionVariable);
+		sched->setOnlineTuning(tuningSteps, retunePeriod);
+		self->sim->setScheduler(sched);
 	} else {
 		PyErr_SetString(PyExc_ValueError, "invalid scheduler");
 		return nullptr;
@@ -686,6 +705,79 @@ PyObject* Python::Simulation::setScheduler(Simulation *self, PyObject *args, PyO
 	Py_RETURN_NONE;
 }
 
+const char *Python::Simulation::docSetThreadBudget =
+"set_thread_budget(cores)\n"
+"Set the number of cores shared by the scheduler threads and the parallel "
+"kernels inside tasks, 0 for all cores. Call before set_scheduler.\n";
+PyObject* Python::Simulation::setThreadBudget(Simulation *self, PyObject *args)
+{
+	unsigned int cores;
+
+	if (!PyArg_ParseTuple(args, "I", &cores))
+		return nullptr;
+
+	self->sim->setThreadBudget(cores);
+
+	Py_RETURN_NONE;
+}
+
+const char *Python::Simulation::docSetDAELinearSolver =
+"set_dae_linear_solver(solver)\n"
+"Set the linear solver of DAE solvers to 'dense', 'sparse' or 'krylov'. "
+"Call before the simulation is started.\n";
+PyObject* Python::Simulation::setDAELinearSolver(Simulation *self, PyObject *args)
+{
+	const char *solverName;
+
+	if (!PyArg_ParseTuple(args, "s", &solverName))
+		return nullptr;
+
+	if (!strcmp(solverName, "dense"))
+		self->sim->setDAELinearSolver(DPsim::Solver::DAELinearSolver::Dense);
+	else if (!strcmp(solverName, "sparse"))
+		self->sim->setDAELinearSolver(DPsim::Solver::DAELinearSolver::Sparse);
+	else if (!strcmp(solverName, "krylov"))
+		self->sim->setDAELinearSolver(DPsim::Solver::DAELinearSolver::Krylov);
+	else {
+		PyErr_SetString(PyExc_ValueError, "invalid linear solver");
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+const char *Python::Simulation::docSetPipelinedOutput =
+"set_pipelined_output(enabled)\n"
+"Write loggers and interface exports of a step while the next step is "
+"solved. Call before the simulation is started.\n";
+PyObject* Python::Simulation::setPipelinedOutput(Simulation *self, PyObject *args)
+{
+	int enabled;
+
+	if (!PyArg_ParseTuple(args, "p", &enabled))
+		return nullptr;
+
+	self->sim->setPipelinedOutput(enabled);
+
+	Py_RETURN_NONE;
+}
+
+const char *Python::Simulation::docSetStepDeadline =
+"set_step_deadline(seconds)\n"
+"Skip deferrable tasks like loggers when they would finish later than the "
+"given time after the start of a step, 0 to execute all tasks.\n";
+PyObject* Python::Simulation::setStepDeadline(Simulation *self, PyObject *args)
+{
+	double deadline;
+
+	if (!PyArg_ParseTuple(args, "d", &deadline))
+		return nullptr;
+
+	self->sim->setStepDeadline(deadline);
+
+	Py_RETURN_NONE;
+}
+
 #ifdef WITH_GRAPHVIZ
 const char *Python::Simulation::docReprSVG =
 "_repr_svg_()\n"
@@ -791,6 +883,10 @@ PyMethodDef Python::Simulation::methods[] = {
 	{"add_eventfd",   (PyCFunction) Python::Simulation::addEventFD, METH_VARARGS, (char *) Python::Simulation::docAddEventFD},
 	{"remove_eventfd",(PyCFunction) Python::Simulation::removeEventFD, METH_VARARGS, (char *) Python::Simulation::docRemoveEventFD},
 	{"set_scheduler", (PyCFunction) Python::Simulation::setScheduler, METH_VARARGS | METH_KEYWORDS, (char*) Python::Simulation::docSetScheduler},
+	{"set_thread_budget", (PyCFunction) Python::Simulation::setThreadBudget, METH_VARARGS, (char*) Python::Simulation::docSetThreadBudget},
+	{"set_dae_linear_solver", (PyCFunction) Python::Simulation::setDAELinearSolver, METH_VARARGS, (char*) Python::Simulation::docSetDAELinearSolver},
+	{"set_pipelined_output", (PyCFunction) Python::Simulation::setPipelinedOutput, METH_VARARGS, (char*) Python::Simulation::docSetPipelinedOutput},
+	{"set_step_deadline", (PyCFunction) Python::Simulation::setStepDeadline, METH_VARARGS, (char*) Python::Simulation::docSetStepDeadline},
 #ifdef WITH_GRAPHVIZ
 	{"_repr_svg_",    (PyCFunction) Python::Simulation::reprSVG, METH_NOARGS, (char*) Python::Simulation::docReprSVG},
 #endif
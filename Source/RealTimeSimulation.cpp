@@ -76,6 +76,8 @@ void RealTimeSimulation::run(const Timer::StartClock::time_point &startAt) {
 	mLog->info("Simulation finished.");
 
 	mScheduler->stop();
+	mOutputPipeline.stop();
+	restoreThreads();
 
 #ifdef WITH_SHMEM
 	for (auto ifm : mInterfaces)
@@ -8,6 +8,7 @@
 
 #include <dpsim/Scheduler.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
@@ -17,22 +18,122 @@ using namespace CPS;
 using namespace DPsim;
 
 CPS::AttributeBase::Ptr Scheduler::external;
+const UInt Scheduler::maxRatePhases;
+
+static UInt greatestCommonDivisor(UInt a, UInt b) {
+	while (b != 0) {
+		UInt r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+UInt Scheduler::commonRateDivisor(UInt a, UInt b) {
+	UInt x = greatestCommonDivisor(a, b);
+	return x == 0 ? 1 : a / x * b;
+}
+
+void Scheduler::initRatePhases(const Task::List& tasks) {
+	mNumRatePhases = 1;
+	for (auto task : tasks) {
+		// Factor by which the task extends the phases, checked before
+		// multiplying so that the phase count cannot overflow
+		UInt divisor = task->rateDivisor() / greatestCommonDivisor(mNumRatePhases, task->rateDivisor());
+		if (divisor > maxRatePhases / mNumRatePhases) {
+			mSLog->error("Rate divisor {:d} of {:s} leads to more than {:d} rate phases",
+				task->rateDivisor(), task->toString(), maxRatePhases);
+			throw SchedulingException();
+		}
+		mNumRatePhases *= divisor;
+	}
+
+	if (mNumRatePhases > 1)
+		mSLog->info("Creating schedules for {:d} rate phases", mNumRatePhases);
+}
+
+void Scheduler::filterRatePhase(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges,
+	UInt phase, Task::List& phaseTasks, Edges& phaseInEdges, Edges& phaseOutEdges) {
+
+	phaseTasks.clear();
+	phaseInEdges.clear();
+	phaseOutEdges.clear();
+
+	std::unordered_set<Task::Ptr> active;
+	for (auto task : tasks) {
+		if (task->isActive(phase)) {
+			phaseTasks.push_back(task);
+			active.insert(task);
+		}
+	}
+
+	// The dependent tasks of an inactive task use the values from the last
+	// step it was executed in. They still have to run after the active tasks
+	// the inactive task depends on, so these dependencies are followed.
+	for (auto task : phaseTasks) {
+		auto inIt = inEdges.find(task);
+		if (inIt == inEdges.end())
+			continue;
+
+		std::unordered_set<Task::Ptr> visited;
+		std::deque<Task::Ptr> pending(inIt->second.begin(), inIt->second.end());
+		while (!pending.empty()) {
+			auto before = pending.front();
+			pending.pop_front();
+			if (!visited.insert(before).second)
+				continue;
+
+			if (active.count(before)) {
+				phaseInEdges[task].push_back(before);
+				phaseOutEdges[before].push_back(task);
+				continue;
+			}
+			auto transIt = inEdges.find(before);
+			if (transIt != inEdges.end())
+				pending.insert(pending.end(), transIt->second.begin(), transIt->second.end());
+		}
+	}
+}
 
 void Scheduler::initMeasurements(const Task::List& tasks) {
 	// Fill map here already since it's not protected by a mutex
 	for (auto task : tasks) {
 		mMeasurements[task.get()] = std::vector<TaskTime>();
+		if (auto fused = dynamic_cast<FusedTask*>(task.get())) {
+			mFusedTasks[task.get()] = fused;
+			for (auto& fusedTask : fused->tasks())
+				mMeasurements[fusedTask.get()] = std::vector<TaskTime>();
+		}
 	}
 }
 
+void Scheduler::measureFusedTasks(Bool measure) {
+	for (auto& pair : mFusedTasks)
+		pair.second->measureTasks(measure);
+}
+
 void Scheduler::updateMeasurement(Task* ptr, TaskTime time) {
 	mMeasurements[ptr].push_back(time);
+
+	// A task is fused in at most one fused task per rate phase,
+	// so its measurements are still only updated by one thread
+	auto fusedIt = mFusedTasks.find(ptr);
+	if (fusedIt != mFusedTasks.end()) {
+		auto& tasks = fusedIt->second->tasks();
+		auto& times = fusedIt->second->taskTimes();
+		for (size_t i = 0; i < times.size(); i++)
+			mMeasurements[tasks[i].get()].push_back(times[i]);
+	}
 }
 
 void Scheduler::writeMeasurements(String filename) {
 	std::ofstream os(filename);
 	std::unordered_map<String, TaskTime> averages;
 	for (auto& pair : mMeasurements) {
+		// Fused tasks are created again from the tasks they contain, and
+		// tasks that were never executed have no time to be read back
+		if (mFusedTasks.find(pair.first) != mFusedTasks.end() || pair.second.empty())
+			continue;
 		averages[pair.first->toString()] = getAveragedMeasurement(pair.first);
 	}
 	// TODO think of nicer output format
@@ -74,6 +175,69 @@ Scheduler::TaskTime Scheduler::getAveragedMeasurement(CPS::Task* task) {
 	return avg;
 }
 
+void Scheduler::initDeadline(const Task::List& tasks) {
+	mDeferrableTasks.clear();
+	if (!deadlineEnabled())
+		return;
+
+	for (auto task : tasks) {
+		if (task->isDeferrable())
+			mDeferrableTasks[task.get()] = DeferrableTask();
+	}
+}
+
+void Scheduler::postponeDeferrable(Task::List& tasks, const Edges& outEdges) {
+	// A task can be postponed if it is deferrable and all its successors can be
+	std::unordered_set<Task::Ptr> postponed;
+	for (auto it = tasks.rbegin(); it != tasks.rend(); ++it) {
+		auto task = *it;
+		if (!task->isDeferrable())
+			continue;
+		Bool critical = false;
+		auto search = outEdges.find(task);
+		if (search != outEdges.end()) {
+			for (auto after : search->second) {
+				if (after != mRoot && !postponed.count(after))
+					critical = true;
+			}
+		}
+		if (!critical)
+			postponed.insert(task);
+	}
+	std::stable_partition(tasks.begin(), tasks.end(),
+		[&postponed](const Task::Ptr& task) { return !postponed.count(task); });
+}
+
+void Scheduler::executeDeferrable(Task* task, Real time, Int timeStepCount) {
+	auto& deferrable = mDeferrableTasks.at(task);
+	auto start = std::chrono::steady_clock::now();
+	if (start - mStepStart + deferrable.expected > mStepDeadline) {
+		deferrable.shed++;
+		return;
+	}
+
+	task->execute(time, timeStepCount);
+
+	// Follow a rising execution time immediately and a falling one slowly
+	TaskTime duration = std::chrono::steady_clock::now() - start;
+	deferrable.expected = std::max(duration, deferrable.expected - deferrable.expected / 8 + duration / 8);
+}
+
+std::unordered_map<String, UInt> Scheduler::shedTasks() const {
+	std::unordered_map<String, UInt> shed;
+	for (auto& deferrable : mDeferrableTasks)
+		shed[deferrable.first->toString()] = deferrable.second.shed;
+	return shed;
+}
+
+void Scheduler::logShedTasks() {
+	for (auto& deferrable : mDeferrableTasks) {
+		if (deferrable.second.shed > 0)
+			mSLog->warn("Skipped {} {} times to meet the step deadline",
+				deferrable.first->toString(), deferrable.second.shed);
+	}
+}
+
 
 void Scheduler::resolveDeps(Task::List& tasks, Edges& inEdges, Edges& outEdges) {
 	// Create graph (list of out/in edges for each node) from attribute dependencies
@@ -171,6 +335,18 @@ void Scheduler::topologicalSort(const Task::List& tasks, const Edges& inEdges, c
 
 }
 
+UInt Scheduler::graphWidth(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
+	Task::List ordered;
+	std::vector<Task::List> levels;
+	topologicalSort(tasks, inEdges, outEdges, ordered);
+	levelSchedule(ordered, inEdges, outEdges, levels);
+
+	std::size_t width = 1;
+	for (auto& level : levels)
+		width = std::max(width, level.size());
+	return static_cast<UInt>(width);
+}
+
 void Scheduler::levelSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges, std::vector<Task::List>& levels) {
 	std::unordered_map<Task::Ptr, int> time;
 
@@ -187,13 +363,171 @@ void Scheduler::levelSchedule(const Task::List& tasks, const Edges& inEdges, con
 		}
 	}
 
+	int maxLevel = -1;
+	for (auto task : tasks) {
+		if (time[task] > maxLevel)
+			maxLevel = time[task];
+	}
+
 	levels.clear();
-	levels.resize(time[tasks.back()] + 1);
+	levels.resize(maxLevel + 1);
 	for (auto task : tasks) {
 		levels[time[task]].push_back(task);
 	}
 }
 
+void Scheduler::fuseTasks(Task::List& tasks, Edges& inEdges, Edges& outEdges,
+	std::unordered_map<String, TaskTime::rep>& measurements) {
+
+	auto taskTime = [&](const Task::Ptr& task) -> TaskTime::rep {
+		auto it = measurements.find(task->toString());
+		return it != measurements.end() ? it->second : mDefaultTaskTime.count();
+	};
+	// Dependency lists may contain duplicates, one per shared attribute
+	auto uniqueTasks = [](const Edges& edges, const Task::Ptr& task) {
+		std::deque<Task::Ptr> unique;
+		auto it = edges.find(task);
+		if (it != edges.end()) {
+			for (auto other : it->second) {
+				if (std::find(unique.begin(), unique.end(), other) == unique.end())
+					unique.push_back(other);
+			}
+		}
+		return unique;
+	};
+
+	TaskTime::rep granularity = mTaskGranularity.count();
+	std::unordered_map<Task::Ptr, size_t> group;
+	std::vector<Task::List> groups;
+	std::vector<TaskTime::rep> groupTimes;
+
+	// Deferrable tasks stay separate so that they can be skipped at the deadline
+	auto fusable = [this](const Task::Ptr& task) {
+		return !deadlineEnabled() || !task->isDeferrable();
+	};
+
+	// Merge chains of tasks where the first task is the only predecessor
+	// of the second one and the second task is the only successor of the first one
+	for (auto task : tasks) {
+		auto before = uniqueTasks(inEdges, task);
+		if (before.size() == 1 && uniqueTasks(outEdges, before[0]).size() == 1
+			&& groupTimes[group[before[0]]] < granularity
+			&& fusable(task) && fusable(before[0])) {
+			size_t idx = group[before[0]];
+			group[task] = idx;
+			groups[idx].push_back(task);
+			groupTimes[idx] += taskTime(task);
+		} else {
+			group[task] = groups.size();
+			groups.push_back({task});
+			groupTimes.push_back(taskTime(task));
+		}
+	}
+
+	// Groups are ordered by their first task, which is a topological order
+	// since chains can only be entered at the front and left at the back
+	std::vector<int> groupLevels(groups.size(), 0);
+	int maxLevel = 0;
+	for (size_t idx = 0; idx < groups.size(); idx++) {
+		for (auto before : uniqueTasks(inEdges, groups[idx].front())) {
+			if (group[before] != idx)
+				groupLevels[idx] = std::max(groupLevels[idx], groupLevels[group[before]] + 1);
+		}
+		maxLevel = std::max(maxLevel, groupLevels[idx]);
+	}
+
+	// Merge small independent groups of the same level. Every dependency
+	// leads to a higher level, so the fused graph remains acyclic.
+	std::vector<std::vector<Task::List>> bins(maxLevel + 1);
+	std::vector<std::vector<TaskTime::rep>> binTimes(maxLevel + 1);
+	std::vector<int> openBin(maxLevel + 1, -1);
+	for (size_t idx = 0; idx < groups.size(); idx++) {
+		int level = groupLevels[idx];
+		auto& levelBins = bins[level];
+		auto& levelTimes = binTimes[level];
+		Bool small = groupTimes[idx] < granularity && fusable(groups[idx].front());
+		if (small && openBin[level] >= 0) {
+			auto& bin = levelBins[openBin[level]];
+			bin.insert(bin.end(), groups[idx].begin(), groups[idx].end());
+			levelTimes[openBin[level]] += groupTimes[idx];
+		} else {
+			levelBins.push_back(groups[idx]);
+			levelTimes.push_back(groupTimes[idx]);
+			if (small)
+				openBin[level] = static_cast<int>(levelBins.size() - 1);
+		}
+		if (openBin[level] >= 0 && levelTimes[openBin[level]] >= granularity)
+			openBin[level] = -1;
+	}
+
+	Task::List fusedTasks;
+	std::unordered_map<Task::Ptr, Task::Ptr> fusedTask;
+	for (int level = 0; level <= maxLevel; level++) {
+		for (size_t idx = 0; idx < bins[level].size(); idx++) {
+			auto& bin = bins[level][idx];
+			Task::Ptr fused = bin.front();
+			if (bin.size() > 1) {
+				fused = std::make_shared<FusedTask>(bin);
+				measurements[fused->toString()] = binTimes[level][idx];
+			}
+			for (auto task : bin)
+				fusedTask[task] = fused;
+			fusedTasks.push_back(fused);
+		}
+	}
+
+	Edges fusedInEdges, fusedOutEdges;
+	for (auto task : tasks) {
+		Task::Ptr from = fusedTask[task];
+		for (auto after : uniqueTasks(outEdges, task)) {
+			auto toIt = fusedTask.find(after);
+			if (toIt == fusedTask.end() || toIt->second == from)
+				continue;
+			auto& out = fusedOutEdges[from];
+			if (std::find(out.begin(), out.end(), toIt->second) == out.end()) {
+				out.push_back(toIt->second);
+				fusedInEdges[toIt->second].push_back(from);
+			}
+		}
+	}
+
+	mSLog->info("Fused {:d} tasks into {:d} tasks", tasks.size(), fusedTasks.size());
+	tasks.swap(fusedTasks);
+	inEdges.swap(fusedInEdges);
+	outEdges.swap(fusedOutEdges);
+}
+
+// Named after all tasks
+static String fusedTaskName(const Task::List& tasks) {
+	String name = tasks.front()->toString();
+	for (size_t i = 1; i < tasks.size(); i++)
+		name += "+" + tasks[i]->toString();
+	return name;
+}
+
+FusedTask::FusedTask(const Task::List& tasks) :
+	Task(fusedTaskName(tasks)), mTasks(tasks) {
+	for (auto task : mTasks) {
+		auto& deps = task->getAttributeDependencies();
+		mAttributeDependencies.insert(mAttributeDependencies.end(), deps.begin(), deps.end());
+		auto& mods = task->getModifiedAttributes();
+		mModifiedAttributes.insert(mModifiedAttributes.end(), mods.begin(), mods.end());
+	}
+}
+
+void FusedTask::execute(Real time, Int timeStepCount) {
+	if (mTaskTimes.empty()) {
+		for (auto& task : mTasks)
+			task->execute(time, timeStepCount);
+	} else {
+		for (size_t i = 0; i < mTasks.size(); i++) {
+			auto start = std::chrono::steady_clock::now();
+			mTasks[i]->execute(time, timeStepCount);
+			mTaskTimes[i] = std::chrono::steady_clock::now() - start;
+		}
+	}
+}
+
 void BarrierTask::addBarrier(Barrier* b) {
 	mBarriers.push_back(b);
 }
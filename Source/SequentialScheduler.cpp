@@ -20,27 +20,54 @@ using namespace DPsim;
 #include <unordered_map>
 
 void SequentialScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
+	Task::List ordered;
+	Edges phaseInEdges, phaseOutEdges;
+
 	if (mOutMeasurementFile.size() != 0)
 		Scheduler::initMeasurements(tasks);
-	Scheduler::topologicalSort(tasks, inEdges, outEdges, mSchedule);
+	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
+	Scheduler::initRatePhases(ordered);
+
+	Scheduler::initDeadline(ordered);
+
+	mSchedules.resize(mNumRatePhases);
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		Scheduler::filterRatePhase(ordered, inEdges, outEdges, phase, mSchedules[phase], phaseInEdges, phaseOutEdges);
+		if (deadlineEnabled())
+			Scheduler::postponeDeferrable(mSchedules[phase], phaseOutEdges);
+	}
 }
 
 void SequentialScheduler::step(Real time, Int timeStepCount) {
-	if (mOutMeasurementFile.size() != 0) {
-		for (auto task : mSchedule) {
+	auto& schedule = mSchedules[ratePhase(timeStepCount)];
+
+	if (deadlineEnabled()) {
+		Scheduler::startStep();
+		for (auto task : schedule) {
+			auto start = std::chrono::steady_clock::now();
+			if (task->isDeferrable())
+				Scheduler::executeDeferrable(task.get(), time, timeStepCount);
+			else
+				task->execute(time, timeStepCount);
+			if (mOutMeasurementFile.size() != 0)
+				updateMeasurement(task.get(), std::chrono::steady_clock::now() - start);
+		}
+	} else if (mOutMeasurementFile.size() != 0) {
+		for (auto task : schedule) {
 			auto start = std::chrono::steady_clock::now();
 			task->execute(time, timeStepCount);
 			auto end = std::chrono::steady_clock::now();
 			updateMeasurement(task.get(), end-start);
 		}
 	} else {
-		for (auto it : mSchedule) {
+		for (auto it : schedule) {
 			it->execute(time, timeStepCount);
 		}
 	}
 }
 
 void SequentialScheduler::stop() {
+	Scheduler::logShedTasks();
 	if (mOutMeasurementFile.size() != 0)
 		writeMeasurements(mOutMeasurementFile);
 }
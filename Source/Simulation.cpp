@@ -39,6 +39,11 @@
   #include <dpsim/ODESolver.h>
 #endif
 
+#ifdef WITH_ODEINT
+  #include <cps/Solver/ODEintInterface.h>
+  #include <dpsim/ODEintSolver.h>
+#endif
+
 #ifdef WITH_CUDA
 	#include <dpsim/MNASolverGpu.h>
 #endif
@@ -56,8 +61,6 @@ Simulation::Simulation(String name,	Logger::Level logLevel) :
 	addAttribute<Bool>("split_subnets", &mSplitSubnets, Flags::read|Flags::write);
 	addAttribute<Real>("time_step", &mTimeStep, Flags::read);
 
-	Eigen::setNbThreads(1);
-
 	// Logging
 	mLog = Logger::get(name, logLevel, std::max(Logger::Level::info, logLevel));
 
@@ -93,6 +96,29 @@ void Simulation::initialize() {
 
 	mSolvers.clear();
 
+	// Initialization runs before the schedule exists and may use the whole budget.
+	// The thread counts are process-wide, restoreThreads() resets them.
+	UInt cores = threadBudget();
+	if (mPrevMaxThreads == 0) {
+		mPrevMaxThreads = Utils::maxThreads();
+		mPrevEigenThreads = Eigen::nbThreads();
+	}
+	Utils::setMaxThreads(cores);
+	Eigen::setNbThreads(static_cast<int>(cores));
+
+	if (mAdaptiveTimeStep) {
+		// Changing the time step is only implemented by the MNA solver
+		if (mSolverType != Solver::Type::MNA || mTearComponents.size() > 0)
+			throw UnsupportedSolverException();
+
+		if (mTimeStepLevels.empty())
+			mTimeStepLevels = { mTimeStep, 10 * mTimeStep, 100 * mTimeStep };
+		std::sort(mTimeStepLevels.begin(), mTimeStepLevels.end());
+		mTimeStep = mTimeStepLevels[0];
+		mTimeStepLevel = 0;
+		mStepsSinceTimeStepChange = 0;
+	}
+
 	switch (mDomain) {
 	case Domain::DP:
 		createSolvers<Complex>(mSystem, mTearComponents);
@@ -129,6 +155,8 @@ void Simulation::createSolvers(
 	else
 		subnets.push_back(system);
 
+	// Subnets are independent, their solvers may be initialized concurrently below
+	Solver::List initSolvers;
 	for (UInt net = 0; net < subnets.size(); net++) {
 		String copySuffix;
 	   	if (subnets.size() > 1)
@@ -153,15 +181,20 @@ void Simulation::createSolvers(
 					solver->setTimeStep(mTimeStep);
 					solver->doSteadyStateInit(mSteadyStateInit);
 					solver->doFrequencyParallelization(mHarmParallel);
+					solver->setFactorization(mFactorization);
+					solver->setExpectedSteps(static_cast<UInt>(mFinalTime / mTimeStep));
 					solver->setSteadStIniTimeLimit(mSteadStIniTimeLimit);
 					solver->setSteadStIniAccLimit(mSteadStIniAccLimit);
+					solver->setSteadStIniTimeStep(mSteadStIniTimeStep);
+					if (mAdaptiveTimeStep)
+						solver->setTimeStepLevels(mTimeStepLevels);
 					solver->setSystem(subnets[net]);
-					solver->initialize();
+					initSolvers.push_back(solver);
 				}
 				break;
 #ifdef WITH_SUNDIALS
 			case Solver::Type::DAE:
-				solver = std::make_shared<DAESolver>(mName + copySuffix, subnets[net], mTimeStep, 0.0);
+				solver = std::make_shared<DAESolver>(mName + copySuffix, subnets[net], mTimeStep, 0.0, mDAELinearSolver);
 				break;
 #endif /* WITH_SUNDIALS */
 
@@ -171,18 +204,43 @@ void Simulation::createSolvers(
 		mSolvers.push_back(solver);
 	}
 
+	// The automatic factorization benchmarks each solver, which is only
+	// meaningful if the benchmarks do not compete for the cores
+	if (mFactorization == Solver::Factorization::Auto) {
+		for (auto solver : initSolvers)
+			solver->initialize();
+	} else {
+		Utils::parallelFor(initSolvers.size(), [&initSolvers](std::size_t i) {
+			initSolvers[i]->initialize();
+		});
+	}
+
 	// Some components require a dedicated ODE solver.
 	// This solver is independet of the system solver.
 #ifdef WITH_SUNDIALS
 	for (auto comp : system.mComponents) {
 		auto odeComp = std::dynamic_pointer_cast<ODEInterface>(comp);
 		if (odeComp) {
+			if (mAdaptiveTimeStep)
+				throw UnsupportedSolverException();
 			// TODO explicit / implicit integration
 			auto odeSolver = std::make_shared<ODESolver>(
 				odeComp->attribute<String>("name")->get() + "_ODE", odeComp, false, mTimeStep);
 			mSolvers.push_back(odeSolver);
 		}
 	}
+#elif defined(WITH_ODEINT)
+	// Without SUNDIALS, components are integrated by odeint with RK4
+	for (auto comp : system.mComponents) {
+		auto odeComp = std::dynamic_pointer_cast<ODEintInterface>(comp);
+		if (odeComp) {
+			if (mAdaptiveTimeStep)
+				throw UnsupportedSolverException();
+			auto odeSolver = std::make_shared<ODEintSolver>(
+				comp->name() + "_ODE", odeComp, mTimeStep, 0.0);
+			mSolvers.push_back(odeSolver);
+		}
+	}
 #endif /* WITH_SUNDIALS */
 }
 
@@ -212,24 +270,49 @@ void Simulation::prepSchedule() {
 	mTasks.clear();
 	mTaskOutEdges.clear();
 	mTaskInEdges.clear();
+	// The output thread of a previous schedule may still write snapshots
+	mOutputPipeline.stop();
+	mOutputPipeline.clear();
 	for (auto solver : mSolvers) {
 		for (auto t : solver->getTasks()) {
+			// A task of a solver running at a lower rate is executed
+			// at the common multiple of both rate divisors.
+			t->setRateDivisor(Scheduler::commonRateDivisor(t->rateDivisor(), solver->rateDivisor()));
 			mTasks.push_back(t);
 		}
 	}
 #ifdef WITH_SHMEM
 	for (auto intfm : mInterfaces) {
 		for (auto t : intfm.interface->getTasks()) {
+			// Imports remain in the task graph, they are inputs of the step
+			if (mPipelinedOutput && std::dynamic_pointer_cast<Interface::PostStep>(t)) {
+				auto intf = intfm.interface;
+				t = mOutputPipeline.addStage(t,
+					[intf](UInt buffer, Real time, Int timeStepCount) { intf->snapshotValues(buffer, time, timeStepCount); },
+					[intf](UInt buffer) { intf->writeSnapshot(buffer); });
+			}
 			mTasks.push_back(t);
 		}
 	}
 #endif
 	for (auto logger : mLoggers) {
-		mTasks.push_back(logger->getTask());
+		auto t = logger->getTask();
+		if (mPipelinedOutput) {
+			// Resolved here so that the solver and output threads
+			// only read the columns
+			logger->resolveColumns();
+			t = mOutputPipeline.addStage(t,
+				[logger](UInt buffer, Real time, Int timeStepCount) { logger->snapshot(buffer, time, timeStepCount); },
+				[logger](UInt buffer) { logger->writeSnapshot(buffer); });
+		}
+		mTasks.push_back(t);
 	}
 	if (!mScheduler) {
 		mScheduler = std::make_shared<SequentialScheduler>();
 	}
+	if (mStepDeadline > 0)
+		mScheduler->setStepDeadline(std::chrono::duration_cast<Scheduler::TaskTime>(
+			std::chrono::duration<Real>(mStepDeadline)));
 	mScheduler->resolveDeps(mTasks, mTaskInEdges, mTaskOutEdges);
 }
 
@@ -237,9 +320,42 @@ void Simulation::schedule() {
 	mLog->info("Scheduling tasks.");
 	prepSchedule();
 	mScheduler->createSchedule(mTasks, mTaskInEdges, mTaskOutEdges);
+	distributeThreads(threadBudget());
 	mLog->info("Scheduling done.");
 }
 
+UInt Simulation::threadBudget() const {
+	if (mThreadBudget > 0)
+		return mThreadBudget;
+	// While the budget is applied, the process limit is the saved one
+	return mPrevMaxThreads > 0 ? mPrevMaxThreads : Utils::maxThreads();
+}
+
+void Simulation::restoreThreads() {
+	if (mPrevMaxThreads == 0)
+		return;
+
+	Utils::setMaxThreads(mPrevMaxThreads);
+	Eigen::setNbThreads(mPrevEigenThreads);
+	mPrevMaxThreads = 0;
+}
+
+void Simulation::distributeThreads(UInt cores) {
+	// Tasks of the same level run concurrently on the scheduler threads,
+	// the remaining cores are left to the kernels inside each task, e.g.
+	// the factorization of a single large subnet
+	UInt width = mScheduler->graphWidth(mTasks, mTaskInEdges, mTaskOutEdges);
+	UInt taskThreads = std::max<UInt>(std::min(mScheduler->numThreads(), width), 1);
+	UInt kernelThreads = std::max<UInt>(cores / taskThreads, 1);
+	Eigen::setNbThreads(static_cast<int>(kernelThreads));
+
+	if (mThreadBudget > 0 && mScheduler->numThreads() > cores)
+		mLog->warn("Scheduler uses {} threads, exceeding the thread budget of {} cores",
+			mScheduler->numThreads(), cores);
+	mLog->info("Thread budget of {} cores: {} task threads for a task graph width of {}, {} kernel threads per task",
+		cores, taskThreads, width, kernelThreads);
+}
+
 #ifdef WITH_GRAPHVIZ
 Graph::Graph Simulation::dependencyGraph() {
 	if (!mInitialized)
@@ -380,6 +496,8 @@ void Simulation::run() {
 	}
 
 	mScheduler->stop();
+	mOutputPipeline.stop();
+	restoreThreads();
 
 #ifdef WITH_SHMEM
 	for (auto ifm : mInterfaces)
@@ -394,9 +512,18 @@ void Simulation::run() {
 
 Real Simulation::step() {
 	auto start = std::chrono::steady_clock::now();
-	mEvents.handleEvents(mTime);
+	UInt numEvents = mEvents.handleEvents(mTime);
+	// Setpoint changes do not force the smallest time step,
+	// their effect is covered by the error estimate
+	for (auto wheel : mEventWheels)
+		wheel->handleEvents(mTime);
+
+	if (mAdaptiveTimeStep)
+		updateTimeStep(numEvents > 0);
 
 	mScheduler->step(mTime, mTimeStepCount);
+	if (mPipelinedOutput)
+		mOutputPipeline.push();
 
 	mTime += mTimeStep;
 	mTimeStepCount++;
@@ -407,6 +534,47 @@ Real Simulation::step() {
 	return mTime;
 }
 
+void Simulation::updateTimeStep(Bool eventHandled) {
+	UInt level = mTimeStepLevel;
+	if (eventHandled) {
+		// Resolve the transient after an event with the smallest time step
+		level = 0;
+	}
+	else {
+		Real error = 0;
+		for (auto solver : mSolvers)
+			error = std::max(error, solver->localErrorEstimate());
+
+		// The error of the extrapolation scales with the square of the time step
+		if (error > mAdaptiveTimeStepTol && level > 0) {
+			level--;
+		}
+		else if (level + 1 < mTimeStepLevels.size() && mStepsSinceTimeStepChange >= mAdaptiveTimeStepHold) {
+			Real ratio = mTimeStepLevels[level + 1] / mTimeStepLevels[level];
+			if (error * ratio * ratio < 0.5 * mAdaptiveTimeStepTol)
+				level++;
+		}
+	}
+
+	// Do not step over the next event
+	Real nextEvent = mEvents.nextEventTime();
+	while (level > 0 && mTime + mTimeStepLevels[level] > nextEvent)
+		level--;
+
+	if (level == mTimeStepLevel) {
+		mStepsSinceTimeStepChange++;
+		return;
+	}
+
+	mLog->debug("Change time step from {:e} to {:e} at {:f}", mTimeStep, mTimeStepLevels[level], mTime);
+	for (auto solver : mSolvers)
+		solver->setTimeStepLevel(level);
+
+	mTimeStepLevel = level;
+	mTimeStep = mTimeStepLevels[level];
+	mStepsSinceTimeStepChange = 0;
+}
+
 void Simulation::reset() {
 
 	// Resets component states
@@ -419,6 +587,81 @@ void Simulation::reset() {
 	mInitialized = false;
 }
 
+void Simulation::checkpoint(Snapshot& snapshot) {
+	if (!mInitialized)
+		initialize();
+
+	snapshot.clear();
+	snapshot.write(static_cast<UInt>(mSystem.mComponents.size()));
+	snapshot.write(static_cast<UInt>(mSystem.mNodes.size()));
+	snapshot.write(static_cast<UInt>(mSolvers.size()));
+	snapshot.write(mTime);
+	snapshot.write(mTimeStepCount);
+	snapshot.write(mTimeStep);
+	snapshot.write(mTimeStepLevel);
+	snapshot.write(mStepsSinceTimeStepChange);
+
+	for (auto comp : mSystem.mComponents)
+		comp->saveState(snapshot);
+	for (auto node : mSystem.mNodes)
+		node->saveState(snapshot);
+	for (auto solver : mSolvers)
+		solver->saveState(snapshot);
+
+	mLog->info("Stored checkpoint at {:f} s ({:d} bytes)", mTime, snapshot.size());
+}
+
+void Simulation::restore(Snapshot& snapshot) {
+	if (!mInitialized)
+		initialize();
+
+	snapshot.rewind();
+	UInt numComponents, numNodes, numSolvers;
+	snapshot.read(numComponents);
+	snapshot.read(numNodes);
+	snapshot.read(numSolvers);
+	if (numComponents != mSystem.mComponents.size()
+		|| numNodes != mSystem.mNodes.size()
+		|| numSolvers != mSolvers.size())
+		throw SystemError("Snapshot does not match the simulation");
+
+	snapshot.read(mTime);
+	snapshot.read(mTimeStepCount);
+	snapshot.read(mTimeStep);
+	snapshot.read(mTimeStepLevel);
+	snapshot.read(mStepsSinceTimeStepChange);
+
+	for (auto comp : mSystem.mComponents)
+		comp->loadState(snapshot);
+	for (auto node : mSystem.mNodes)
+		node->loadState(snapshot);
+	for (auto solver : mSolvers)
+		solver->loadState(snapshot);
+
+	if (!snapshot.atEnd())
+		throw SystemError("Snapshot does not match the simulation");
+
+	// The schedule continues with the restored step
+	mScheduler->reset(mTimeStepCount);
+
+	mLog->info("Restored checkpoint at {:f} s", mTime);
+}
+
+std::vector<MatrixComp> Simulation::impedanceSweep(const std::vector<Real>& frequencies,
+	const TopologicalNode::List& nodes) {
+	if (!mInitialized)
+		initialize();
+
+	if (mSolvers.size() != 1)
+		throw SystemError("Frequency sweep requires a single MNA solver");
+
+	if (auto solver = std::dynamic_pointer_cast<MnaSolver<Complex>>(mSolvers[0]))
+		return solver->impedanceSweep(frequencies, nodes);
+	if (auto solver = std::dynamic_pointer_cast<MnaSolver<Real>>(mSolvers[0]))
+		return solver->impedanceSweep(frequencies, nodes);
+	throw SystemError("Frequency sweep requires a single MNA solver");
+}
+
 void Simulation::logStepTimes(String logName) {
 	auto stepTimeLog = Logger::get(logName, Logger::Level::info);
 	Logger::setLogPattern(stepTimeLog, "%v");
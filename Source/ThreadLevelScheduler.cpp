@@ -21,35 +21,78 @@ ThreadLevelScheduler::ThreadLevelScheduler(Int threads, String outMeasurementFil
 
 void ThreadLevelScheduler::createSchedule(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges) {
 	Task::List ordered;
-	std::vector<Task::List> levels;
+	Task::List phaseTasks;
+	Edges phaseInEdges, phaseOutEdges;
+	std::unordered_map<String, TaskTime::rep> measurements;
+	Edges scheduleInEdges = inEdges;
 
 	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
 	Scheduler::initMeasurements(ordered);
-
-	Scheduler::levelSchedule(ordered, inEdges, outEdges, levels);
+	Scheduler::initRatePhases(ordered);
 
 	if (!mInMeasurementFile.empty()) {
-		std::unordered_map<String, TaskTime::rep> measurements;
 		readMeasurements(mInMeasurementFile, measurements);
-		for (size_t level = 0; level < levels.size(); level++) {
-			// Distribute tasks such that the execution time is (approximately) minimized
-			scheduleLevel(levels[level], measurements, inEdges);
+
+		// Check that measurements map is complete, fused tasks are
+		// checked when the levels are scheduled
+		for (auto task : ordered) {
+			if (measurements.find(task->toString()) == measurements.end())
+				throw SchedulingException();
+		}
+	}
+
+	mLevels.resize(mNumRatePhases);
+	mPhaseInEdges.resize(mNumRatePhases);
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		Scheduler::filterRatePhase(ordered, inEdges, outEdges, phase, phaseTasks, phaseInEdges, phaseOutEdges);
+		if (fuseTasksEnabled()) {
+			Scheduler::fuseTasks(phaseTasks, phaseInEdges, phaseOutEdges, measurements);
+			Scheduler::initMeasurements(phaseTasks);
+		}
+		// Fused tasks and dependencies that bypass inactive tasks only exist
+		// in this phase, dependencies on tasks of other phases are skipped
+		// when the schedule is finished
+		for (auto& edges : phaseInEdges) {
+			auto& deps = scheduleInEdges[edges.first];
+			for (auto before : edges.second) {
+				if (std::find(deps.begin(), deps.end(), before) == deps.end())
+					deps.push_back(before);
+			}
 		}
+		Scheduler::levelSchedule(phaseTasks, phaseInEdges, phaseOutEdges, mLevels[phase]);
+		mPhaseInEdges[phase] = phaseInEdges;
+	}
+
+	TaskLists schedules;
+	if (!mInMeasurementFile.empty()) {
+		scheduleTasks(measurements, schedules);
 	} else {
-		for (size_t level = 0; level < levels.size(); level++) {
-			if (mSortTaskTypes)
-				sortTasksByType(levels[level].begin(), levels[level].end());
-			// Distribute tasks of one level evenly between threads
-			for (Int thread = 0; thread < mNumThreads; thread++) {
-				Int start = static_cast<Int>(levels[level].size()) * thread / mNumThreads;
-				Int end = static_cast<Int>(levels[level].size()) * (thread + 1) / mNumThreads;
-				for (int idx = start; idx != end; idx++)
-					scheduleTask(thread, levels[level][idx]);
+		for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+			auto& levels = mLevels[phase];
+			for (size_t level = 0; level < levels.size(); level++) {
+				if (mSortTaskTypes)
+					sortTasksByType(levels[level].begin(), levels[level].end());
+				// Distribute tasks of one level evenly between threads
+				for (Int thread = 0; thread < mNumThreads; thread++) {
+					Int start = static_cast<Int>(levels[level].size()) * thread / mNumThreads;
+					Int end = static_cast<Int>(levels[level].size()) * (thread + 1) / mNumThreads;
+					for (int idx = start; idx != end; idx++)
+						scheduleTask(schedules, thread, levels[level][idx], phase);
+				}
 			}
 		}
 	}
 
-	ThreadScheduler::finishSchedule(inEdges);
+	ThreadScheduler::finishSchedule(schedules, scheduleInEdges);
+}
+
+void ThreadLevelScheduler::scheduleTasks(const std::unordered_map<String, TaskTime::rep>& measurements, TaskLists& schedules) const {
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		for (size_t level = 0; level < mLevels[phase].size(); level++) {
+			// Distribute tasks such that the execution time is (approximately) minimized
+			scheduleLevel(mLevels[phase][level], measurements, mPhaseInEdges[phase], phase, schedules);
+		}
+	}
 }
 
 void ThreadLevelScheduler::sortTasksByType(Task::List::iterator begin, CPS::Task::List::iterator end) {
@@ -69,7 +112,7 @@ void ThreadLevelScheduler::sortTasksByType(Task::List::iterator begin, CPS::Task
 	std::sort(begin, end, cmp);
 }
 
-void ThreadLevelScheduler::scheduleLevel(const Task::List& tasks, const std::unordered_map<String, TaskTime::rep>& measurements, const Edges& inEdges) {
+void ThreadLevelScheduler::scheduleLevel(const Task::List& tasks, const std::unordered_map<String, TaskTime::rep>& measurements, const Edges& inEdges, UInt phase, TaskLists& schedules) const {
 	Task::List tasksSorted = tasks;
 
 	// Check that measurements map is complete
@@ -94,7 +137,7 @@ void ThreadLevelScheduler::scheduleLevel(const Task::List& tasks, const std::uno
 		for (int thread = 0; thread < mNumThreads; thread++) {
 			TaskTime::rep curTime = 0;
 			while (curTime < avgTime && task < tasksSorted.size()) {
-				scheduleTask(thread, tasksSorted[task]);
+				scheduleTask(schedules, thread, tasksSorted[task], phase);
 				curTime += measurements.at(tasksSorted[task]->toString());
 				task++;
 			}
@@ -102,7 +145,7 @@ void ThreadLevelScheduler::scheduleLevel(const Task::List& tasks, const std::uno
 		// All tasks should be distributed, but just to be sure, put the remaining
 		// ones to the last thread
 		for (; task < tasksSorted.size(); task++)
-			scheduleTask(mNumThreads-1, tasksSorted[task]);
+			scheduleTask(schedules, mNumThreads-1, tasksSorted[task], phase);
 	}
 	else {
 		// Sort tasks in descending execution time
@@ -116,7 +159,7 @@ void ThreadLevelScheduler::scheduleLevel(const Task::List& tasks, const std::uno
 		for (auto task : tasksSorted) {
 			auto minIt = std::min_element(totalTimes.begin(), totalTimes.end());
 			Int minIdx = static_cast<UInt>(minIt - totalTimes.begin());
-			scheduleTask(minIdx, task);
+			scheduleTask(schedules, minIdx, task, phase);
 			totalTimes[minIdx] += measurements.at(task->toString());
 		}
 	}
@@ -8,6 +8,7 @@
 
 #include <dpsim/ThreadListScheduler.h>
 
+#include <algorithm>
 #include <queue>
 
 using namespace CPS;
@@ -23,7 +24,6 @@ void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& i
 	Scheduler::topologicalSort(tasks, inEdges, outEdges, ordered);
 	Scheduler::initMeasurements(ordered);
 
-	std::unordered_map<Task::Ptr, int64_t> priorities;
 	std::unordered_map<String, TaskTime::rep> measurements;
 	if (!mInMeasurementFile.empty()) {
 		readMeasurements(mInMeasurementFile, measurements);
@@ -34,14 +34,58 @@ void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& i
 				throw SchedulingException();
 		}
 	} else {
-		// Insert constant cost for each task (HLFNET)
+		// Insert constant cost for each task (HLFNET), fused tasks
+		// cost as much as the tasks they contain
 		for (auto task : ordered) {
-			measurements[task->toString()] = 1;
+			measurements[task->toString()] = mDefaultTaskTime.count();
+		}
+	}
+
+	Scheduler::initRatePhases(ordered);
+
+	Edges scheduleInEdges = inEdges;
+	mPhaseTasks.resize(mNumRatePhases);
+	mPhaseInEdges.resize(mNumRatePhases);
+	mPhaseOutEdges.resize(mNumRatePhases);
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		Scheduler::filterRatePhase(ordered, inEdges, outEdges, phase, mPhaseTasks[phase], mPhaseInEdges[phase], mPhaseOutEdges[phase]);
+		if (fuseTasksEnabled()) {
+			Scheduler::fuseTasks(mPhaseTasks[phase], mPhaseInEdges[phase], mPhaseOutEdges[phase], measurements);
+			Scheduler::initMeasurements(mPhaseTasks[phase]);
+		}
+		// Fused tasks need a cost as well
+		for (auto task : mPhaseTasks[phase]) {
+			if (measurements.find(task->toString()) == measurements.end())
+				throw SchedulingException();
+		}
+		// Fused tasks and dependencies that bypass inactive tasks only exist
+		// in this phase, dependencies on tasks of other phases are skipped
+		// when the schedule is finished
+		for (auto& edges : mPhaseInEdges[phase]) {
+			auto& deps = scheduleInEdges[edges.first];
+			for (auto before : edges.second) {
+				if (std::find(deps.begin(), deps.end(), before) == deps.end())
+					deps.push_back(before);
+			}
 		}
 	}
+	TaskLists schedules;
+	scheduleTasks(measurements, schedules);
+
+	ThreadScheduler::finishSchedule(schedules, scheduleInEdges);
+}
+
+void ThreadListScheduler::scheduleTasks(const std::unordered_map<String, TaskTime::rep>& measurements, TaskLists& schedules) const {
+	for (UInt phase = 0; phase < mNumRatePhases; phase++)
+		scheduleList(mPhaseTasks[phase], mPhaseInEdges[phase], mPhaseOutEdges[phase], measurements, phase, schedules);
+}
+
+void ThreadListScheduler::scheduleList(const Task::List& tasks, const Edges& inEdges, const Edges& outEdges,
+	const std::unordered_map<String, TaskTime::rep>& measurements, UInt phase, TaskLists& schedules) const {
+	std::unordered_map<Task::Ptr, int64_t> priorities;
 
 	// HLFET
-	for (auto it = ordered.rbegin(); it != ordered.rend(); ++it) {
+	for (auto it = tasks.rbegin(); it != tasks.rend(); ++it) {
 		auto task = *it;
 		int64_t maxLevel = 0;
 		if (outEdges.find(task) != outEdges.end()) {
@@ -58,12 +102,9 @@ void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& i
 		return priorities[p1] < priorities[p2];
 	};
 	std::priority_queue<Task::Ptr, std::deque<Task::Ptr>, decltype(cmp)> queue(cmp);
-	for (auto task : ordered) {
-		if (inEdges.find(task) == inEdges.end() || inEdges.at(task).empty()) {
+	for (auto task : tasks) {
+		if (inEdges.find(task) == inEdges.end() || inEdges.at(task).empty())
 			queue.push(task);
-		} else {
-			break;
-		}
 	}
 
 	std::vector<TaskTime::rep> totalTimes(mNumThreads, 0);
@@ -74,7 +115,7 @@ void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& i
 
 		auto minIt = std::min_element(totalTimes.begin(), totalTimes.end());
 		Int minIdx = static_cast<UInt>(minIt - totalTimes.begin());
-		scheduleTask(minIdx, task);
+		scheduleTask(schedules, minIdx, task, phase);
 		totalTimes[minIdx] += measurements.at(task->toString());
 
 		if (outEdges.find(task) != outEdges.end()) {
@@ -85,12 +126,10 @@ void ThreadListScheduler::createSchedule(const Task::List& tasks, const Edges& i
 						break;
 					}
 				}
-				if (inEdgesCpy[after].empty() && std::find(ordered.begin(), ordered.end(), after) != ordered.end()) {
+				if (inEdgesCpy[after].empty() && std::find(tasks.begin(), tasks.end(), after) != tasks.end()) {
 					queue.push(after);
 				}
 			}
 		}
 	}
-
-	ThreadScheduler::finishSchedule(inEdges);
 }
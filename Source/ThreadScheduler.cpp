@@ -8,7 +8,10 @@
 
 #include <dpsim/ThreadScheduler.h>
 
+#include <cmath>
+#include <limits>
 #include <iostream>
+#include <unordered_set>
 
 using namespace CPS;
 using namespace DPsim;
@@ -17,62 +20,197 @@ ThreadScheduler::ThreadScheduler(Int threads, String outMeasurementFile, Bool us
 	mNumThreads(threads), mOutMeasurementFile(outMeasurementFile), mStartBarrier(threads, useConditionVariable) {
 	if (threads < 1)
 		throw SchedulingException();
-	mTempSchedules.resize(threads);
-	mSchedules.resize(threads, nullptr);
+	mMeasure = !outMeasurementFile.empty();
 }
 
 ThreadScheduler::~ThreadScheduler() {
-	for (int i = 0; i < mNumThreads; i++)
-		delete[] mSchedules[i];
+	if (mPendingSchedule.valid())
+		mPendingSchedule.wait();
 }
 
-void ThreadScheduler::scheduleTask(int thread, CPS::Task::Ptr task) {
-	mTempSchedules[thread].push_back(task);
+void ThreadScheduler::setOnlineTuning(UInt tuningSteps, UInt retunePeriod, Real driftTolerance) {
+	mTuningSteps = tuningSteps;
+	mRetunePeriod = retunePeriod;
+	mDriftTolerance = driftTolerance;
+	mNextTuning = static_cast<Int>(tuningSteps);
+	mMeasure = !mOutMeasurementFile.empty() || tuningSteps > 0;
 }
 
-void ThreadScheduler::finishSchedule(const Edges& inEdges) {
-	std::map<CPS::Task::Ptr, Counter*> counters;
-	for (int thread = 0; thread < mNumThreads; thread++) {
-	//	std::cout << "Thread " << thread << std::endl;
-	//	for (auto& entry : mSchedules[thread]) {
-	//		Task* t = entry.task.get();
-	//		char *refpos = reinterpret_cast<char*>(reinterpret_cast<void*>(t)) + sizeof(Task);
-	//		void *ref = *(reinterpret_cast<void**>(refpos));
-	//		std::cout << entry.task->toString() << " " << ref << std::endl;
-	//	}
-		mSchedules[thread] = new ScheduleEntry[mTempSchedules[thread].size()];
-		for (size_t i = 0; i < mTempSchedules[thread].size(); i++) {
-			auto& task = mTempSchedules[thread][i];
-			mSchedules[thread][i].task = task.get();
-			counters[task] = &mSchedules[thread][i].endCounter;
-		}
+void ThreadScheduler::scheduleTask(TaskLists& schedules, int thread, CPS::Task::Ptr task, UInt phase) const {
+	if (phase >= schedules.size())
+		schedules.resize(phase + 1, std::vector<Task::List>(mNumThreads));
+	schedules[phase][thread].push_back(task);
+}
+
+void ThreadScheduler::finishSchedule(const TaskLists& schedules, const Edges& inEdges) {
+	mSchedule = createEntries(schedules, inEdges);
+
+	std::unordered_set<Task::Ptr> scheduled;
+	for (auto& phaseSchedules : mSchedule->tasks) {
+		for (auto& schedule : phaseSchedules)
+			scheduled.insert(schedule.begin(), schedule.end());
+	}
+	mScheduledTasks.assign(scheduled.begin(), scheduled.end());
+	mScheduleInEdges = inEdges;
+	Scheduler::initDeadline(mScheduledTasks);
+	Scheduler::measureFusedTasks(mMeasure);
+
+	for (int i = 1; i < mNumThreads; i++) {
+		mThreads.emplace_back(threadFunction, this, i);
 	}
-	for (int thread = 0; thread < mNumThreads; thread++) {
-		for (size_t i = 0; i < mTempSchedules[thread].size(); i++) {
-			auto& task = mTempSchedules[thread][i];
-			if (inEdges.find(task) != inEdges.end()) {
-				for (auto req : inEdges.at(task)) {
-					mSchedules[thread][i].reqCounters.push_back(counters[req]);
+}
+
+std::unique_ptr<ThreadScheduler::Schedule> ThreadScheduler::createEntries(const TaskLists& schedules, const Edges& inEdges) const {
+	auto schedule = std::unique_ptr<Schedule>(new Schedule());
+	schedule->tasks = schedules;
+	schedule->tasks.resize(mNumRatePhases, std::vector<Task::List>(mNumThreads));
+	schedule->entries.resize(mNumRatePhases);
+	schedule->phaseCountOffsets.resize(mNumRatePhases, 0);
+
+	// Each rate phase has its own counters. They are incremented once every
+	// time the phase is executed, so dependencies between tasks that are
+	// executed at different rates never have to be synchronized.
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		std::map<CPS::Task::Ptr, Counter*> counters;
+		auto& phaseEntries = schedule->entries[phase];
+		phaseEntries.resize(mNumThreads);
+		for (int thread = 0; thread < mNumThreads; thread++) {
+			auto& tempSchedule = schedule->tasks[phase][thread];
+			phaseEntries[thread] = std::vector<ScheduleEntry>(tempSchedule.size());
+			for (size_t i = 0; i < tempSchedule.size(); i++) {
+				auto& task = tempSchedule[i];
+				phaseEntries[thread][i].task = task.get();
+				counters[task] = &phaseEntries[thread][i].endCounter;
+			}
+		}
+		for (int thread = 0; thread < mNumThreads; thread++) {
+			auto& tempSchedule = schedule->tasks[phase][thread];
+			for (size_t i = 0; i < tempSchedule.size(); i++) {
+				auto& task = tempSchedule[i];
+				if (inEdges.find(task) != inEdges.end()) {
+					for (auto req : inEdges.at(task)) {
+						// Tasks that are not executed in this phase are skipped
+						auto it = counters.find(req);
+						if (it != counters.end())
+							phaseEntries[thread][i].reqCounters.push_back(it->second);
+					}
 				}
 			}
 		}
 	}
-	for (int i = 1; i < mNumThreads; i++) {
-		mThreads.emplace_back(threadFunction, this, i);
-	}
+	return schedule;
 }
 
 void ThreadScheduler::step(Real time, Int timeStepCount) {
+	if (onlineTuning())
+		tune(timeStepCount);
+
 	mTime = time;
 	mTimeStepCount = timeStepCount;
+	mStepsStarted++;
+	if (deadlineEnabled())
+		Scheduler::startStep();
 	mStartBarrier.wait();
 	doStep(0);
 	// since we don't have a final BarrierTask, wait for all threads to finish
 	// their last task explicitly
+	UInt phase = ratePhase(mTimeStepCount);
+	Int count = phaseCount(mTimeStepCount);
 	for (int thread = 1; thread < mNumThreads; thread++) {
-		if (mTempSchedules[thread].size() != 0)
-			mSchedules[thread][mTempSchedules[thread].size()-1].endCounter.wait(mTimeStepCount+1);
+		auto& entries = mSchedule->entries[phase][thread];
+		if (!entries.empty())
+			entries.back().endCounter.wait(count);
+	}
+}
+
+void ThreadScheduler::reset(Int timeStepCount) {
+	// The counters of the active schedule count the executed steps,
+	// so they are recreated for a schedule that continues at another step
+	waitForThreads();
+	// A schedule recreated in the background is discarded, it was measured
+	// in steps that are not continued
+	if (mPendingSchedule.valid())
+		mPendingSchedule.get();
+	auto schedule = createEntries(mSchedule->tasks, mScheduleInEdges);
+	schedule->measurements = mSchedule->measurements;
+	mSchedule = std::move(schedule);
+	rebase(timeStepCount);
+}
+
+void ThreadScheduler::rebase(Int timeStepCount) {
+	for (UInt phase = 0; phase < mNumRatePhases; phase++) {
+		// First step from the given one that executes the phase
+		Int first = timeStepCount + static_cast<Int>((phase + mNumRatePhases - ratePhase(timeStepCount)) % mNumRatePhases);
+		mSchedule->phaseCountOffsets[phase] = first / static_cast<Int>(mNumRatePhases);
+	}
+}
+
+void ThreadScheduler::waitForThreads() {
+	// Threads without tasks in the last step may not have returned to the barrier yet
+	mFinishedThreads.wait(mStepsStarted * (mNumThreads - 1));
+}
+
+void ThreadScheduler::tune(Int timeStepCount) {
+	// Schedules are only exchanged between two executions of all rate phases,
+	// so that the counters of the new schedule can start at zero
+	if (ratePhase(timeStepCount) != 0)
+		return;
+
+	if (mPendingSchedule.valid()) {
+		if (mPendingSchedule.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+		waitForThreads();
+		mSchedule = mPendingSchedule.get();
+		rebase(timeStepCount);
+		mMeasure = !mOutMeasurementFile.empty() || mRetunePeriod > 0;
+		Scheduler::measureFusedTasks(mMeasure);
+		mTunedSchedules++;
+		return;
+	}
+
+	if (timeStepCount < mNextTuning)
+		return;
+
+	waitForThreads();
+	auto measurements = collectMeasurements();
+	mNextTuning = mRetunePeriod > 0 ? timeStepCount + static_cast<Int>(mRetunePeriod) : std::numeric_limits<Int>::max();
+
+	// Keep the current schedule if the task times did not change much
+	auto& scheduleMeasurements = mSchedule->measurements;
+	if (!scheduleMeasurements.empty()) {
+		TaskTime::rep total = 0, deviation = 0;
+		for (auto& measurement : measurements) {
+			auto it = scheduleMeasurements.find(measurement.first);
+			TaskTime::rep scheduled = it != scheduleMeasurements.end() ? it->second : 0;
+			total += scheduled;
+			deviation += std::abs(measurement.second - scheduled);
+		}
+		if (deviation <= mDriftTolerance * total)
+			return;
 	}
+
+	// The new schedule is only built from copies, the scheduler is
+	// not changed until the schedule is activated
+	Edges inEdges = mScheduleInEdges;
+	mPendingSchedule = std::async(std::launch::async, [this, measurements, inEdges]() {
+		TaskLists schedules(mNumRatePhases, std::vector<Task::List>(mNumThreads));
+		scheduleTasks(measurements, schedules);
+		auto schedule = createEntries(schedules, inEdges);
+		schedule->measurements = measurements;
+		return schedule;
+	});
+}
+
+std::unordered_map<String, Scheduler::TaskTime::rep> ThreadScheduler::collectMeasurements() {
+	std::unordered_map<String, TaskTime::rep> measurements;
+	for (auto task : mScheduledTasks) {
+		TaskTime time = getAveragedMeasurement(task);
+		// Tasks that were not executed keep the default time
+		measurements[task->toString()] = time > TaskTime::zero() ? time.count() : mDefaultTaskTime.count();
+	}
+	// Start a new measurement window
+	Scheduler::initMeasurements(mScheduledTasks);
+	return measurements;
 }
 
 void ThreadScheduler::stop() {
@@ -86,6 +224,7 @@ void ThreadScheduler::stop() {
 	if (!mOutMeasurementFile.empty()) {
 		writeMeasurements(mOutMeasurementFile);
 	}
+	Scheduler::logShedTasks();
 }
 
 void ThreadScheduler::threadFunction(ThreadScheduler* sched, Int idx) {
@@ -95,25 +234,40 @@ void ThreadScheduler::threadFunction(ThreadScheduler* sched, Int idx) {
 			return;
 
 		sched->doStep(idx);
+		sched->mFinishedThreads.inc();
 	}
 }
 
 void ThreadScheduler::doStep(Int thread) {
-	if (mOutMeasurementFile.empty()) {
-		for (size_t i = 0; i != mTempSchedules[thread].size(); i++) {
-			ScheduleEntry* entry = &mSchedules[thread][i];
+	UInt phase = ratePhase(mTimeStepCount);
+	Int count = phaseCount(mTimeStepCount);
+	auto& entries = mSchedule->entries[phase][thread];
+	size_t scheduleSize = entries.size();
+	ScheduleEntry* schedule = entries.data();
+
+	Bool deadline = deadlineEnabled();
+	if (!mMeasure) {
+		for (size_t i = 0; i != scheduleSize; i++) {
+			ScheduleEntry* entry = &schedule[i];
 			for (Counter* counter : entry->reqCounters)
-				counter->wait(mTimeStepCount+1);
-			entry->task->execute(mTime, mTimeStepCount);
+				counter->wait(count);
+			// Skipped tasks still release the tasks waiting for them
+			if (deadline && entry->task->isDeferrable())
+				executeDeferrable(entry->task, mTime, mTimeStepCount);
+			else
+				entry->task->execute(mTime, mTimeStepCount);
 			entry->endCounter.inc();
 		}
 	} else {
-		for (size_t i = 0; i != mTempSchedules[thread].size(); i++) {
-			ScheduleEntry* entry = &mSchedules[thread][i];
+		for (size_t i = 0; i != scheduleSize; i++) {
+			ScheduleEntry* entry = &schedule[i];
 			for (Counter* counter : entry->reqCounters)
-				counter->wait(mTimeStepCount+1);
+				counter->wait(count);
 			auto start = std::chrono::steady_clock::now();
-			entry->task->execute(mTime, mTimeStepCount);
+			if (deadline && entry->task->isDeferrable())
+				executeDeferrable(entry->task, mTime, mTimeStepCount);
+			else
+				entry->task->execute(mTime, mTimeStepCount);
 			auto end = std::chrono::steady_clock::now();
 			updateMeasurement(entry->task, end-start);
 			entry->endCounter.inc();
@@ -11,6 +11,10 @@
 #include <dpsim/Config.h>
 #include <dpsim/Utils.h>
 
+#ifdef WITH_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace DPsim;
 using namespace DPsim::Utils;
 using namespace CPS;
@@ -343,3 +347,17 @@ std::list<fs::path> DPsim::Utils::findFiles(std::list<fs::path> filennames, cons
 
 	return foundnames;
 }
+
+UInt DPsim::Utils::maxThreads() {
+#ifdef WITH_OPENMP
+	return static_cast<UInt>(omp_get_max_threads());
+#else
+	return 1;
+#endif
+}
+
+void DPsim::Utils::setMaxThreads(UInt threads) {
+#ifdef WITH_OPENMP
+	omp_set_num_threads(static_cast<int>(std::max<UInt>(threads, 1)));
+#endif
+}
@@ -15,6 +15,14 @@ else()
     find_library(SUNDIALS_IDAS_LIBRARY   NAMES sundials_idas)
     find_library(SUNDIALS_KINSOL_LIBRARY NAMES sundials_kinsol)
 
+    # Optional sparse direct solver
+    find_library(SUNDIALS_KLU_LIBRARY    NAMES sundials_sunlinsolklu)
+    find_library(KLU_LIBRARY             NAMES klu)
+    if(SUNDIALS_KLU_LIBRARY AND KLU_LIBRARY)
+        set(Sundials_KLU_FOUND ON)
+        set(SUNDIALS_KLU_LIBRARIES ${SUNDIALS_KLU_LIBRARY} ${KLU_LIBRARY})
+    endif()
+
     set(SUNDIALS_LIBRARIES
         ${SUNDIALS_ARKODE_LIBRARY}
         ${SUNDIALS_CVODE_LIBRARY}
@@ -27,5 +35,5 @@ else()
     # handle the QUIETLY and REQUIRED arguments and set SUNDIALS_FOUND to TRUE
     # if all listed variables are TRUE
     find_package_handle_standard_args(Sundials DEFAULT_MSG SUNDIALS_ARKODE_LIBRARY SUNDIALS_INCLUDE_DIR)
-    mark_as_advanced(SUNDIALS_INCLUDE_DIR)
+    mark_as_advanced(SUNDIALS_INCLUDE_DIR SUNDIALS_KLU_LIBRARY KLU_LIBRARY)
 endif()
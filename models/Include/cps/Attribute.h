@@ -12,6 +12,7 @@
 #include <cps/Definitions.h>
 #include <cps/PtrFactory.h>
 #include <cps/MathUtils.h>
+#include <cps/Snapshot.h>
 #include <cps/Config.h>
 
 #ifdef WITH_PYTHON
@@ -76,6 +77,11 @@ namespace Flags {
 
 		virtual void reset() = 0;
 
+		/// Append the value to a snapshot
+		virtual void saveState(Snapshot& snapshot) { }
+		/// Read the value from a snapshot
+		virtual void loadState(Snapshot& snapshot) { }
+
 		static AttributeBase::Ptr getRefAttribute(AttributeBase::Ptr& attr) {
 			AttributeBase::Ptr& p = attr;
 			while (p && p->mRefAttribute)
@@ -109,6 +115,15 @@ namespace Flags {
 		Setter mSetter;
 		Getter mGetter;
 
+		template <typename U>
+		static void saveValue(Snapshot& snapshot, const U& value, std::true_type) { snapshot.write(value); }
+		template <typename U>
+		static void saveValue(Snapshot& snapshot, const U& value, std::false_type) { }
+		template <typename U>
+		static void loadValue(Snapshot& snapshot, U& value, std::true_type) { snapshot.read(value); }
+		template <typename U>
+		static void loadValue(Snapshot& snapshot, U& value, std::false_type) { }
+
 	public:
 		typedef T Type;
 		typedef std::shared_ptr<Attribute<T>> Ptr;
@@ -176,6 +191,18 @@ namespace Flags {
 				set(resetValue);
 		}
 
+		/// Only attributes with their own storage and a value type
+		/// supported by the snapshot are part of a snapshot
+		void saveState(Snapshot& snapshot) {
+			if (!(mFlags & Flags::getter))
+				saveValue(snapshot, *mValue, SnapshotSupported<T>());
+		}
+
+		void loadState(Snapshot& snapshot) {
+			if (!(mFlags & Flags::getter))
+				loadValue(snapshot, *mValue, SnapshotSupported<T>());
+		}
+
 		T getByValue() const {
 			// Check access
 			if (mFlags & Flags::read) {
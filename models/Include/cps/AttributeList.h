@@ -120,5 +120,20 @@ namespace CPS {
 				a.second->reset();
 			}
 		}
+
+		/// Store the values of all attributes in a snapshot.
+		/// Objects with states that are not attributes extend this.
+		virtual void saveState(Snapshot& snapshot) {
+			for (auto a : mAttributes) {
+				a.second->saveState(snapshot);
+			}
+		}
+
+		/// Restore the values of all attributes from a snapshot
+		virtual void loadState(Snapshot& snapshot) {
+			for (auto a : mAttributes) {
+				a.second->loadState(snapshot);
+			}
+		}
 	};
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cps/Definitions.h>
+#include <cps/Snapshot.h>
 #include <cps/Signal/Exciter.h>
 #include <cps/Signal/TurbineGovernor.h>
 
@@ -250,6 +251,10 @@ namespace Base {
 		void calcStateSpaceMatrixDQ();
 		///
 		Real calcHfromJ(Real J, Real omegaNominal, Int polePairNumber);
+		/// Write the machine state variables to a snapshot
+		void saveMachineState(Snapshot& snapshot);
+		/// Read the machine state variables from a snapshot
+		void loadMachineState(Snapshot& snapshot);
 
 	public:
 		/// Destructor - does nothing.
@@ -18,6 +18,7 @@
 #include <cps/SimTerminal.h>
 #include <cps/Logger.h>
 #include <cps/SystemTopology.h>
+#include <cps/CIM/TopologyCache.h>
 
 /* ====== WARNING =======
  *
@@ -100,6 +101,12 @@ namespace CIM {
 		/// global shunt resistor value
 		Real mShuntConductanceValue = 1e-6;
 
+		// #### topology cache ####
+		/// Records of the mapped topology
+		TopologyCache mCache;
+		/// Cache file, empty if caching is disabled
+		std::experimental::filesystem::path mCacheFile;
+
 		// #### General Functions ####
 		/// Resolves unit multipliers.
 		static Real unitValue(Real value, IEC61970::Base::Domain::UnitMultiplier mult);
@@ -120,10 +127,24 @@ namespace CIM {
 		/// Since all nodes have references to the equipment connected to them (via Terminals), but not
 		/// the other way around (which we need for instantiating the components), we collect that information here as well.
 		void parseFiles();
+		/// Throws InvalidTopology if a component has unconnected terminals
+		void checkUnconnectedComponents();
 		/// Returns list of components and nodes.
 		SystemTopology systemTopology();
+		/// Key of the topology cache for the given files and the current settings
+		std::uint64_t cacheKey(const std::list<std::experimental::filesystem::path> &filenames);
+		/// Adds the nodes and terminals to the cache records
+		void storeTopology();
+		/// Rebuilds nodes, terminals and components from the cache records
+		template<typename VarType>
+		void restoreTopology();
 
 		// #### Mapping Functions ####
+		/// Creates a component and records it for the topology cache
+		TopologicalPowerComp::Ptr makeComponent(TopologyCache::ComponentType type, String uid, String name,
+			std::vector<Real> parameters = std::vector<Real>());
+		/// Creates a component from its record
+		TopologicalPowerComp::Ptr createComponent(const TopologyCache::ComponentRecord &record);
 		/// Returns simulation node index which belongs to mRID.
 		Matrix::Index mapTopologicalNode(String mrid);
 		/// Maps CIM components to CPowerSystem components.
@@ -173,6 +194,12 @@ namespace CIM {
 		///
 		void initDynamicSystemTopologyWithPowerflow(SystemTopology& systemPF, SystemTopology& systemEMT);
 
+		/// Store the mapped topology in the given file and use it instead of
+		/// parsing as long as the CIM files and settings do not change
+		void setTopologyCache(const std::experimental::filesystem::path &cacheFile) {
+			mCacheFile = cacheFile;
+		}
+
 		// #### shunt component settings ####
 		/// set shunt capacitor value
 		void setShuntCapacitor(Real v) {
@@ -0,0 +1,116 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+#include <experimental/filesystem>
+
+#include <cps/Definitions.h>
+
+namespace CPS {
+namespace CIM {
+	/// \brief Binary copy of a topology mapped from CIM files.
+	///
+	/// Holds what is needed to rebuild the components without parsing the
+	/// CIM files again: nodes with their initial voltages, terminals with
+	/// their power flow data and the component parameters. The file is
+	/// versioned and keyed by a hash of the input files and reader
+	/// settings, so that outdated caches are ignored.
+	class TopologyCache {
+	public:
+		/// Component types created by the CIM reader
+		enum class ComponentType : std::uint32_t {
+			DP_Ph1_RXLoad,
+			EMT_Ph3_RXLoad,
+			SP_Ph1_Load,
+			DP_Ph1_PiLine,
+			EMT_Ph3_PiLine,
+			SP_Ph1_PiLine,
+			DP_Ph1_Transformer,
+			EMT_Ph3_Transformer,
+			SP_Ph1_Transformer,
+			DP_Ph1_SynchronGeneratorTrStab,
+			DP_Ph1_SynchronGeneratorIdeal,
+			SP_Ph1_SynchronGenerator,
+			DP_Ph1_NetworkInjection,
+			EMT_Ph3_NetworkInjection,
+			SP_Ph1_externalGridInjection,
+			SP_Ph1_Shunt
+		};
+
+		struct NodeRecord {
+			String uid;
+			String name;
+			UInt matrixNodeIndex;
+			MatrixComp initialVoltage;
+		};
+
+		struct TerminalRecord {
+			String uid;
+			/// UID of the connected node
+			String node;
+			MatrixComp power;
+		};
+
+		struct ComponentRecord {
+			ComponentType type;
+			String uid;
+			String name;
+			/// Parameters in the order expected by the reader for this type
+			std::vector<Real> parameters;
+			/// Terminal UIDs by terminal position
+			std::vector<std::pair<UInt, String>> terminals;
+		};
+
+		/// Increased whenever the file format or the meaning of parameters changes
+		static const std::uint32_t version = 1;
+
+		/// Hash of the contents of the input files and the settings that
+		/// influence the mapping
+		static std::uint64_t key(const std::list<std::experimental::filesystem::path> &files,
+			const std::vector<Real> &settings);
+
+		/// Returns true if the reader creates components of the given type
+		/// with the given number of parameters
+		static Bool validParameters(ComponentType type, std::size_t count);
+
+		/// Remove all records
+		void clear();
+		/// Returns false if the file does not exist, was written for
+		/// other input files or by another version or is damaged
+		Bool load(const std::experimental::filesystem::path &file, std::uint64_t key);
+		///
+		void save(const std::experimental::filesystem::path &file, std::uint64_t key) const;
+
+		///
+		void addNode(const NodeRecord &node) { mNodes.push_back(node); }
+		///
+		void addTerminal(const TerminalRecord &terminal) { mTerminals.push_back(terminal); }
+		///
+		void addComponent(const ComponentRecord &comp) { mComponents[comp.uid] = comp; }
+		/// Records that a terminal is connected to a component at the given position
+		void connectTerminal(const String &comp, UInt position, const String &terminal);
+
+		///
+		const std::vector<NodeRecord>& nodes() const { return mNodes; }
+		///
+		const std::vector<TerminalRecord>& terminals() const { return mTerminals; }
+		///
+		const std::map<String, ComponentRecord>& components() const { return mComponents; }
+
+	private:
+		std::vector<NodeRecord> mNodes;
+		std::vector<TerminalRecord> mTerminals;
+		std::map<String, ComponentRecord> mComponents;
+	};
+}
+}
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <sstream>
@@ -23,6 +24,39 @@
 #include <cps/SP/SP_Ph1_AvVoltageSourceInverterDQ.h>
 
 namespace CPS {
+	/// \brief Numeric values of a CSV file.
+	///
+	/// The file is memory-mapped and split into chunks of rows that are
+	/// parsed in parallel with a locale-independent number parser.
+	/// A first row that does not start with a number is treated as title.
+	class CSVData {
+	public:
+		/// Reads the file with the given number of threads, 0 uses all cores.
+		/// If timeOfDay is set, the first column is read as HH:MM:SS and
+		/// converted to seconds.
+		CSVData(const std::experimental::filesystem::path& file, Bool timeOfDay = false, UInt numThreads = 0);
+
+		///
+		std::size_t rows() const { return mColumns > 0 ? mValues.size() / mColumns : 0; }
+		/// Number of values per row, taken from the first row of data
+		UInt columns() const { return mColumns; }
+		///
+		Real get(std::size_t row, UInt column) const { return mValues[row * mColumns + column]; }
+
+		/// Parses a decimal number and advances pos behind it. Returns false
+		/// if there is no number at pos.
+		static Bool parseReal(const char*& pos, const char* end, Real& value);
+
+	private:
+		std::vector<Real> mValues;
+		UInt mColumns = 0;
+
+		/// Appends the values of all rows between begin and end
+		void parseRows(const char* begin, const char* end, Bool timeOfDay, std::vector<Real>& values) const;
+		/// Parses the values of one row, returns the number of values
+		static UInt parseRow(const char* pos, const char* end, Bool timeOfDay, Real* values, UInt maxValues);
+	};
+
 	/// reads load profiles (csv files only) and assign them to the corresponding load object
 	class CSVReader {
 	private:
@@ -34,6 +68,15 @@ namespace CPS {
 		std::list<std::experimental::filesystem::path> mFileList;
 		/// assign pattern, used when the MANUAL mode is selected
 		std::map <String, String> mAssignPattern;
+		/// Number of threads used to read files, 0 uses all cores
+		UInt mNumThreads = 0;
+		/// Number of threads used to parse a single file
+		UInt mChunkThreads = 0;
+
+		/// Jobs reading the profile of a load, at most one per load
+		typedef std::map<const void*, std::function<void()>> ReadJobs;
+		/// Executes the jobs on multiple threads
+		void runParallel(ReadJobs& jobs);
 
 	public:
 		/// set load profile assigning pattern. AUTO for assigning load profile name (csv file name) to load object with the same name (mName)
@@ -57,6 +100,9 @@ namespace CPS {
 		///
 		CSVReader(String name, String path, std::map<String, String>& assignList, Logger::Level logLevel);
 
+		/// Number of threads used to read files, 0 uses all cores
+		void setNumThreads(UInt numThreads) { mNumThreads = mChunkThreads = numThreads; }
+
 		///	convert HH:MM:SS format timestamp into total seconds.
 		///	e.g.: 00 : 01 : 00 -- > 60.
 		Real time_format_convert(const String& time);
@@ -95,6 +141,16 @@ namespace CPS {
 			Real start_time = -1, Real time_step = 1, Real end_time = -1,
 			CSVReader::Mode mode = CSVReader::Mode::AUTO,
 			CSVReader::DataFormat format = CSVReader::DataFormat::SECONDS);
+		/// Resamples all profile files to a fixed interval and writes them to a
+		/// profile table file. The files are read row by row, so the memory
+		/// does not depend on the length of the profiles.
+		void writeLoadProfileTable(const String& filename,
+			Real start_time, Real time_step, Real end_time,
+			CSVReader::DataFormat format = CSVReader::DataFormat::SECONDS);
+		/// Assign the profiles of a table to the loads. The profiles are named
+		/// after the files they have been created from.
+		void assignLoadProfileTable(SystemTopology& sys, PowerProfileTable::Ptr table,
+			CSVReader::Mode mode = CSVReader::Mode::AUTO);
 		///
 		void assignPVGeneration(SystemTopology& sys,
 			Real start_time = -1, Real time_step = 1, Real end_time = -1,
@@ -60,9 +60,7 @@
 #include <cps/DP/DP_Ph3_Resistor.h>
 #include <cps/DP/DP_Ph3_SeriesSwitch.h>
 #include <cps/DP/DP_Ph3_SynchronGeneratorDQTrapez.h>
-#ifdef WITH_SUNDIALS
-  #include <cps/DP/DP_Ph3_SynchronGeneratorDQODE.h>
-#endif
+#include <cps/DP/DP_Ph3_SynchronGeneratorDQODE.h>
 #include <cps/DP/DP_Ph3_SynchronGeneratorVBR.h>
 
 #include <cps/EMT/EMT_Ph1_Capacitor.h>
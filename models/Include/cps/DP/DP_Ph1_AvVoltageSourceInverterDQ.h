@@ -123,6 +123,12 @@ namespace Ph1 {
 		void initializeFromPowerflow(Real frequency);
 		// #### interface with villas node ####
 		void ctrlReceiver(Attribute<Real>::Ptr qref);
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubCtrledVoltageSource, mSubResistorF, mSubCapacitorF, mSubInductorF, mSubResistorC };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
@@ -54,6 +54,8 @@ namespace Ph1 {
 		void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		///
 		void mnaUpdateVoltage(const Matrix& leftVector);
+		/// Stamps do not depend on the time step
+		Bool mnaSupportsTimeStepUpdate() { return true; }
 
 		class MnaPreStep : public Task {
 		public:
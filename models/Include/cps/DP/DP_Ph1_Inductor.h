@@ -66,6 +66,14 @@ namespace Ph1 {
 		void mnaUpdateVoltageHarm(const Matrix& leftVector, Int freqIdx);
 		/// Update interface current from MNA system results
 		void mnaUpdateCurrent(const Matrix& leftVector);
+		/// Time step can be changed during the simulation
+		Bool mnaSupportsTimeStepUpdate() { return true; }
+		/// Admittance for frequency sweeps
+		Bool mnaSupportsAdmittanceStamp() { return true; }
+		///
+		void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
+		/// Recomputes the discretization coefficients for a new time step
+		void mnaUpdateTimeStep(Real timeStep);
 		void mnaUpdateCurrentHarm();
 
 		// #### Tearing methods ####
@@ -75,6 +75,12 @@ namespace Ph1 {
 		/// Sets model specific parameters
 		void setParameters(Real activePower, Real ReactivePower, Real volt);
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubInductor, mSubCapacitor, mSubResistor };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
@@ -50,6 +50,12 @@ namespace Ph1 {
 		void mnaUpdateVoltageHarm(const Matrix& leftVector, Int freqIdx);
 		/// Update interface current from MNA system result
 		void mnaUpdateCurrent(const Matrix& leftVector);
+		/// Stamps do not depend on the time step
+		Bool mnaSupportsTimeStepUpdate() { return true; }
+		/// Admittance for frequency sweeps
+		Bool mnaSupportsAdmittanceStamp() { return true; }
+		///
+		void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
 		void mnaUpdateCurrentHarm();
 
 		class MnaPostStep : public Task {
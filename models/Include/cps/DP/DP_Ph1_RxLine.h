@@ -48,6 +48,12 @@ namespace Ph1 {
 		/// Initializes component from power flow data
 		void initializeFromPowerflow(Real frequency);
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubInductor, mSubResistor };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
@@ -74,6 +74,10 @@ namespace Ph1 {
 		Bool mnaIsClosed() { return mIsClosed; }
 		/// Stamps system matrix considering the defined switch position
 		void mnaApplySwitchSystemMatrixStamp(Matrix& systemMatrix, Bool closed);
+		/// Admittance for frequency sweeps in the current switch position
+		Bool mnaSupportsAdmittanceStamp() { return true; }
+		///
+		void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
 	};
 }
 }
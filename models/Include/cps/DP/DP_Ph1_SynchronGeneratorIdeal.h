@@ -41,6 +41,12 @@ namespace Ph1 {
 		/// Initializes component from power flow data
 		void initializeFromPowerflow(Real frequency);
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubVoltageSource };
+		}
+
 		// #### MNA section ####
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		/// Stamps system matrix
@@ -75,6 +75,12 @@ namespace Ph1 {
 		///
 		void initializeFromPowerflow(Real frequency);
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubVoltageSource, mSubInductor };
+		}
+
 		// #### MNA Functions ####
 		/// Initializes variables of component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
@@ -69,6 +69,12 @@ namespace Ph1 {
 		void mnaApplyRightSideVectorStampHarm(Matrix& rightVector);
 		/// Returns current through the component
 		void mnaUpdateCurrent(const Matrix& leftVector);
+		/// Stamps do not depend on the time step
+		Bool mnaSupportsTimeStepUpdate() { return true; }
+		/// Admittance for frequency sweeps
+		Bool mnaSupportsAdmittanceStamp() { return true; }
+		///
+		void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
 
 		class MnaPreStep : public Task {
 		public:
@@ -71,6 +71,17 @@ namespace Ph3 {
 		/// Calculates flux and current from the voltage vector.
 		void step(MatrixComp& voltage, Real time);
 
+		// #### Checkpointing ####
+		/// The machine states are not attributes
+		void saveState(Snapshot& snapshot) {
+			SimPowerComp<Complex>::saveState(snapshot);
+			saveMachineState(snapshot);
+		}
+		void loadState(Snapshot& snapshot) {
+			SimPowerComp<Complex>::loadState(snapshot);
+			loadMachineState(snapshot);
+		}
+
 		// #### MNA Functions ####
 		/// Initializes variables of component
 		virtual void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr) = 0;
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <cps/DP/DP_Ph3_SynchronGeneratorDQ.h>
+#include <cps/Solver/ODEInterface.h>
+#include <cps/Solver/ODEintInterface.h>
 
 #ifdef WITH_SUNDIALS
   #include <arkode/arkode.h> // Prototypes for ARKode fcts., consts
@@ -18,7 +20,6 @@
   #include <sunlinsol/sunlinsol_dense.h>  /* access to dense SUNLinearSolver		  */
   #include <arkode/arkode_direct.h>		   /* access to ARKDls interface				   */
 
-  #include <cps/Solver/ODEInterface.h>
   // Needed to print the computed to the console
   #if defined(SUNDIALS_EXTENDED_PRECISION)
 		#define GSYM "Lg"
@@ -37,6 +38,7 @@ namespace Ph3 {
 	class SynchronGeneratorDQODE :
 		public SynchronGeneratorDQ,
 		public ODEInterface,
+		public ODEintInterface,
 		public SharedFactory<SynchronGeneratorDQODE> {
 	public:
 		SynchronGeneratorDQODE(String uid, String name, Logger::Level loglevel = Logger::Level::off);
@@ -87,6 +89,25 @@ namespace Ph3 {
 		void odePreStep();
 		void odePostStep();
 
+		// #### ODEint Section ####
+		/// The ODE system is integrated from ode_pre_state into ode_post_state,
+		/// the same attributes used by the SUNDIALS solver.
+		int num_states() const { return mDim; }
+		///
+		void odeint(const double y[], double ydot[], double t) {
+			odeStateSpace(t, y, ydot);
+		}
+		/// Done by the ODEPreStep task
+		void pre_step() { }
+		/// Done by the MnaPreStep task
+		void post_step() { }
+		///
+		double* state_vector() { return mOdePreState.data(); }
+		///
+		void set_state_vector(const std::vector<double> &y) {
+			mOdePostState = Eigen::Map<const Matrix>(y.data(), mDim, 1);
+		}
+
 		// ### Variables for ODE-Solver interaction ###
 		/// Number of differential variables
 		int mDim;
@@ -50,6 +50,8 @@ namespace Ph1 {
 		void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 		///
 		void mnaUpdateVoltage(const Matrix& leftVector);
+		/// Stamps do not depend on the time step
+		Bool mnaSupportsTimeStepUpdate() { return true; }
 
 		void updateState(Real time);
 
@@ -56,6 +56,14 @@ namespace Ph1 {
 		void mnaUpdateVoltage(const Matrix& leftVector);
 		/// Update interface current from MNA system result
 		void mnaUpdateCurrent(const Matrix& leftVector);
+		/// Time step can be changed during the simulation
+		Bool mnaSupportsTimeStepUpdate() { return true; }
+		/// Admittance for frequency sweeps
+		Bool mnaSupportsAdmittanceStamp() { return true; }
+		///
+		void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
+		/// Recomputes the discretization coefficients for a new time step
+		void mnaUpdateTimeStep(Real timeStep);
 
 		class MnaPreStep : public Task {
 		public:
@@ -52,6 +52,12 @@ namespace Ph1 {
 		///
 		void initialize(Matrix frequencies);
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Real>::List stateSubComponents() {
+			return { mSubVoltageSource };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
@@ -56,6 +56,10 @@ namespace CPS {
 				void mnaUpdateVoltage(const Matrix& leftVector);
 				/// Update interface current from MNA system result
 				void mnaUpdateCurrent(const Matrix& leftVector);
+				/// Time step can be changed during the simulation
+				Bool mnaSupportsTimeStepUpdate() { return true; }
+				/// Recomputes the discretization coefficients for a new time step
+				void mnaUpdateTimeStep(Real timeStep);
 
 				class MnaPreStep : public Task {
 				public:
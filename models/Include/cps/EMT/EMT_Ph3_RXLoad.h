@@ -75,6 +75,12 @@ namespace CPS {
 				/// Initializes component from power flow data
 				void initializeFromPowerflow(Real frequency);
 
+				// #### Checkpointing ####
+				/// Subcomponents whose states belong to this component
+				SimPowerComp<Real>::List stateSubComponents() {
+					return { mSubInductor, mSubCapacitor, mSubResistor };
+				}
+
 				// #### MNA section ####
 				/// Initializes internal variables of the component
 				void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
@@ -63,6 +63,17 @@ namespace Ph3 {
 		/// General step function for standalone simulation
 		void step(Matrix& voltage, Real time);
 
+		// #### Checkpointing ####
+		/// The machine states are not attributes
+		void saveState(Snapshot& snapshot) {
+			SimPowerComp<Real>::saveState(snapshot);
+			saveMachineState(snapshot);
+		}
+		void loadState(Snapshot& snapshot) {
+			SimPowerComp<Real>::loadState(snapshot);
+			loadMachineState(snapshot);
+		}
+
 		// #### MNA Functions ####
 		/// Initializes variables of component
 		virtual void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr) = 0;
@@ -55,6 +55,8 @@ namespace CPS {
 				void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 				/// Returns current through the component
 				void mnaUpdateCurrent(const Matrix& leftVector);
+				/// Stamps do not depend on the time step
+				Bool mnaSupportsTimeStepUpdate() { return true; }
 
 				class MnaPreStep : public CPS::Task {
 				public:
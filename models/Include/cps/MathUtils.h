@@ -167,6 +167,78 @@ namespace CPS {
 					addToMatrixElement(mat, rows[phase], columns[phase], value);
 		}
 
+		// #### Block Operations ####
+		//
+		// The phases of a three-phase node have consecutive matrix node indices,
+		// so the phase coupling between two nodes is added as one dense block.
+		// 3x3 blocks use fixed size kernels that Eigen unrolls and vectorizes.
+
+		static Bool isContiguous(const std::vector<UInt>& indices) {
+			for (UInt idx = 1; idx < indices.size(); idx++)
+				if (indices[idx] != indices[0] + idx)
+					return false;
+			return true;
+		}
+
+		/// Adds a real block, e.g. the 3x3 conductance of an EMT three-phase branch
+		static void addToMatrixBlock(Matrix& mat, const std::vector<UInt>& rows, const std::vector<UInt>& columns, const Matrix& block) {
+			if (!isContiguous(rows) || !isContiguous(columns)) {
+				for (UInt row = 0; row < rows.size(); row++)
+					for (UInt col = 0; col < columns.size(); col++)
+						addToMatrixElement(mat, rows[row], columns[col], block(row, col));
+			}
+			else if (block.rows() == 3 && block.cols() == 3)
+				mat.block<3, 3>(rows[0], columns[0]) += block;
+			else
+				mat.block(rows[0], columns[0], block.rows(), block.cols()) += block;
+		}
+
+		/// Adds a complex block, e.g. the 3x3 admittance of a DP three-phase branch,
+		/// to the real and imaginary quadrants of the system matrix of the given frequency
+		static void addToMatrixBlock(Matrix& mat, const std::vector<UInt>& rows, const std::vector<UInt>& columns, const MatrixComp& block,
+			Int maxFreq = 1, Int freqIdx = 0) {
+			if (!isContiguous(rows) || !isContiguous(columns)) {
+				for (UInt row = 0; row < rows.size(); row++)
+					for (UInt col = 0; col < columns.size(); col++)
+						addToMatrixElement(mat, rows[row], columns[col], block(row, col), maxFreq, freqIdx);
+				return;
+			}
+
+			// Same layout as addToMatrixElement
+			Eigen::Index harmonicOffset = mat.rows() / maxFreq;
+			Eigen::Index complexOffset = harmonicOffset / 2;
+			Eigen::Index row = rows[0] + harmonicOffset * freqIdx;
+			Eigen::Index col = columns[0] + harmonicOffset * freqIdx;
+			if (block.rows() == 3 && block.cols() == 3) {
+				const Eigen::Matrix<Real, 3, 3> re = block.real(), im = block.imag();
+				mat.block<3, 3>(row, col) += re;
+				mat.block<3, 3>(row + complexOffset, col + complexOffset) += re;
+				mat.block<3, 3>(row, col + complexOffset) -= im;
+				mat.block<3, 3>(row + complexOffset, col) += im;
+			}
+			else {
+				const Matrix re = block.real(), im = block.imag();
+				mat.block(row, col, block.rows(), block.cols()) += re;
+				mat.block(row + complexOffset, col + complexOffset, block.rows(), block.cols()) += re;
+				mat.block(row, col + complexOffset, block.rows(), block.cols()) -= im;
+				mat.block(row + complexOffset, col, block.rows(), block.cols()) += im;
+			}
+		}
+
+		/// Evaluates block expressions such as negated conductances
+		/// before dispatching on the scalar type
+		template <typename Derived>
+		static void addToMatrixBlock(Matrix& mat, const std::vector<UInt>& rows, const std::vector<UInt>& columns, const Eigen::MatrixBase<Derived>& block) {
+			addToMatrixBlock(mat, rows, columns, block.eval());
+		}
+
+		/// Complex block expressions for the system matrix of the given frequency
+		template <typename Derived>
+		static void addToMatrixBlock(Matrix& mat, const std::vector<UInt>& rows, const std::vector<UInt>& columns, const Eigen::MatrixBase<Derived>& block,
+			Int maxFreq, Int freqIdx) {
+			addToMatrixBlock(mat, rows, columns, MatrixComp(block), maxFreq, freqIdx);
+		}
+
 		// #### Integration Methods ####
 		static Matrix StateSpaceTrapezoidal(Matrix states, Matrix A, Matrix B, Real dt, Matrix u_new, Matrix u_old);
 		static Matrix StateSpaceTrapezoidal(Matrix states, Matrix A, Matrix B, Matrix C, Real dt, Matrix u_new, Matrix u_old);
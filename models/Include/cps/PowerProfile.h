@@ -7,6 +7,11 @@
  *********************************************************************************/
 
 #pragma once
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <cps/Definitions.h>
 
 namespace CPS {
@@ -19,4 +24,90 @@ namespace CPS {
 		std::map<Real, PQData> pqData;
 		std::map<Real, Real> weightingFactors;
 	};
+
+	/// \brief Profiles of many loads sampled at a fixed interval.
+	///
+	/// All profiles share one time axis and are stored in a dense array
+	/// with one row of samples per point in time. Tables loaded from a file
+	/// only keep a window of rows in memory, which is moved along as the
+	/// requested time advances. The window is shared by all readers and
+	/// locked while it is read, so readers at distant times, e.g. parallel
+	/// time series segments, should use a table each.
+	class PowerProfileTable {
+	public:
+		typedef std::shared_ptr<PowerProfileTable> Ptr;
+		/// Value between two samples
+		enum class Interpolation { Hold, Linear };
+
+		/// Creates a table in memory with all samples set to zero
+		PowerProfileTable(const std::vector<String>& names, Real startTime, Real interval,
+			UInt numSamples, Bool weightingFactors = false, Interpolation interpolation = Interpolation::Linear);
+		/// Opens a table file and reads windows of the given number of samples from it
+		PowerProfileTable(const String& filename, UInt windowSamples = 3600,
+			Interpolation interpolation = Interpolation::Linear);
+
+		///
+		UInt numProfiles() const { return static_cast<UInt>(mNames.size()); }
+		///
+		UInt numSamples() const { return mNumSamples; }
+		///
+		Real startTime() const { return mStartTime; }
+		///
+		Real interval() const { return mInterval; }
+		/// True if the profiles contain weighting factors instead of powers
+		Bool weightingFactors() const { return mWeightingFactors; }
+		/// Index of the profile with the given name
+		UInt profileIndex(const String& name) const;
+		///
+		const std::vector<String>& names() const { return mNames; }
+
+		/// Sets a sample of a table that is held in memory
+		void setSample(UInt profile, UInt sample, PQData data);
+		/// Profile value at the given time. Times outside of the table
+		/// return the first or last sample. Can be called concurrently.
+		PQData value(UInt profile, Real time);
+
+		/// Writes a table that is held in memory to a file
+		void save(const String& filename) const;
+		/// Writes the header of a table file. The rows have to be appended
+		/// with writeRow in the order of the samples.
+		static void writeHeader(std::ofstream& file, const std::vector<String>& names,
+			Real startTime, Real interval, UInt numSamples, Bool weightingFactors);
+		///
+		static void writeRow(std::ofstream& file, const std::vector<PQData>& row) {
+			file.write(reinterpret_cast<const char*>(row.data()), sizeof(PQData) * row.size());
+		}
+
+	private:
+		std::vector<String> mNames;
+		std::unordered_map<String, UInt> mIndices;
+		Real mStartTime;
+		Real mInterval;
+		UInt mNumSamples;
+		Bool mWeightingFactors;
+		Interpolation mInterpolation;
+
+		/// Samples of the rows in the current window
+		std::vector<PQData> mData;
+		/// First sample in the current window
+		UInt mWindowStart = 0;
+		/// Number of samples in the current window
+		UInt mWindowSamples = 0;
+		/// File the windows are read from, if any
+		std::ifstream mFile;
+		/// Protects the window of a table read from a file
+		std::mutex mWindowMutex;
+		std::streamoff mDataOffset = 0;
+		UInt mMaxWindowSamples = 0;
+
+		void initIndices();
+		/// Makes sure that the window contains the given samples,
+		/// the window has to be locked
+		void loadWindow(UInt first, UInt last);
+		/// Value between the samples idx and idx + 1
+		PQData interpolate(UInt profile, UInt idx, Real frac) const;
+		const PQData& sample(UInt profile, UInt sample) const {
+			return mData[static_cast<std::size_t>(sample - mWindowStart) * mNames.size() + profile];
+		}
+	};
 }
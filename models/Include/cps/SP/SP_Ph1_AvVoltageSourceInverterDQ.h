@@ -211,6 +211,12 @@ namespace Ph1 {
 		///
 		void pfBusInitialize() override;
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubCtrledVoltageSource, mSubResistorF, mSubCapacitorF, mSubInductorF, mSubResistorC };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) override;
@@ -36,6 +36,10 @@ namespace SP { namespace Ph1 {
 		Real mActivePower;
 		/// Reactive power [VAr]
 		Real mReactivePower;
+		/// Nominal active power [Watt], scaled by weighting factor profiles
+		Real mActivePowerNom = 0;
+		/// Nominal reactive power [VAr], scaled by weighting factor profiles
+		Real mReactivePowerNom = 0;
 
 		/// base apparent power[VA]
 		Real mBaseApparentPower;
@@ -84,8 +88,18 @@ namespace SP { namespace Ph1 {
 		void initializeFromPowerflow(Real frequency) override;
 		/// Load profile data
 		PowerProfile mLoadProfile;
+		/// Dense load profile table shared with other loads
+		PowerProfileTable::Ptr mProfileTable;
+		/// Index of the profile of this load in the profile table
+		UInt mProfileIndex = 0;
 		/// Use the assigned load profile
 		bool use_profile = false;
+		/// Use a profile of a dense profile table
+		void setLoadProfile(PowerProfileTable::Ptr table, UInt index) {
+			mProfileTable = table;
+			mProfileIndex = index;
+			use_profile = true;
+		}
 		/// Update PQ for this load for power flow calculation at next time step
 		void updatePQ(Real time);
 
@@ -95,6 +109,12 @@ namespace SP { namespace Ph1 {
         /// Modify powerflow bus type
 		void modifyPowerFlowBusType(PowerflowBusType powerflowBusType) override;
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubInductor, mSubCapacitor, mSubResistor };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) override;
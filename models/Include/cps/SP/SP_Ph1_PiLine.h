@@ -116,6 +116,12 @@ namespace Ph1 {
 		/// get admittance matrix
 		MatrixComp Y_element();
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubSeriesInductor, mSubSeriesResistor, mSubParallelResistor0, mSubParallelCapacitor0, mSubParallelResistor1, mSubParallelCapacitor1 };
+		}
+
 		// #### MNA section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) override;
@@ -119,6 +119,12 @@ namespace Ph1 {
 		MatrixComp Y_element();
 
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubInductor, mSubResistor };
+		}
+
 		// #### MNA Section ####
 
 
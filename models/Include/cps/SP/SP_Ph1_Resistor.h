@@ -74,6 +74,12 @@ namespace CPS {
 				void mnaUpdateVoltage(const Matrix& leftVector);
 				///
 				void mnaUpdateCurrent(const Matrix& leftVector);
+				/// Stamps do not depend on the time step
+				Bool mnaSupportsTimeStepUpdate() { return true; }
+				/// Admittance for frequency sweeps
+				Bool mnaSupportsAdmittanceStamp() { return true; }
+				///
+				void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
 
 				class MnaPostStep : public Task {
 				public:
@@ -149,6 +149,12 @@ namespace SP { namespace Ph1 {
 		/// get admittance matrix
 		MatrixComp Y_element();
 
+		// #### Checkpointing ####
+		/// Subcomponents whose states belong to this component
+		SimPowerComp<Complex>::List stateSubComponents() {
+			return { mSubInductor, mSubSnubResistor, mSubResistor };
+		}
+
 		// #### MNA Section ####
 		/// Initializes internal variables of the component
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) override;
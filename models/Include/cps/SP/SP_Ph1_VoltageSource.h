@@ -60,6 +60,12 @@ namespace CPS {
 				void mnaApplyRightSideVectorStamp(Matrix& rightVector);
 				/// Returns current through the component
 				void mnaUpdateCurrent(const Matrix& leftVector);
+				/// Stamps do not depend on the time step
+				Bool mnaSupportsTimeStepUpdate() { return true; }
+				/// Admittance for frequency sweeps
+				Bool mnaSupportsAdmittanceStamp() { return true; }
+				///
+				void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance);
 
 				class MnaPreStep : public CPS::Task {
 				public:
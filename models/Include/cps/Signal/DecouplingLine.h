@@ -57,6 +57,9 @@ namespace Signal {
 		void step(Real time, Int timeStepCount);
 		void postStep();
 		Task::List getTasks();
+		/// The ring buffers are part of the line state
+		void saveState(Snapshot& snapshot);
+		void loadState(Snapshot& snapshot);
 		IdentifiedObject::List getLineComponents();
 
 		class PreStep : public Task {
@@ -38,6 +38,9 @@ namespace Signal {
 		void step(Real time);
 		void setInput(Attribute<Real>::Ptr input);
 		Task::List getTasks();
+		/// The signal history is part of the filter state
+		void saveState(Snapshot& snapshot);
+		void loadState(Snapshot& snapshot);
 
 		class Step : public Task {
 		public:
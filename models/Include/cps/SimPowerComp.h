@@ -149,5 +149,13 @@ namespace CPS {
 		virtual void initialize(Matrix frequencies);
 		/// Initializes Component variables according to power flow data stored in Nodes.
 		virtual void initializeFromPowerflow(Real frequency) { }
+
+		// #### Checkpointing ####
+		/// Subcomponents not listed in mSubComponents whose states belong to this component
+		virtual List stateSubComponents() { return List(); }
+		/// Store the states of this component and its subcomponents
+		void saveState(Snapshot& snapshot);
+		/// Restore the states of this component and its subcomponents
+		void loadState(Snapshot& snapshot);
 	};
 }
@@ -21,6 +21,8 @@ namespace CPS {
 		/// Determine state of the simulation, e.g. to implement
 		/// special behavior for components during initialization
 		Bool mBehaviour = Behaviour::Simulation;
+		/// The component's tasks are executed every mRateDivisor-th time step
+		UInt mRateDivisor = 1;
 	public:
 		typedef std::shared_ptr<SimSignalComp> Ptr;
 		typedef std::vector<Ptr> List;
@@ -44,5 +46,10 @@ namespace CPS {
 		}
 		/// Set behavior of component, e.g. initialization
 		void setBehaviour(Behaviour behaviour) { mBehaviour = behaviour; }
+		/// Execute the component's tasks only every n-th simulation step.
+		/// The component is initialized with the correspondingly larger time step.
+		void setRateDivisor(UInt divisor) { mRateDivisor = divisor > 0 ? divisor : 1; }
+		///
+		UInt rateDivisor() const { return mRateDivisor; }
 	};
 }
@@ -0,0 +1,136 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+#include <cps/Definitions.h>
+
+namespace CPS {
+	/// True for the value types that can be written to a snapshot
+	template <typename T>
+	struct SnapshotSupported : std::integral_constant<bool,
+		std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_same<T, Complex>::value> { };
+
+	template <typename S, int R, int C, int O, int MR, int MC>
+	struct SnapshotSupported<Eigen::Matrix<S, R, C, O, MR, MC>> : std::true_type { };
+
+	template <typename T>
+	struct SnapshotSupported<std::vector<T>> : std::integral_constant<bool,
+		std::is_arithmetic<T>::value || std::is_same<T, Complex>::value> { };
+
+	/// \brief Compact binary copy of simulation states.
+	///
+	/// Values are appended in the order they are written and have to be
+	/// read back in the same order. Only the types accepted by
+	/// SnapshotSupported can be written, others such as strings or
+	/// pointers do not compile.
+	class Snapshot {
+	protected:
+		/// Serialized values
+		std::vector<char> mData;
+		/// Position of the next value to read
+		std::size_t mReadPos = 0;
+
+		void writeBytes(const void *src, std::size_t size) {
+			const char *bytes = static_cast<const char *>(src);
+			mData.insert(mData.end(), bytes, bytes + size);
+		}
+
+		void readBytes(void *dst, std::size_t size) {
+			if (mReadPos + size > mData.size())
+				throw SystemError("Snapshot does not match the restored object");
+			std::memcpy(dst, mData.data() + mReadPos, size);
+			mReadPos += size;
+		}
+
+	public:
+		/// Remove all values
+		void clear() {
+			mData.clear();
+			mReadPos = 0;
+		}
+		/// Read again from the first value
+		void rewind() { mReadPos = 0; }
+		/// Returns true if all values have been read
+		Bool atEnd() const { return mReadPos == mData.size(); }
+		/// Size of the serialized values in bytes
+		std::size_t size() const { return mData.size(); }
+
+		// #### Scalars ####
+		template <typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type
+		write(const T &value) { writeBytes(&value, sizeof(T)); }
+
+		template <typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type
+		read(T &value) { readBytes(&value, sizeof(T)); }
+
+		void write(const Complex &value) { writeBytes(&value, sizeof(Complex)); }
+		void read(Complex &value) { readBytes(&value, sizeof(Complex)); }
+
+		// #### Matrices ####
+		template <typename S, int R, int C, int O, int MR, int MC>
+		void write(const Eigen::Matrix<S, R, C, O, MR, MC> &value) {
+			Eigen::Index rows = value.rows(), cols = value.cols();
+			writeBytes(&rows, sizeof(rows));
+			writeBytes(&cols, sizeof(cols));
+			writeBytes(value.data(), sizeof(S) * value.size());
+		}
+
+		template <typename S, int R, int C, int O, int MR, int MC>
+		void read(Eigen::Matrix<S, R, C, O, MR, MC> &value) {
+			Eigen::Index rows, cols;
+			readBytes(&rows, sizeof(rows));
+			readBytes(&cols, sizeof(cols));
+			value.resize(rows, cols);
+			readBytes(value.data(), sizeof(S) * value.size());
+		}
+
+		// #### Buffers ####
+		template <typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_same<T, Complex>::value>::type
+		write(const std::vector<T> &value) {
+			std::size_t size = value.size();
+			writeBytes(&size, sizeof(size));
+			writeBytes(value.data(), sizeof(T) * size);
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_same<T, Complex>::value>::type
+		read(std::vector<T> &value) {
+			std::size_t size;
+			readBytes(&size, sizeof(size));
+			value.resize(size);
+			readBytes(value.data(), sizeof(T) * size);
+		}
+
+		// #### File access ####
+		/// Write snapshot to a binary file
+		void save(const String &filename) const {
+			std::ofstream file(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+			if (!file.is_open())
+				throw SystemError("Cannot open snapshot file " + filename);
+			file.write(mData.data(), mData.size());
+		}
+		/// Read snapshot from a binary file
+		void load(const String &filename) {
+			std::ifstream file(filename, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+			if (!file.is_open())
+				throw SystemError("Cannot open snapshot file " + filename);
+			mData.resize(static_cast<std::size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(mData.data(), mData.size());
+			mReadPos = 0;
+		}
+	};
+}
@@ -19,6 +19,8 @@ namespace CPS {
 	public:
 		typedef std::shared_ptr<MNAInterface> Ptr;
 		typedef std::vector<Ptr> List;
+		/// Entries of a complex nodal admittance matrix
+		typedef std::vector<Eigen::Triplet<Complex>> AdmittanceStamp;
 
 		// #### MNA Base Functions ####
 		/// Initializes variables of components
@@ -47,6 +49,23 @@ namespace CPS {
 		/// Stamps right side (source) vector considering the frequency index
 		virtual void mnaApplyRightSideVectorStampHarm(Matrix& sourceVector) { }
 		virtual void mnaApplyRightSideVectorStampHarm(Matrix& sourceVector, Int freqIdx) { }
+
+		// #### MNA Variable Time Step Functions ####
+		/// Returns true if the component can change its time step during the simulation
+		virtual Bool mnaSupportsTimeStepUpdate() { return false; }
+		/// Updates the discretization for a new time step. The system matrix
+		/// stamp is applied again by the solver afterwards.
+		virtual void mnaUpdateTimeStep(Real timeStep) { }
+
+		// #### MNA Frequency Domain Functions ####
+		/// Returns true if the component provides its admittance for frequency sweeps
+		virtual Bool mnaSupportsAdmittanceStamp() { return false; }
+		/// Appends the admittance of the component at the given angular frequency.
+		/// The number and order of the entries must not depend on the frequency
+		/// and the component must not be modified, since the frequencies of a
+		/// sweep are stamped concurrently.
+		virtual void mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) { }
+
 		/// Return list of MNA tasks
 		const Task::List& mnaTasks() {
 			return mMnaTasks;
@@ -57,6 +76,29 @@ namespace CPS {
 			addAttribute<Matrix>("right_vector", &mRightVector, Flags::read);
 		}
 
+		/// Adds an admittance between two matrix node indices, -1 denotes ground
+		static void addAdmittanceStamp(AdmittanceStamp& admittance, Int node0, Int node1, Complex y) {
+			if (node0 >= 0)
+				admittance.push_back(Eigen::Triplet<Complex>(node0, node0, y));
+			if (node1 >= 0)
+				admittance.push_back(Eigen::Triplet<Complex>(node1, node1, y));
+			if (node0 >= 0 && node1 >= 0) {
+				admittance.push_back(Eigen::Triplet<Complex>(node0, node1, -y));
+				admittance.push_back(Eigen::Triplet<Complex>(node1, node0, -y));
+			}
+		}
+		/// Adds a short-circuited voltage source with its current as virtual node
+		static void addVoltageSourceStamp(AdmittanceStamp& admittance, Int node0, Int node1, Int virtualNode) {
+			if (node0 >= 0) {
+				admittance.push_back(Eigen::Triplet<Complex>(virtualNode, node0, -1));
+				admittance.push_back(Eigen::Triplet<Complex>(node0, virtualNode, -1));
+			}
+			if (node1 >= 0) {
+				admittance.push_back(Eigen::Triplet<Complex>(virtualNode, node1, 1));
+				admittance.push_back(Eigen::Triplet<Complex>(node1, virtualNode, 1));
+			}
+		}
+
 		/// List of tasks that relate to using MNA for this component (usually pre-step and/or post-step)
 		Task::List mMnaTasks;
 		/// This component's contribution ("stamp") to the right-side vector.
@@ -30,6 +30,6 @@ namespace CPS {
 		///Returns Pointer to state Vector of the componente
 		virtual double* state_vector() = 0;
 		///Writes the computed solution to the component
-		virtual void set_state_vector(std::vector<double> y) = 0;
+		virtual void set_state_vector(const std::vector<double> &y) = 0;
 	};
 }
@@ -48,11 +48,39 @@ namespace CPS {
 			return mPrevStepDependencies;
 		}
 
+		/// Execute this task only every n-th time step
+		void setRateDivisor(UInt divisor) {
+			mRateDivisor = divisor > 0 ? divisor : 1;
+		}
+
+		UInt rateDivisor() const {
+			return mRateDivisor;
+		}
+
+		/// Returns true if the task has to be executed in the given time step
+		Bool isActive(Int timeStepCount) const {
+			return timeStepCount % mRateDivisor == 0;
+		}
+
+		/// Deferrable tasks, e.g. logging or monitoring, may be skipped
+		/// when a step is about to miss its deadline
+		void setDeferrable(Bool deferrable) {
+			mDeferrable = deferrable;
+		}
+
+		Bool isDeferrable() const {
+			return mDeferrable;
+		}
+
 	protected:
 		Task(std::string name) : mName(name) {}
 		std::string mName;
 		std::vector<AttributeBase::Ptr> mAttributeDependencies;
 		std::vector<AttributeBase::Ptr> mModifiedAttributes;
 		std::vector<AttributeBase::Ptr> mPrevStepDependencies;
+		/// The task is executed every mRateDivisor-th time step
+		UInt mRateDivisor = 1;
+		/// The task is not required for the correctness of the step
+		Bool mDeferrable = false;
 	};
 }
@@ -297,6 +297,34 @@ Real Base::SynchronGenerator::calcHfromJ(Real J, Real omegaNominal, Int polePair
 	return J * 0.5 * omegaNominal*omegaNominal / polePairNumber;
 }
 
+void Base::SynchronGenerator::saveMachineState(Snapshot& snapshot) {
+	snapshot.write(mOmMech);
+	snapshot.write(mThetaMech);
+	snapshot.write(mMechPower);
+	snapshot.write(mMechTorque);
+	snapshot.write(mElecActivePower);
+	snapshot.write(mElecTorque);
+	snapshot.write(mVsr);
+	snapshot.write(mIsr);
+	snapshot.write(mPsisr);
+	snapshot.write(mVdq0);
+	snapshot.write(mIdq0);
+}
+
+void Base::SynchronGenerator::loadMachineState(Snapshot& snapshot) {
+	snapshot.read(mOmMech);
+	snapshot.read(mThetaMech);
+	snapshot.read(mMechPower);
+	snapshot.read(mMechTorque);
+	snapshot.read(mElecActivePower);
+	snapshot.read(mElecTorque);
+	snapshot.read(mVsr);
+	snapshot.read(mIsr);
+	snapshot.read(mPsisr);
+	snapshot.read(mVdq0);
+	snapshot.read(mIdq0);
+}
+
 void Base::SynchronGenerator::addExciter(Real Ta, Real Ka, Real Te, Real Ke,
 	Real Tf, Real Kf, Real Tr, Real Lad, Real Rfd) {
 	//mExciter = Signal::Exciter(Ta, Ka, Te, Ke, Tf, Kf, Tr, Lad, Rfd);
@@ -24,6 +24,8 @@ using namespace IEC61970::Base::StateVariables;
 
 namespace fs = std::experimental::filesystem;
 
+using ComponentType = TopologyCache::ComponentType;
+
 Reader::Reader(String name, Logger::Level logLevel, Logger::Level componentLogLevel) {
 	mSLog = Logger::get(name + "_CIM", logLevel);
 
@@ -163,6 +165,10 @@ void Reader::parseFiles() {
 		}
 	}
 
+	checkUnconnectedComponents();
+}
+
+void Reader::checkUnconnectedComponents() {
 	mSLog->info("#### Check topology for unconnected components");
 	for (auto pfe : mPowerflowEquipment) {
 		auto c = pfe.second;
@@ -183,13 +189,7 @@ void Reader::parseFiles() {
 }
 
 SystemTopology Reader::loadCIM(Real systemFrequency, const fs::path &filename, Domain domain, PhaseType phase) {
-	mFrequency = systemFrequency;
-	mOmega = 2 * PI*mFrequency;
-	mDomain = domain;
-	mPhase = phase;
-	addFiles(filename);
-	parseFiles();
-	return systemTopology();
+	return loadCIM(systemFrequency, std::list<fs::path>{ filename }, domain, phase);
 }
 
 SystemTopology Reader::loadCIM(Real systemFrequency, const std::list<fs::path> &filenames, Domain domain, PhaseType phase) {
@@ -197,9 +197,82 @@ SystemTopology Reader::loadCIM(Real systemFrequency, const std::list<fs::path> &
 	mOmega = 2 * PI*mFrequency;
 	mDomain = domain;
 	mPhase = phase;
+	mCache.clear();
+
+	std::uint64_t key = 0;
+	if (!mCacheFile.empty()) {
+		key = cacheKey(filenames);
+		if (mCache.load(mCacheFile, key)) {
+			mSLog->info("Loading topology from cache {}", mCacheFile.string());
+			if (mDomain == Domain::EMT)
+				restoreTopology<Real>();
+			else
+				restoreTopology<Complex>();
+			checkUnconnectedComponents();
+			return systemTopology();
+		}
+	}
+
 	addFiles(filenames);
 	parseFiles();
-	return systemTopology();
+	SystemTopology system = systemTopology();
+
+	if (!mCacheFile.empty() && !mPowerflowNodes.empty()) {
+		storeTopology();
+		mCache.save(mCacheFile, key);
+		mSLog->info("Stored topology in cache {}", mCacheFile.string());
+	}
+	return system;
+}
+
+std::uint64_t Reader::cacheKey(const std::list<fs::path> &filenames) {
+	std::vector<Real> settings = {
+		mFrequency, Real(mDomain), Real(mPhase), Real(mGeneratorType),
+		Real(mSetShuntCapacitor), mShuntCapacitorValue,
+		Real(mSetShuntConductance), mShuntConductanceValue
+	};
+	return TopologyCache::key(filenames, settings);
+}
+
+void Reader::storeTopology() {
+	for (auto node : mPowerflowNodes)
+		mCache.addNode({ node.first, node.second->name(),
+			node.second->matrixNodeIndex(), node.second->initialVoltage() });
+
+	for (auto term : mPowerflowTerminals) {
+		TopologicalNode::Ptr node = term.second->topologicalNodes();
+		mCache.addTerminal({ term.first, node ? node->uid() : String(), term.second->power() });
+	}
+}
+
+template<typename VarType>
+void Reader::restoreTopology() {
+	for (auto &rec : mCache.nodes()) {
+		auto node = SimNode<VarType>::make(rec.uid, rec.name, rec.matrixNodeIndex, mPhase);
+		node->setInitialVoltage(rec.initialVoltage);
+		mPowerflowNodes[rec.uid] = node;
+	}
+
+	for (auto &rec : mCache.terminals()) {
+		auto term = SimTerminal<VarType>::make(rec.uid);
+		if (!rec.node.empty())
+			term->setNode(std::dynamic_pointer_cast<SimNode<VarType>>(mPowerflowNodes.at(rec.node)));
+		term->setPower(rec.power);
+		mPowerflowTerminals[rec.uid] = term;
+	}
+
+	for (auto &entry : mCache.components()) {
+		TopologicalPowerComp::Ptr comp = createComponent(entry.second);
+		if (!comp) {
+			mSLog->error("Cached component {} has unknown type {}",
+				entry.first, static_cast<int>(entry.second.type));
+			throw SystemError("Unknown component type in topology cache " + mCacheFile.string());
+		}
+		for (auto &term : entry.second.terminals)
+			std::dynamic_pointer_cast<SimPowerComp<VarType>>(comp)->setTerminalAt(
+				std::dynamic_pointer_cast<SimTerminal<VarType>>(mPowerflowTerminals.at(term.second)), term.first);
+		mPowerflowEquipment[entry.first] = comp;
+	}
 }
 
 void Reader::processSvVoltage(SvVoltage* volt) {
@@ -292,17 +365,15 @@ TopologicalPowerComp::Ptr Reader::mapEnergyConsumer(EnergyConsumer* consumer) {
 	mSLog->info("    Found EnergyConsumer {}", consumer->name);
 	if (mDomain == Domain::EMT) {
 		if (mPhase == PhaseType::ABC) {
-			return std::make_shared<EMT::Ph3::RXLoad>(consumer->mRID, consumer->name, mComponentLogLevel);
+			return makeComponent(ComponentType::EMT_Ph3_RXLoad, consumer->mRID, consumer->name);
 		}
 		else
 		{
 		mSLog->info("    RXLoad for EMT not implemented yet");
-		return std::make_shared<DP::Ph1::RXLoad>(consumer->mRID, consumer->name, mComponentLogLevel);
+		return makeComponent(ComponentType::DP_Ph1_RXLoad, consumer->mRID, consumer->name);
 		}
 	}
 	else if (mDomain == Domain::SP) {
-		auto load = std::make_shared<SP::Ph1::Load>(consumer->mRID, consumer->name, mComponentLogLevel);
-
 		// TODO: Use EnergyConsumer.P and EnergyConsumer.Q if available, overwrite if existent SvPowerFlow data
 		/*
 		Real p = 0;
@@ -315,12 +386,10 @@ TopologicalPowerComp::Ptr Reader::mapEnergyConsumer(EnergyConsumer* consumer) {
 		}*/
 
 		// P and Q values will be set according to SvPowerFlow data
-		load->setParameters(0, 0, 0);
-		load->modifyPowerFlowBusType(PowerflowBusType::PQ); // for powerflow solver set as PQ component as default
-		return load;
+		return makeComponent(ComponentType::SP_Ph1_Load, consumer->mRID, consumer->name);
 	}
 	else {
-		return std::make_shared<DP::Ph1::RXLoad>(consumer->mRID, consumer->name, mComponentLogLevel);
+		return makeComponent(ComponentType::DP_Ph1_RXLoad, consumer->mRID, consumer->name);
 	}
 }
 
@@ -371,32 +440,22 @@ TopologicalPowerComp::Ptr Reader::mapACLineSegment(ACLineSegment* line) {
 
 	if (mDomain == Domain::EMT) {
 		if (mPhase == PhaseType::ABC) {
-			Matrix res_3ph = singlePhaseParameterToThreePhase(resistance);
-			Matrix ind_3ph = singlePhaseParameterToThreePhase(inductance);
-			Matrix cap_3ph = singlePhaseParameterToThreePhase(capacitance);
-			Matrix cond_3ph = singlePhaseParameterToThreePhase(conductance);
-
-			auto cpsLine = std::make_shared<EMT::Ph3::PiLine>(line->mRID, line->name, mComponentLogLevel);
-			cpsLine->setParameters(res_3ph, ind_3ph, cap_3ph, cond_3ph);
-			return cpsLine;
+			return makeComponent(ComponentType::EMT_Ph3_PiLine, line->mRID, line->name,
+				{ resistance, inductance, capacitance, conductance });
 		}
 		else {
 			mSLog->info("    PiLine for EMT not implemented yet");
-			auto cpsLine = std::make_shared<DP::Ph1::PiLine>(line->mRID, line->name, mComponentLogLevel);
-			cpsLine->setParameters(resistance, inductance, capacitance, conductance);
-			return cpsLine;
+			return makeComponent(ComponentType::DP_Ph1_PiLine, line->mRID, line->name,
+				{ resistance, inductance, capacitance, conductance });
 		}
 	}
 	else if (mDomain == Domain::SP) {
-		auto cpsLine = std::make_shared<SP::Ph1::PiLine>(line->mRID, line->name, mComponentLogLevel);
-		cpsLine->setParameters(resistance, inductance, capacitance, conductance, mOmega);
-		cpsLine->setBaseVoltage(baseVoltage);
-		return cpsLine;
+		return makeComponent(ComponentType::SP_Ph1_PiLine, line->mRID, line->name,
+			{ resistance, inductance, capacitance, conductance, mOmega, baseVoltage });
 	}
 	else {
-		auto cpsLine = std::make_shared<DP::Ph1::PiLine>(line->mRID, line->name, mComponentLogLevel);
-		cpsLine->setParameters(resistance, inductance, capacitance, conductance);
-		return cpsLine;
+		return makeComponent(ComponentType::DP_Ph1_PiLine, line->mRID, line->name,
+			{ resistance, inductance, capacitance, conductance });
 	}
 
 }
@@ -495,12 +554,8 @@ TopologicalPowerComp::Ptr Reader::mapPowerTransformer(PowerTransformer* trans) {
 
 	if (mDomain == Domain::EMT) {
 		if (mPhase == PhaseType::ABC) {
-			Matrix resistance_3ph = singlePhaseParameterToThreePhase(resistance);
-			Matrix inductance_3ph = singlePhaseParameterToThreePhase(inductance);
-			Bool withResistiveLosses = resistance > 0;
-			auto transformer = std::make_shared<EMT::Ph3::Transformer>(trans->mRID, trans->name, mComponentLogLevel, withResistiveLosses);
-			transformer->setParameters(ratioAbs, ratioPhase, resistance_3ph, inductance_3ph);
-			return transformer;
+			return makeComponent(ComponentType::EMT_Ph3_Transformer, trans->mRID, trans->name,
+				{ ratioAbs, ratioPhase, resistance, inductance });
 		}
 		else
 		{
@@ -509,17 +564,12 @@ TopologicalPowerComp::Ptr Reader::mapPowerTransformer(PowerTransformer* trans) {
 		}
 	}
 	else if (mDomain == Domain::SP) {
-		auto transformer = std::make_shared<SP::Ph1::Transformer>(trans->mRID, trans->name, mComponentLogLevel);
-		transformer->setParameters(voltageNode1, voltageNode2, ratedPower, ratioAbs, ratioPhase, resistance, inductance, mOmega);
-		Real baseVolt = voltageNode1 >= voltageNode2 ? voltageNode1 : voltageNode2;
-		transformer->setBaseVoltage(baseVolt);
-		return transformer;
+		return makeComponent(ComponentType::SP_Ph1_Transformer, trans->mRID, trans->name,
+			{ voltageNode1, voltageNode2, ratedPower, ratioAbs, ratioPhase, resistance, inductance, mOmega });
 	}
 	else {
-		Bool withResistiveLosses = resistance > 0;
-		auto transformer = std::make_shared<DP::Ph1::Transformer>(trans->mRID, trans->name, mComponentLogLevel, withResistiveLosses);
-		transformer->setParameters(ratioAbs, ratioPhase, resistance, inductance);
-		return transformer;
+		return makeComponent(ComponentType::DP_Ph1_Transformer, trans->mRID, trans->name,
+			{ ratioAbs, ratioPhase, resistance, inductance });
 	}
 }
 
@@ -543,10 +593,8 @@ TopologicalPowerComp::Ptr Reader::mapSynchronousMachine(SynchronousMachine* mach
 					ratedPower = unitValue(machine->ratedS.value, UnitMultiplier::M);
 
 					ratedVoltage = unitValue(machine->ratedU.value, UnitMultiplier::k);
-					auto gen = DP::Ph1::SynchronGeneratorTrStab::make(machine->mRID, machine->name, mComponentLogLevel);
-					gen->setStandardParametersPU(ratedPower, ratedVoltage, mFrequency,
-						directTransientReactance, inertiaCoefficient);
-					return gen;
+					return makeComponent(ComponentType::DP_Ph1_SynchronGeneratorTrStab, machine->mRID, machine->name,
+						{ ratedPower, ratedVoltage, mFrequency, directTransientReactance, inertiaCoefficient });
 				}
 			}
 		}
@@ -585,15 +633,12 @@ TopologicalPowerComp::Ptr Reader::mapSynchronousMachine(SynchronousMachine* mach
 							std::cerr << "Uninitalized maximumReactivePower for GeneratingUnit " <<  machine->name << ". Using default value of " << maximumReactivePower << std::endl;
 						}
 
-						auto gen = std::make_shared<SP::Ph1::SynchronGenerator>(machine->mRID, machine->name, mComponentLogLevel);
-							gen->setParameters(unitValue(machine->ratedS.value, UnitMultiplier::M),
-									unitValue(machine->ratedU.value, UnitMultiplier::k),
-									setPointActivePower,
-									setPointVoltage,
-									maximumReactivePower,
-									PowerflowBusType::PV);
-							gen->setBaseVoltage(unitValue(machine->ratedU.value, UnitMultiplier::k));
-						return gen;
+						return makeComponent(ComponentType::SP_Ph1_SynchronGenerator, machine->mRID, machine->name,
+							{ unitValue(machine->ratedS.value, UnitMultiplier::M),
+							  unitValue(machine->ratedU.value, UnitMultiplier::k),
+							  setPointActivePower,
+							  setPointVoltage,
+							  maximumReactivePower });
 					}
 				}
 
@@ -601,10 +646,10 @@ TopologicalPowerComp::Ptr Reader::mapSynchronousMachine(SynchronousMachine* mach
 
 		}
 		mSLog->info("no corresponding initial power for {}", machine->name);
-		return std::make_shared<SP::Ph1::SynchronGenerator>(machine->mRID, machine->name, mComponentLogLevel);
+		return makeComponent(ComponentType::SP_Ph1_SynchronGenerator, machine->mRID, machine->name);
 	}
     else {
-        return std::make_shared<DP::Ph1::SynchronGeneratorIdeal>(machine->mRID, machine->name, mComponentLogLevel);
+        return makeComponent(ComponentType::DP_Ph1_SynchronGeneratorIdeal, machine->mRID, machine->name);
     }
 }
 
@@ -612,7 +657,7 @@ TopologicalPowerComp::Ptr Reader::mapExternalNetworkInjection(ExternalNetworkInj
 	mSLog->info("Found External Network Injection {}", extnet->name);
 	if (mDomain == Domain::EMT) {
 		if (mPhase == PhaseType::ABC) {
-			return std::make_shared<EMT::Ph3::NetworkInjection>(extnet->mRID, extnet->name, mComponentLogLevel);
+			return makeComponent(ComponentType::EMT_Ph3_NetworkInjection, extnet->mRID, extnet->name);
 		}
 		else {
 			throw SystemError("Mapping of ExternalNetworkInjection for EMT::Ph1 not existent!");
@@ -620,14 +665,13 @@ TopologicalPowerComp::Ptr Reader::mapExternalNetworkInjection(ExternalNetworkInj
 		}
 	} else if(mDomain == Domain::SP) {
 		if (mPhase == PhaseType::Single) {
-			auto cpsextnet = std::make_shared<SP::Ph1::externalGridInjection>(extnet->mRID, extnet->name, mComponentLogLevel);
-			cpsextnet->modifyPowerFlowBusType(PowerflowBusType::VD); // for powerflow solver set as VD component as default
+			std::vector<Real> parameters;
 			if(extnet->RegulatingControl){
 				mSLog->info("       Voltage set-point={}", (float) extnet->RegulatingControl->targetValue);
-				cpsextnet->setParameters(extnet->RegulatingControl->targetValue); // assumes that value is specified in CIM data in per unit
+				parameters.push_back(extnet->RegulatingControl->targetValue); // assumes that value is specified in CIM data in per unit
 			} else
 				mSLog->info("       No voltage set-point defined.");
-			return cpsextnet;
+			return makeComponent(ComponentType::SP_Ph1_externalGridInjection, extnet->mRID, extnet->name, parameters);
 		}
 		else {
 			throw SystemError("Mapping of ExternalNetworkInjection for SP::Ph3 not existent!");
@@ -635,7 +679,7 @@ TopologicalPowerComp::Ptr Reader::mapExternalNetworkInjection(ExternalNetworkInj
 		}
 	} else {
 		if (mPhase == PhaseType::Single) {
-			return std::make_shared<DP::Ph1::NetworkInjection>(extnet->mRID, extnet->name, mComponentLogLevel);
+			return makeComponent(ComponentType::DP_Ph1_NetworkInjection, extnet->mRID, extnet->name);
 		} else {
 			throw SystemError("Mapping of ExternalNetworkInjection for DP::Ph3 not existent!");
 			return nullptr;
@@ -670,10 +714,104 @@ TopologicalPowerComp::Ptr Reader::mapEquivalentShunt(EquivalentShunt* shunt){
 		}
     }
 
-	auto cpsShunt = std::make_shared<SP::Ph1::Shunt>(shunt->mRID, shunt->name, mComponentLogLevel);
-	cpsShunt->setParameters(shunt->g.value, shunt->b.value);
-	cpsShunt->setBaseVoltage(baseVoltage);
-	return cpsShunt;
+	return makeComponent(ComponentType::SP_Ph1_Shunt, shunt->mRID, shunt->name,
+		{ shunt->g.value, shunt->b.value, baseVoltage });
+}
+
+TopologicalPowerComp::Ptr Reader::makeComponent(ComponentType type, String uid, String name, std::vector<Real> parameters) {
+	TopologyCache::ComponentRecord record;
+	record.type = type;
+	record.uid = uid;
+	record.name = name;
+	record.parameters = parameters;
+	mCache.addComponent(record);
+	return createComponent(record);
+}
+
+TopologicalPowerComp::Ptr Reader::createComponent(const TopologyCache::ComponentRecord &record) {
+	const std::vector<Real> &p = record.parameters;
+
+	switch (record.type) {
+	case ComponentType::DP_Ph1_RXLoad:
+		return std::make_shared<DP::Ph1::RXLoad>(record.uid, record.name, mComponentLogLevel);
+	case ComponentType::EMT_Ph3_RXLoad:
+		return std::make_shared<EMT::Ph3::RXLoad>(record.uid, record.name, mComponentLogLevel);
+	case ComponentType::SP_Ph1_Load: {
+		auto load = std::make_shared<SP::Ph1::Load>(record.uid, record.name, mComponentLogLevel);
+		load->setParameters(0, 0, 0);
+		load->modifyPowerFlowBusType(PowerflowBusType::PQ); // for powerflow solver set as PQ component as default
+		return load;
+	}
+	case ComponentType::DP_Ph1_PiLine: {
+		auto cpsLine = std::make_shared<DP::Ph1::PiLine>(record.uid, record.name, mComponentLogLevel);
+		cpsLine->setParameters(p[0], p[1], p[2], p[3]);
+		return cpsLine;
+	}
+	case ComponentType::EMT_Ph3_PiLine: {
+		auto cpsLine = std::make_shared<EMT::Ph3::PiLine>(record.uid, record.name, mComponentLogLevel);
+		cpsLine->setParameters(singlePhaseParameterToThreePhase(p[0]), singlePhaseParameterToThreePhase(p[1]),
+			singlePhaseParameterToThreePhase(p[2]), singlePhaseParameterToThreePhase(p[3]));
+		return cpsLine;
+	}
+	case ComponentType::SP_Ph1_PiLine: {
+		auto cpsLine = std::make_shared<SP::Ph1::PiLine>(record.uid, record.name, mComponentLogLevel);
+		cpsLine->setParameters(p[0], p[1], p[2], p[3], p[4]);
+		cpsLine->setBaseVoltage(p[5]);
+		return cpsLine;
+	}
+	case ComponentType::DP_Ph1_Transformer: {
+		Bool withResistiveLosses = p[2] > 0;
+		auto transformer = std::make_shared<DP::Ph1::Transformer>(record.uid, record.name, mComponentLogLevel, withResistiveLosses);
+		transformer->setParameters(p[0], p[1], p[2], p[3]);
+		return transformer;
+	}
+	case ComponentType::EMT_Ph3_Transformer: {
+		Bool withResistiveLosses = p[2] > 0;
+		auto transformer = std::make_shared<EMT::Ph3::Transformer>(record.uid, record.name, mComponentLogLevel, withResistiveLosses);
+		transformer->setParameters(p[0], p[1], singlePhaseParameterToThreePhase(p[2]), singlePhaseParameterToThreePhase(p[3]));
+		return transformer;
+	}
+	case ComponentType::SP_Ph1_Transformer: {
+		auto transformer = std::make_shared<SP::Ph1::Transformer>(record.uid, record.name, mComponentLogLevel);
+		transformer->setParameters(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+		transformer->setBaseVoltage(p[0] >= p[1] ? p[0] : p[1]);
+		return transformer;
+	}
+	case ComponentType::DP_Ph1_SynchronGeneratorTrStab: {
+		auto gen = DP::Ph1::SynchronGeneratorTrStab::make(record.uid, record.name, mComponentLogLevel);
+		gen->setStandardParametersPU(p[0], p[1], p[2], p[3], p[4]);
+		return gen;
+	}
+	case ComponentType::DP_Ph1_SynchronGeneratorIdeal:
+		return std::make_shared<DP::Ph1::SynchronGeneratorIdeal>(record.uid, record.name, mComponentLogLevel);
+	case ComponentType::SP_Ph1_SynchronGenerator: {
+		auto gen = std::make_shared<SP::Ph1::SynchronGenerator>(record.uid, record.name, mComponentLogLevel);
+		// Without parameters if there is no corresponding generating unit
+		if (p.size() == 5) {
+			gen->setParameters(p[0], p[1], p[2], p[3], p[4], PowerflowBusType::PV);
+			gen->setBaseVoltage(p[1]);
+		}
+		return gen;
+	}
+	case ComponentType::DP_Ph1_NetworkInjection:
+		return std::make_shared<DP::Ph1::NetworkInjection>(record.uid, record.name, mComponentLogLevel);
+	case ComponentType::EMT_Ph3_NetworkInjection:
+		return std::make_shared<EMT::Ph3::NetworkInjection>(record.uid, record.name, mComponentLogLevel);
+	case ComponentType::SP_Ph1_externalGridInjection: {
+		auto cpsextnet = std::make_shared<SP::Ph1::externalGridInjection>(record.uid, record.name, mComponentLogLevel);
+		cpsextnet->modifyPowerFlowBusType(PowerflowBusType::VD); // for powerflow solver set as VD component as default
+		if (p.size() == 1)
+			cpsextnet->setParameters(p[0]);
+		return cpsextnet;
+	}
+	case ComponentType::SP_Ph1_Shunt: {
+		auto cpsShunt = std::make_shared<SP::Ph1::Shunt>(record.uid, record.name, mComponentLogLevel);
+		cpsShunt->setParameters(p[0], p[1]);
+		cpsShunt->setBaseVoltage(p[2]);
+		return cpsShunt;
+	}
+	}
+	return nullptr;
 }
 
 
@@ -775,6 +913,7 @@ void Reader::processTopologicalNode(IEC61970::Base::Topology::TopologicalNode* t
 			auto pfEquipment = mPowerflowEquipment.at(equipment->mRID);
 			std::dynamic_pointer_cast<SimPowerComp<VarType>>(pfEquipment)->setTerminalAt(
 				std::dynamic_pointer_cast<SimTerminal<VarType>>(mPowerflowTerminals[term->mRID]), term->sequenceNumber-1);
+			mCache.connectTerminal(equipment->mRID, term->sequenceNumber-1, term->mRID);
 
 			mSLog->info("        Added Terminal {} to Equipment {}", term->mRID, equipment->mRID);
 		}
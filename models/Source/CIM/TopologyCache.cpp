@@ -0,0 +1,342 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <cps/CIM/TopologyCache.h>
+
+using namespace CPS;
+using namespace CPS::CIM;
+
+namespace fs = std::experimental::filesystem;
+
+namespace {
+	const char magic[8] = { 'C', 'P', 'S', 'T', 'O', 'P', 'O', '\0' };
+
+	/// Read-only view of a whole file, memory-mapped where available
+	class MappedFile {
+	public:
+		MappedFile(const fs::path &file) {
+#ifndef _WIN32
+			int fd = ::open(file.c_str(), O_RDONLY);
+			if (fd < 0)
+				return;
+			mOpen = true;
+			struct stat st;
+			if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+				void *mapping = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapping != MAP_FAILED) {
+					mData = static_cast<const char*>(mapping);
+					mSize = static_cast<std::size_t>(st.st_size);
+				}
+			}
+			::close(fd);
+#else
+			std::ifstream stream(file.string(), std::ios_base::in | std::ios_base::binary);
+			if (!stream.is_open())
+				return;
+			mOpen = true;
+			mContent.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+			mData = mContent.data();
+			mSize = mContent.size();
+#endif
+		}
+
+		~MappedFile() {
+#ifndef _WIN32
+			if (mData)
+				::munmap(const_cast<char*>(mData), mSize);
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		Bool isOpen() const { return mOpen; }
+		const char* data() const { return mData; }
+		std::size_t size() const { return mSize; }
+
+	private:
+		Bool mOpen = false;
+		const char *mData = nullptr;
+		std::size_t mSize = 0;
+#ifdef _WIN32
+		String mContent;
+#endif
+	};
+
+	/// 64 bit FNV-1a
+	void hashBytes(std::uint64_t &hash, const void *data, std::size_t size) {
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ULL;
+		}
+	}
+
+	class CacheWriter {
+	public:
+		CacheWriter(std::ofstream &file) : mFile(file) { }
+
+		template <typename T>
+		void write(const T &value) { mFile.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+		void write(const String &value) {
+			write<std::uint64_t>(value.size());
+			mFile.write(value.data(), value.size());
+		}
+
+		void write(const MatrixComp &value) {
+			write<std::uint64_t>(value.rows());
+			write<std::uint64_t>(value.cols());
+			mFile.write(reinterpret_cast<const char*>(value.data()), sizeof(Complex) * value.size());
+		}
+
+	private:
+		std::ofstream &mFile;
+	};
+
+	/// Thrown if the cache ends before all records are read
+	class Truncated { };
+
+	class CacheReader {
+	public:
+		CacheReader(const char *begin, const char *end) : mPos(begin), mEnd(end) { }
+
+		void readBytes(void *dst, std::size_t size) {
+			if (size > static_cast<std::size_t>(mEnd - mPos))
+				throw Truncated();
+			std::memcpy(dst, mPos, size);
+			mPos += size;
+		}
+
+		template <typename T>
+		T read() {
+			T value;
+			readBytes(&value, sizeof(T));
+			return value;
+		}
+
+		String readString() {
+			std::uint64_t size = read<std::uint64_t>();
+			if (size > static_cast<std::uint64_t>(mEnd - mPos))
+				throw Truncated();
+			String value(mPos, size);
+			mPos += size;
+			return value;
+		}
+
+		MatrixComp readMatrix() {
+			std::uint64_t rows = read<std::uint64_t>();
+			std::uint64_t cols = read<std::uint64_t>();
+			if (rows * cols > static_cast<std::uint64_t>(mEnd - mPos) / sizeof(Complex))
+				throw Truncated();
+			MatrixComp value(rows, cols);
+			readBytes(value.data(), sizeof(Complex) * value.size());
+			return value;
+		}
+
+	private:
+		const char *mPos;
+		const char *mEnd;
+	};
+}
+
+const std::uint32_t TopologyCache::version;
+
+std::uint64_t TopologyCache::key(const std::list<fs::path> &files, const std::vector<Real> &settings) {
+	std::uint64_t hash = 0xcbf29ce484222325ULL;
+	for (auto &file : files) {
+		MappedFile input(file);
+		if (!input.isOpen())
+			throw SystemError("Cannot open " + file.string());
+		std::uint64_t size = input.size();
+		hashBytes(hash, &size, sizeof(size));
+		hashBytes(hash, input.data(), input.size());
+	}
+	hashBytes(hash, settings.data(), sizeof(Real) * settings.size());
+	return hash;
+}
+
+void TopologyCache::clear() {
+	mNodes.clear();
+	mTerminals.clear();
+	mComponents.clear();
+}
+
+void TopologyCache::connectTerminal(const String &comp, UInt position, const String &terminal) {
+	auto search = mComponents.find(comp);
+	if (search != mComponents.end())
+		search->second.terminals.push_back(std::make_pair(position, terminal));
+}
+
+void TopologyCache::save(const fs::path &file, std::uint64_t key) const {
+	std::ofstream output(file.string(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!output.is_open())
+		throw SystemError("Cannot open topology cache " + file.string());
+
+	CacheWriter out(output);
+	output.write(magic, sizeof(magic));
+	out.write(version);
+	out.write(key);
+
+	out.write<std::uint64_t>(mNodes.size());
+	for (auto &node : mNodes) {
+		out.write(node.uid);
+		out.write(node.name);
+		out.write(node.matrixNodeIndex);
+		out.write(node.initialVoltage);
+	}
+
+	out.write<std::uint64_t>(mTerminals.size());
+	for (auto &term : mTerminals) {
+		out.write(term.uid);
+		out.write(term.node);
+		out.write(term.power);
+	}
+
+	out.write<std::uint64_t>(mComponents.size());
+	for (auto &entry : mComponents) {
+		auto &comp = entry.second;
+		out.write(comp.type);
+		out.write(comp.uid);
+		out.write(comp.name);
+		out.write<std::uint64_t>(comp.parameters.size());
+		for (auto param : comp.parameters)
+			out.write(param);
+		out.write<std::uint64_t>(comp.terminals.size());
+		for (auto &term : comp.terminals) {
+			out.write(term.first);
+			out.write(term.second);
+		}
+	}
+
+	if (!output)
+		throw SystemError("Cannot write topology cache " + file.string());
+}
+
+Bool TopologyCache::validParameters(ComponentType type, std::size_t count) {
+	switch (type) {
+	case ComponentType::DP_Ph1_RXLoad:
+	case ComponentType::EMT_Ph3_RXLoad:
+	case ComponentType::SP_Ph1_Load:
+	case ComponentType::DP_Ph1_SynchronGeneratorIdeal:
+	case ComponentType::DP_Ph1_NetworkInjection:
+	case ComponentType::EMT_Ph3_NetworkInjection:
+		return count == 0;
+	case ComponentType::DP_Ph1_PiLine:
+	case ComponentType::EMT_Ph3_PiLine:
+	case ComponentType::DP_Ph1_Transformer:
+	case ComponentType::EMT_Ph3_Transformer:
+		return count == 4;
+	case ComponentType::SP_Ph1_PiLine:
+		return count == 6;
+	case ComponentType::SP_Ph1_Transformer:
+		return count == 8;
+	case ComponentType::DP_Ph1_SynchronGeneratorTrStab:
+		return count == 5;
+	// Parameters are only stored if the source data has them
+	case ComponentType::SP_Ph1_SynchronGenerator:
+		return count == 0 || count == 5;
+	case ComponentType::SP_Ph1_externalGridInjection:
+		return count == 0 || count == 1;
+	case ComponentType::SP_Ph1_Shunt:
+		return count == 3;
+	}
+	return false;
+}
+
+Bool TopologyCache::load(const fs::path &file, std::uint64_t key) {
+	clear();
+
+	MappedFile input(file);
+	if (!input.isOpen() || input.size() < sizeof(magic)
+		|| std::memcmp(input.data(), magic, sizeof(magic)) != 0)
+		return false;
+
+	CacheReader in(input.data() + sizeof(magic), input.data() + input.size());
+	try {
+		if (in.read<std::uint32_t>() != version || in.read<std::uint64_t>() != key)
+			return false;
+
+		std::uint64_t count = in.read<std::uint64_t>();
+		for (std::uint64_t i = 0; i < count; i++) {
+			NodeRecord node;
+			node.uid = in.readString();
+			node.name = in.readString();
+			node.matrixNodeIndex = in.read<UInt>();
+			node.initialVoltage = in.readMatrix();
+			mNodes.push_back(node);
+		}
+
+		count = in.read<std::uint64_t>();
+		for (std::uint64_t i = 0; i < count; i++) {
+			TerminalRecord term;
+			term.uid = in.readString();
+			term.node = in.readString();
+			term.power = in.readMatrix();
+			mTerminals.push_back(term);
+		}
+
+		count = in.read<std::uint64_t>();
+		for (std::uint64_t i = 0; i < count; i++) {
+			ComponentRecord comp;
+			comp.type = in.read<ComponentType>();
+			comp.uid = in.readString();
+			comp.name = in.readString();
+			std::uint64_t numParams = in.read<std::uint64_t>();
+			for (std::uint64_t p = 0; p < numParams; p++)
+				comp.parameters.push_back(in.read<Real>());
+			std::uint64_t numTerminals = in.read<std::uint64_t>();
+			for (std::uint64_t t = 0; t < numTerminals; t++) {
+				UInt position = in.read<UInt>();
+				comp.terminals.push_back(std::make_pair(position, in.readString()));
+			}
+			mComponents[comp.uid] = comp;
+		}
+	}
+	catch (Truncated &) {
+		clear();
+		return false;
+	}
+
+	// A damaged cache with a matching key is treated like a missing one
+	// instead of creating components from invalid records
+	std::unordered_set<String> nodes, terminals;
+	for (auto &node : mNodes)
+		nodes.insert(node.uid);
+	for (auto &term : mTerminals) {
+		if (!term.node.empty() && nodes.find(term.node) == nodes.end()) {
+			clear();
+			return false;
+		}
+		terminals.insert(term.uid);
+	}
+	for (auto &entry : mComponents) {
+		auto &comp = entry.second;
+		Bool valid = validParameters(comp.type, comp.parameters.size());
+		for (auto &term : comp.terminals)
+			valid = valid && terminals.find(term.second) != terminals.end();
+		if (!valid) {
+			clear();
+			return false;
+		}
+	}
+
+	return true;
+}
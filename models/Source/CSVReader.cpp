@@ -6,12 +6,275 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 #include <cps/CSVReader.h>
 
 namespace fs = std::experimental::filesystem;
 
 using namespace CPS;
 
+// Calls func(i) for i in [0, count) on the given number of threads
+template <typename Func>
+static void parallelFor(std::size_t count, UInt numThreads, Func func) {
+	if (numThreads == 0)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+	numThreads = static_cast<UInt>(std::min<std::size_t>(numThreads, count));
+
+	std::vector<std::exception_ptr> errors(count);
+	std::atomic<std::size_t> next(0);
+	auto worker = [&]() {
+		for (std::size_t i = next++; i < count; i = next++) {
+			try {
+				func(i);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (UInt t = 1; t < numThreads; t++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	for (auto& error : errors) {
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
+
+// Exact powers of ten, larger exponents are not represented exactly
+static const Real exactPowersOf10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+Bool CSVData::parseReal(const char*& pos, const char* end, Real& value) {
+	const char *p = pos;
+	Bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+
+	unsigned long long mantissa = 0;
+	Int exponent = 0, digits = 0, significant = 0;
+	for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+		if (significant < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa > 0) significant++;
+		} else
+			exponent++;
+	}
+	if (p < end && *p == '.') {
+		for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+			if (significant < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa > 0) significant++;
+				exponent--;
+			}
+		}
+	}
+	if (digits == 0)
+		return false;
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char *e = p + 1;
+		Bool negExp = false;
+		if (e < end && (*e == '-' || *e == '+'))
+			negExp = *e++ == '-';
+		if (e < end && *e >= '0' && *e <= '9') {
+			Int exp = 0;
+			for (; e < end && *e >= '0' && *e <= '9'; e++)
+				exp = exp < 10000 ? exp * 10 + (*e - '0') : exp;
+			exponent += negExp ? -exp : exp;
+			p = e;
+		}
+	}
+
+	// The result is correctly rounded if the mantissa and the power
+	// of ten are exact doubles, otherwise use the C library
+	if (mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+		value = exponent < 0
+			? static_cast<Real>(mantissa) / exactPowersOf10[-exponent]
+			: static_cast<Real>(mantissa) * exactPowersOf10[exponent];
+	} else {
+		String number(pos, p);
+		value = std::strtod(number.c_str(), nullptr);
+		negative = false;
+	}
+	if (negative)
+		value = -value;
+
+	pos = p;
+	return true;
+}
+
+UInt CSVData::parseRow(const char* pos, const char* end, Bool timeOfDay, Real* values, UInt maxValues) {
+	UInt count = 0;
+	while (pos < end && count < maxValues) {
+		while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+			pos++;
+		if (pos == end)
+			break;
+
+		Real value;
+		if (!parseReal(pos, end, value))
+			throw SystemError("Invalid number in CSV file");
+		if (timeOfDay && count == 0 && pos < end && *pos == ':') {
+			// HH:MM[:SS]
+			Real minutes = 0, seconds = 0;
+			pos++;
+			parseReal(pos, end, minutes);
+			if (pos < end && *pos == ':') {
+				pos++;
+				parseReal(pos, end, seconds);
+			}
+			value = value * 3600 + minutes * 60 + seconds;
+		}
+		values[count++] = value;
+
+		const char *sep = static_cast<const char*>(std::memchr(pos, ',', end - pos));
+		if (!sep)
+			break;
+		pos = sep + 1;
+	}
+	return count;
+}
+
+void CSVData::parseRows(const char* begin, const char* end, Bool timeOfDay, std::vector<Real>& values) const {
+	std::vector<Real> row(mColumns);
+	const char *pos = begin;
+	while (pos < end) {
+		const char *lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+		if (!lineEnd)
+			lineEnd = end;
+
+		UInt count = parseRow(pos, lineEnd, timeOfDay, row.data(), mColumns);
+		if (count == mColumns)
+			values.insert(values.end(), row.begin(), row.end());
+		else if (count > 0)
+			throw SystemError("Row with missing values in CSV file");
+
+		pos = lineEnd + 1;
+	}
+}
+
+CSVData::CSVData(const fs::path& file, Bool timeOfDay, UInt numThreads) {
+	const char *data = nullptr;
+	std::size_t size = 0;
+
+#ifndef _WIN32
+	int fd = ::open(file.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw SystemError("Cannot open " + file.string());
+	struct stat st;
+	void *mapping = MAP_FAILED;
+	if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+		size = static_cast<std::size_t>(st.st_size);
+		mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	::close(fd);
+	if (mapping == MAP_FAILED)
+		size = 0;
+	else
+		data = static_cast<const char*>(mapping);
+#else
+	String content;
+	std::ifstream stream(file.string(), std::ios_base::in | std::ios_base::binary);
+	if (!stream.is_open())
+		throw SystemError("Cannot open " + file.string());
+	content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	data = content.data();
+	size = content.size();
+#endif
+
+	try {
+		const char *pos = data, *end = data + size;
+		auto nextLine = [end](const char *p) {
+			const char *lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			return lineEnd ? lineEnd + 1 : end;
+		};
+
+		// ignore the first row if it does not start with a number
+		while (pos < end && (*pos == ' ' || *pos == '\t'))
+			pos++;
+		const char *first = pos;
+		Real value;
+		if (pos < end && !parseReal(first, end, value))
+			pos = nextLine(pos);
+
+		// The number of columns is given by the first row of data
+		for (const char *line = pos; line < end && mColumns == 0; line = nextLine(line)) {
+			std::vector<Real> row(std::count(line, nextLine(line), ',') + 1);
+			mColumns = parseRow(line, nextLine(line), timeOfDay, row.data(), static_cast<UInt>(row.size()));
+		}
+
+		if (mColumns > 0) {
+			// Split the data into chunks at line ends, small files are read at once
+			const std::size_t minChunkSize = 1 << 20;
+			std::size_t numChunks = std::max<std::size_t>(1, (end - pos) / minChunkSize);
+			if (numThreads == 0)
+				numThreads = std::max(1U, std::thread::hardware_concurrency());
+			numChunks = std::min<std::size_t>(numChunks, numThreads);
+
+			std::vector<const char*> bounds(numChunks + 1, end);
+			bounds[0] = pos;
+			for (std::size_t c = 1; c < numChunks; c++)
+				bounds[c] = nextLine(std::max(bounds[c - 1], pos + (end - pos) * c / numChunks));
+
+			std::vector<std::vector<Real>> chunks(numChunks);
+			parallelFor(numChunks, numThreads, [&](std::size_t c) {
+				parseRows(bounds[c], bounds[c + 1], timeOfDay, chunks[c]);
+			});
+
+			std::size_t total = 0;
+			for (auto& chunk : chunks)
+				total += chunk.size();
+			mValues.reserve(total);
+			for (auto& chunk : chunks)
+				mValues.insert(mValues.end(), chunk.begin(), chunk.end());
+		}
+	} catch (...) {
+#ifndef _WIN32
+		if (data)
+			::munmap(const_cast<char*>(data), size);
+#endif
+		throw;
+	}
+
+#ifndef _WIN32
+	if (data)
+		::munmap(const_cast<char*>(data), size);
+#endif
+}
+
+void CSVReader::runParallel(ReadJobs& jobs) {
+	std::vector<std::function<void()>> list;
+	for (auto& job : jobs)
+		list.push_back(job.second);
+
+	// Every file is read by a single thread if there are multiple files
+	mChunkThreads = list.size() > 1 ? 1 : mNumThreads;
+	parallelFor(list.size(), mNumThreads, [&list](std::size_t i) { list[i](); });
+	mChunkThreads = mNumThreads;
+	jobs.clear();
+}
+
 void CSVRow::readNextRow(std::istream& str) {
 	std::string line;
 	std::getline(str, line);
@@ -117,43 +380,33 @@ std::vector<PQData> CSVReader::readLoadProfileDP(std::experimental::filesystem::
 	Real start_time, Real time_step, Real end_time, Real scale_factor, CSVReader::DataFormat format) {
 
 	std::vector<PQData> load_profileDP;
-	std::ifstream csvfile(file);
-	CSVReaderIterator row_(csvfile);
+	CSVData data(file, format == DataFormat::HHMMSS, mChunkThreads);
+	if (data.rows() > 0 && data.columns() < 3)
+		throw SystemError("Load profile " + file.string() + " requires P and Q columns");
 
-	// ignore the first row if it is a title
-	if (!std::isdigit((*row_).get(0)[0])) {
-		row_.next();
-	}
 	/*
-	 loop over rows of the csv file to find the entry point to read in.
+	 skip the rows before the entry point, the rows are read as one per second.
 	 if start_time and end_time are negative (as default), it reads in all rows.
 	*/
-	Real presentTime = 0;
-	for (; row_ != CSVReaderIterator(); row_.next()) {
-		if ((start_time < 0) | (Int(presentTime) + 1 > Int(start_time)))
-			break;
-		presentTime++;
-	}
+	std::size_t row = 0;
+	if (start_time >= 0 && Int(start_time) > 0)
+		row = static_cast<std::size_t>(Int(start_time));
+	Real presentTime = static_cast<Real>(row);
 	/*
 	 reading data after entry point until end_time is reached
 	*/
-	for (; row_ != CSVReaderIterator(); row_.next()) {
+	for (; row < data.rows(); row++) {
 		// IMPORTANT: take care of units. assume kW
 		PQData pq;
 		// multiplied by 1000 due to unit conversion (kw to w)
-		pq.p = std::stod((*row_).get(1)) * 1000 * scale_factor;
-		pq.q = std::stod((*row_).get(2)) * 1000 * scale_factor;
+		pq.p = data.get(row, 1) * 1000 * scale_factor;
+		pq.q = data.get(row, 2) * 1000 * scale_factor;
 		load_profileDP.push_back(pq);
 		if (end_time > 0 && presentTime > end_time)
 			break;
-		/*while (presentTime + time_step < Int(presentTime) + 1)
-		{
-			presentTime += time_step;
-			p_data.push_back(p_data.back());
-		}*/
 		presentTime = Int(presentTime) + 1;
 	}
-	std::cout<<"CSV loaded."<<std::endl;
+	mSLog->debug("Loaded {} rows of {}", load_profileDP.size(), file.string());
 	return load_profileDP;
 }
 
@@ -161,6 +414,10 @@ void CSVReader::assignLoadProfileSP(std::vector<std::shared_ptr<CPS::SP::Ph1::Av
  Real start_time, Real time_step, Real end_time, Real scale_factor,
 	CSVReader::Mode mode, CSVReader::DataFormat format) {
 
+	// Profiles are read in parallel once all loads have been matched.
+	// Later matches for the same load replace earlier ones.
+	ReadJobs jobs;
+
 	switch (mode) {
 		case CSVReader::Mode::AUTO: {
 			for (auto load : loads) {
@@ -176,7 +433,7 @@ void CSVReader::assignLoadProfileSP(std::vector<std::shared_ptr<CPS::SP::Ph1::Av
 					load_name.erase(remove_if(load_name.begin(), load_name.end(), [](char c) { return !isalnum(c); }), load_name.end());
 					file_name.erase(remove_if(file_name.begin(), file_name.end(), [](char c) { return !isalnum(c); }), file_name.end());
 					if (std::stoi(file_name) == std::stoi(load_name)) {
-						load->mLoadProfile = readLoadProfileDP(file, start_time, time_step, end_time, scale_factor, format);
+						jobs[load.get()] = [=]() { load->mLoadProfile = readLoadProfileDP(file, start_time, time_step, end_time, scale_factor, format); };
 						mSLog->info("Assigned {} to {}", file.filename().string(), load->name());
 					}
 				}
@@ -198,7 +455,7 @@ void CSVReader::assignLoadProfileSP(std::vector<std::shared_ptr<CPS::SP::Ph1::Av
 					}
 					for(auto path: mFileList){
 						if(path.string().find(file->second)!= std::string::npos){
-							load->mLoadProfile = readLoadProfileDP(path, start_time, time_step, end_time, scale_factor);
+							jobs[load.get()] = [=]() { load->mLoadProfile = readLoadProfileDP(path, start_time, time_step, end_time, scale_factor); };
 							mSLog->info("Assigned {}.csv to {}", file->second, load->name());
 							LP_assigned_counter++;
 						}
@@ -214,6 +471,8 @@ void CSVReader::assignLoadProfileSP(std::vector<std::shared_ptr<CPS::SP::Ph1::Av
 			break;
 		}
 	}
+
+	runParallel(jobs);
 }
 
 
@@ -283,6 +542,10 @@ void CSVReader::assignLoadProfileDP(std::vector<std::shared_ptr<CPS::DP::Ph1::Av
  Real start_time, Real time_step, Real end_time, Real scale_factor,
 	CSVReader::Mode mode, CSVReader::DataFormat format) {
 
+	// Profiles are read in parallel once all loads have been matched.
+	// Later matches for the same load replace earlier ones.
+	ReadJobs jobs;
+
 	switch (mode) {
 		case CSVReader::Mode::AUTO: {
 			for (auto load : loads) {
@@ -298,7 +561,7 @@ void CSVReader::assignLoadProfileDP(std::vector<std::shared_ptr<CPS::DP::Ph1::Av
 					load_name.erase(remove_if(load_name.begin(), load_name.end(), [](char c) { return !isalnum(c); }), load_name.end());
 					file_name.erase(remove_if(file_name.begin(), file_name.end(), [](char c) { return !isalnum(c); }), file_name.end());
 					if (std::stoi(file_name) == std::stoi(load_name)) {
-						load->mLoadProfile = readLoadProfileDP(file, start_time, time_step, end_time, scale_factor, format);
+						jobs[load.get()] = [=]() { load->mLoadProfile = readLoadProfileDP(file, start_time, time_step, end_time, scale_factor, format); };
 						mSLog->info("Assigned {} to {}", file.filename().string(), load->name());
 					}
 				}
@@ -320,7 +583,7 @@ void CSVReader::assignLoadProfileDP(std::vector<std::shared_ptr<CPS::DP::Ph1::Av
 					}
 					for(auto path: mFileList){
 						if(path.string().find(file->second)!= std::string::npos){
-							load->mLoadProfile = readLoadProfileDP(path, start_time, time_step, end_time, scale_factor);
+							jobs[load.get()] = [=]() { load->mLoadProfile = readLoadProfileDP(path, start_time, time_step, end_time, scale_factor); };
 							mSLog->info("Assigned {}.csv to {}", file->second, load->name());
 							LP_assigned_counter++;
 						}
@@ -336,6 +599,8 @@ void CSVReader::assignLoadProfileDP(std::vector<std::shared_ptr<CPS::DP::Ph1::Av
 			break;
 		}
 	}
+
+	runParallel(jobs);
 }
 
 
@@ -345,68 +610,52 @@ PowerProfile CSVReader::readLoadProfile(std::experimental::filesystem::path file
 	Real start_time, Real time_step, Real end_time, CSVReader::DataFormat format) {
 
 	PowerProfile load_profile;
-	std::ifstream csvfile(file);
-	bool need_that_conversion = (format == DataFormat::HHMMSS) ? true : false;
-	bool data_with_weighting_factor = false;
-
-	CSVReaderIterator loop(csvfile);
+	CSVData data(file, format == DataFormat::HHMMSS, mChunkThreads);
+	// assuming only time,p,q or time,weighting factor
+	bool data_with_weighting_factor = data.columns() == 2;
+	if (data.rows() > 0 && data.columns() < 2)
+		throw SystemError("Load profile " + file.string() + " has no data columns");
 
-	// ignore the first row if it is a title
-	if (!std::isdigit((*loop).get(0)[0])) {
-		loop.next();
-	}
 	/*
-	 loop over rows of the csv file to find the entry point to read in.
-	 and determine data type prior to read in. (assuming only time,p,q or time,weighting factor)
+	 find the entry point to read in, which is the row before the first row
+	 at or after start_time.
 	 if start_time and end_time are negative (as default), it reads in all rows.
 	*/
-	for (; loop != CSVReaderIterator(); loop.next()) {
-		CSVReaderIterator nextRow = loop;
-		nextRow.next();
-		CPS::Real nextTime = (need_that_conversion) ? time_format_convert((*nextRow).get(0)) : std::stod((*nextRow).get(0));
-		if ((*nextRow).size() == 2) {
-			data_with_weighting_factor = true;
-		}
-		if ((start_time < 0) | (nextTime >= Int(start_time)))
-		{
-			break;
-		}
+	std::size_t row = 0;
+	if (start_time >= 0) {
+		while (row + 1 < data.rows() && data.get(row + 1, 0) < Int(start_time))
+			row++;
 	}
 	/*
 	 reading data after entry point until end_time is reached
 	*/
-	for (; loop != CSVReaderIterator(); loop.next()) {
-		CPS::Real currentTime = (need_that_conversion) ? time_format_convert((*loop).get(0)) : std::stod((*loop).get(0));
+	for (; row < data.rows(); row++) {
+		CPS::Real currentTime = data.get(row, 0);
 		if (data_with_weighting_factor) {
-			Real wf = std::stod((*loop).get(1));
-			load_profile.weightingFactors.insert(std::pair<Real, Real>(currentTime, wf));
+			load_profile.weightingFactors.insert(std::pair<Real, Real>(currentTime, data.get(row, 1)));
 		}
 		else {
-		PQData pq;
-		// multiplied by 1000 due to unit conversion (kw to w)
-		pq.p = std::stod((*loop).get(1)) * 1000;
-		pq.q = std::stod((*loop).get(2)) * 1000;
-		load_profile.pqData.insert(std::pair<Real,PQData>(currentTime,pq));
+			PQData pq;
+			// multiplied by 1000 due to unit conversion (kw to w)
+			pq.p = data.get(row, 1) * 1000;
+			pq.q = data.get(row, 2) * 1000;
+			load_profile.pqData.insert(std::pair<Real,PQData>(currentTime,pq));
 		}
 
 		if (end_time > 0 && currentTime > end_time)
 			break;
 	}
-		std::vector<CPS::Real> times;
-	for (CPS::Real x_ = start_time; x_ <= end_time; x_ += time_step) {
-		times.push_back(x_);
-	}
 
-	for (auto x : times) {
-		if (load_profile.pqData.find(x) == load_profile.pqData.end()) {
-			if (data_with_weighting_factor) {
+	for (CPS::Real x = start_time; x <= end_time; x += time_step) {
+		if (data_with_weighting_factor) {
+			if (load_profile.weightingFactors.find(x) == load_profile.weightingFactors.end()) {
 				Real y = interpol_linear(load_profile.weightingFactors, x);
 				load_profile.weightingFactors.insert(std::pair<Real, Real>(x, y));
 			}
-			else {
-				PQData y = interpol_linear(load_profile.pqData, x);
-				load_profile.pqData.insert(std::pair<Real,PQData>(x,y));
-			}
+		}
+		else if (load_profile.pqData.find(x) == load_profile.pqData.end()) {
+			PQData y = interpol_linear(load_profile.pqData, x);
+			load_profile.pqData.insert(std::pair<Real,PQData>(x,y));
 		}
 	}
 
@@ -419,45 +668,37 @@ std::vector<Real> CSVReader::readPQData(fs::path file,
 	CSVReader::DataFormat format) {
 
 	std::vector<Real> p_data;
-	std::ifstream csvfile(file);
-	CSVReaderIterator row_(csvfile);
+	CSVData data(file, false, mChunkThreads);
 
-	// ignore the first row if it is a title
-	if (!std::isdigit((*row_).get(0)[0])) {
-		row_.next();
-	}
 	/*
-	 loop over rows of the csv file to find the entry point to read in.
+	 skip the rows before the entry point, the rows are read as one per second.
 	 if start_time and end_time are negative (as default), it reads in all rows.
 	*/
-	Real presentTime = 0;
-	for (; row_ != CSVReaderIterator(); row_.next()) {
-		if ((start_time < 0) | (Int(presentTime) + 1 > Int(start_time)))
-			break;
-		presentTime++;
-	}
+	std::size_t row = 0;
+	if (start_time >= 0 && Int(start_time) > 0)
+		row = static_cast<std::size_t>(Int(start_time));
+	Real presentTime = static_cast<Real>(row);
 	/*
 	 reading data after entry point until end_time is reached
 	*/
-	for (; row_ != CSVReaderIterator(); row_.next()) {
+	for (; row < data.rows(); row++) {
 		// IMPORTANT: take care of units. assume kW
-		p_data.push_back(std::stod((*row_).get(0)) * 1000);
+		p_data.push_back(data.get(row, 0) * 1000);
 		if (end_time > 0 && presentTime > end_time)
 			break;
-		/*while (presentTime + time_step < Int(presentTime) + 1)
-		{
-			presentTime += time_step;
-			p_data.push_back(p_data.back());
-		}*/
 		presentTime = Int(presentTime) + 1;
 	}
-	std::cout<<"CSV loaded."<<std::endl;
+	mSLog->debug("Loaded {} rows of {}", p_data.size(), file.string());
 	return p_data;
 }
 
 void CSVReader::assignLoadProfile(CPS::SystemTopology& sys, Real start_time, Real time_step, Real end_time,
 	CSVReader::Mode mode, CSVReader::DataFormat format) {
 
+	// Profiles are read in parallel once all loads have been matched.
+	// Later matches for the same load replace earlier ones.
+	ReadJobs jobs;
+
 	switch (mode) {
 		case CSVReader::Mode::AUTO: {
 			for (auto obj : sys.mComponents) {
@@ -473,7 +714,7 @@ void CSVReader::assignLoadProfile(CPS::SystemTopology& sys, Real start_time, Rea
 						load_name.erase(remove_if(load_name.begin(), load_name.end(), [](char c) { return !isalnum(c); }), load_name.end());
 						file_name.erase(remove_if(file_name.begin(), file_name.end(), [](char c) { return !isalnum(c); }), file_name.end());
 						if (std::string(file_name.begin(), file_name.end() - 3).compare(load_name) == 0) {
-							load->mLoadProfile = readLoadProfile(file, start_time, time_step, end_time, format);
+							jobs[load.get()] = [=]() { load->mLoadProfile = readLoadProfile(file, start_time, time_step, end_time, format); };
 							load->use_profile = true;
 							mSLog->info("Assigned {} to {}", file.filename().string(), load->name());
 						}
@@ -495,7 +736,8 @@ void CSVReader::assignLoadProfile(CPS::SystemTopology& sys, Real start_time, Rea
 						LP_not_assigned_counter++;
 						continue;
 					}
-					load->mLoadProfile = readLoadProfile(std::experimental::filesystem::path(mPath + file->second + ".csv"), start_time, time_step, end_time);
+					fs::path path(mPath + file->second + ".csv");
+					jobs[load.get()] = [=]() { load->mLoadProfile = readLoadProfile(path, start_time, time_step, end_time); };
 					load->use_profile = true;
 					std::cout<<" Assigned "<< file->second<< " to " <<load->name()<<std::endl;
 					mSLog->info("Assigned {}.csv to {}", file->second, load->name());
@@ -511,6 +753,123 @@ void CSVReader::assignLoadProfile(CPS::SystemTopology& sys, Real start_time, Rea
 			break;
 		}
 	}
+
+	runParallel(jobs);
+}
+
+void CSVReader::writeLoadProfileTable(const String& filename,
+	Real start_time, Real time_step, Real end_time, CSVReader::DataFormat format) {
+
+	// Linear interpolation between the two rows enclosing the requested time
+	struct ProfileStream {
+		std::ifstream file;
+		CSVRow row;
+		Real prevTime = 0, nextTime = 0;
+		PQData prev{0, 0}, next{0, 0};
+		Bool end = false;
+	};
+	bool need_that_conversion = (format == DataFormat::HHMMSS);
+	bool data_with_weighting_factor = false;
+
+	auto readRow = [&](ProfileStream& stream) -> bool {
+		while (stream.file.good()) {
+			stream.row.readNextRow(stream.file);
+			if (stream.row.size() < 2 || stream.row.get(0).empty() || !std::isdigit(stream.row.get(0)[0]))
+				continue;
+			stream.nextTime = need_that_conversion ? time_format_convert(stream.row.get(0)) : std::stod(stream.row.get(0));
+			if (stream.row.size() == 2) {
+				data_with_weighting_factor = true;
+				stream.next.p = stream.next.q = std::stod(stream.row.get(1));
+			} else {
+				// multiplied by 1000 due to unit conversion (kw to w)
+				stream.next.p = std::stod(stream.row.get(1)) * 1000;
+				stream.next.q = std::stod(stream.row.get(2)) * 1000;
+			}
+			return true;
+		}
+		return false;
+	};
+
+	std::vector<String> names;
+	std::vector<ProfileStream> streams(mFileList.size());
+	UInt idx = 0;
+	for (auto& path : mFileList) {
+		names.push_back(path.stem().string());
+		streams[idx].file.open(path.string());
+		if (!readRow(streams[idx]))
+			throw SystemError("Profile file " + path.string() + " contains no data");
+		streams[idx].prevTime = streams[idx].nextTime;
+		streams[idx].prev = streams[idx].next;
+		idx++;
+	}
+
+	UInt numSamples = static_cast<UInt>(std::floor((end_time - start_time) / time_step + 1e-9)) + 1;
+	std::ofstream file(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!file.is_open())
+		throw SystemError("Cannot open profile table " + filename);
+	PowerProfileTable::writeHeader(file, names, start_time, time_step, numSamples, data_with_weighting_factor);
+
+	std::vector<PQData> row(streams.size());
+	for (UInt sample = 0; sample < numSamples; sample++) {
+		Real time = start_time + sample * time_step;
+		for (UInt profile = 0; profile < streams.size(); profile++) {
+			auto& stream = streams[profile];
+			while (!stream.end && stream.nextTime < time) {
+				stream.prevTime = stream.nextTime;
+				stream.prev = stream.next;
+				stream.end = !readRow(stream);
+			}
+			if (stream.end || time <= stream.prevTime || stream.nextTime <= stream.prevTime)
+				row[profile] = stream.end ? stream.next : stream.prev;
+			else {
+				Real frac = (time - stream.prevTime) / (stream.nextTime - stream.prevTime);
+				row[profile].p = stream.prev.p + frac * (stream.next.p - stream.prev.p);
+				row[profile].q = stream.prev.q + frac * (stream.next.q - stream.prev.q);
+			}
+		}
+		PowerProfileTable::writeRow(file, row);
+	}
+	mSLog->info("Wrote {} samples of {} profiles to {}", numSamples, names.size(), filename);
+}
+
+void CSVReader::assignLoadProfileTable(SystemTopology& sys, PowerProfileTable::Ptr table, CSVReader::Mode mode) {
+	// Same name normalization as for the assignment of single profiles
+	auto normalize = [](String name) {
+		for (auto & c : name) c = toupper(c);
+		name.erase(remove_if(name.begin(), name.end(), [](char c) { return !isalnum(c); }), name.end());
+		return name;
+	};
+
+	std::map<String, UInt> profiles;
+	for (UInt idx = 0; idx < table->numProfiles(); idx++)
+		profiles[mode == Mode::AUTO ? normalize(table->names()[idx]) : table->names()[idx]] = idx;
+
+	Int LP_assigned_counter = 0;
+	Int LP_not_assigned_counter = 0;
+	for (auto obj : sys.mComponents) {
+		auto load = std::dynamic_pointer_cast<CPS::SP::Ph1::Load>(obj);
+		if (!load)
+			continue;
+
+		String profileName;
+		if (mode == Mode::AUTO)
+			profileName = normalize(load->name());
+		else {
+			auto file = mAssignPattern.find(load->name());
+			if (file != mAssignPattern.end())
+				profileName = file->second;
+		}
+
+		auto profile = profiles.find(profileName);
+		if (profile == profiles.end()) {
+			mSLog->info("{} has no profile given.", load->name());
+			LP_not_assigned_counter++;
+			continue;
+		}
+		load->setLoadProfile(table, profile->second);
+		LP_assigned_counter++;
+	}
+	mSLog->info("Assigned profiles for {} loads, {} not assigned.", LP_assigned_counter, LP_not_assigned_counter);
 }
 
 CPS::PQData CSVReader::interpol_linear(std::map<CPS::Real, CPS::PQData>& pqData, CPS::Real x) {
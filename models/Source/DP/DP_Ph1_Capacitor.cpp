@@ -56,10 +56,7 @@ void DP::Ph1::Capacitor::initializeFromPowerflow(Real frequency) {
 		Logger::phasorToString(initialSingleVoltage(1)));
 }
 
-void DP::Ph1::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) {
-	MNAInterface::mnaInitialize(omega, timeStep);
-	updateMatrixNodeIndices();
-
+void DP::Ph1::Capacitor::mnaUpdateTimeStep(Real timeStep) {
 	Real equivCondReal = 2.0 * mCapacitance / timeStep;
 	Real prevVoltCoeffReal = 2.0 * mCapacitance / timeStep;
 
@@ -68,7 +65,16 @@ void DP::Ph1::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Matr
 		mEquivCond(freq,0) = { equivCondReal, equivCondImag };
 		Real prevVoltCoeffImag = - 2.*PI * mFrequencies(freq,0) * mCapacitance;
 		mPrevVoltCoeff(freq,0) = { prevVoltCoeffReal, prevVoltCoeffImag };
+	}
+}
+
+void DP::Ph1::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) {
+	MNAInterface::mnaInitialize(omega, timeStep);
+	updateMatrixNodeIndices();
+
+	mnaUpdateTimeStep(timeStep);
 
+	for (UInt freq = 0; freq < mNumFreqs; freq++) {
 		mEquivCurrent(freq,0) = -mIntfCurrent(0,freq) + -mPrevVoltCoeff(freq,0) * mIntfVoltage(0,freq);
 		mIntfCurrent(0, freq) = mEquivCond(freq,0) * mIntfVoltage(0,freq) + mEquivCurrent(freq,0);
 	}
@@ -92,15 +98,9 @@ void DP::Ph1::Capacitor::mnaInitializeHarm(Real omega, Real timeStep, std::vecto
 	MNAInterface::mnaInitialize(omega, timeStep);
 	updateMatrixNodeIndices();
 
-	Real equivCondReal = 2.0 * mCapacitance / timeStep;
-	Real prevVoltCoeffReal = 2.0 * mCapacitance / timeStep;
+	mnaUpdateTimeStep(timeStep);
 
 	for (UInt freq = 0; freq < mNumFreqs; freq++) {
-		Real equivCondImag = 2.*PI * mFrequencies(freq,0) * mCapacitance;
-		mEquivCond(freq,0) = { equivCondReal, equivCondImag };
-		Real prevVoltCoeffImag = - 2.*PI * mFrequencies(freq,0) * mCapacitance;
-		mPrevVoltCoeff(freq,0) = { prevVoltCoeffReal, prevVoltCoeffImag };
-
 		mEquivCurrent(freq,0) = -mIntfCurrent(0,freq) + -mPrevVoltCoeff(freq,0) * mIntfVoltage(0,freq);
 		mIntfCurrent(0, freq) = mEquivCond(freq,0) * mIntfVoltage(0,freq) + mEquivCurrent(freq,0);
 	}
@@ -267,3 +267,9 @@ void DP::Ph1::Capacitor::mnaUpdateCurrentHarm() {
 		SPDLOG_LOGGER_DEBUG(mSLog, "Current {:s}", Logger::phasorToString(mIntfCurrent(0,freq)));
 	}
 }
+
+void DP::Ph1::Capacitor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, Complex(0, omega * mCapacitance));
+}
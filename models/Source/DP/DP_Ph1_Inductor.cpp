@@ -57,7 +57,7 @@ void DP::Ph1::Inductor::initializeFromPowerflow(Real frequency) {
 
 // #### MNA functions ####
 
-void DP::Ph1::Inductor::initVars(Real timeStep) {
+void DP::Ph1::Inductor::mnaUpdateTimeStep(Real timeStep) {
 	for (UInt freq = 0; freq < mNumFreqs; freq++) {
 		Real a = timeStep / (2. * mInductance);
 		Real b = timeStep * 2.*PI * mFrequencies(freq,0) / 2.;
@@ -68,7 +68,12 @@ void DP::Ph1::Inductor::initVars(Real timeStep) {
 		Real preCurrFracReal = (1. - b * b) / (1. + b * b);
 		Real preCurrFracImag =  (-2. * b) / (1. + b * b);
 		mPrevCurrFac(freq,0) = { preCurrFracReal, preCurrFracImag };
+	}
+}
 
+void DP::Ph1::Inductor::initVars(Real timeStep) {
+	mnaUpdateTimeStep(timeStep);
+	for (UInt freq = 0; freq < mNumFreqs; freq++) {
 		// TODO: check if this is correct or if it should be only computed before the step
 		mEquivCurrent(freq,0) = mEquivCond(freq,0) * mIntfVoltage(0,freq) + mPrevCurrFac(freq,0) * mIntfCurrent(0,freq);
 		mIntfCurrent(0,freq) = mEquivCond(freq,0) * mIntfVoltage(0,freq) + mEquivCurrent(freq,0);
@@ -271,3 +276,12 @@ void DP::Ph1::Inductor::mnaTearPostStep(Complex voltage, Complex current) {
 	mIntfCurrent(0, 0) = mEquivCond(0,0) * voltage + mEquivCurrent(0,0);
 
 }
+
+void DP::Ph1::Inductor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	// A short circuit has no admittance
+	if (omega == 0)
+		throw SystemError("Inductor " + mName + " has no admittance at 0 Hz");
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / Complex(0, omega * mInductance));
+}
@@ -201,3 +201,9 @@ Complex DP::Ph1::Resistor::daeInitialize() {
 
 	 return mIntfVoltage(0,0);
 }
+
+void DP::Ph1::Resistor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / mResistance);
+}
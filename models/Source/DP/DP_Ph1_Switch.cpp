@@ -131,3 +131,9 @@ void DP::Ph1::Switch::mnaUpdateCurrent(const Matrix& leftVector) {
 		mIntfVoltage(0,0) / mClosedResistance :
 		mIntfVoltage(0,0) / mOpenResistance;
 }
+
+void DP::Ph1::Switch::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / (mIsClosed ? mClosedResistance : mOpenResistance));
+}
@@ -202,3 +202,9 @@ Complex DP::Ph1::VoltageSource::daeInitialize() {
 	mIntfVoltage(0,0) = mVoltageRef->get();
 	return mVoltageRef->get();
 }
+
+void DP::Ph1::VoltageSource::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addVoltageSourceStamp(admittance, node0, node1, mVirtualNodes[0]->matrixNodeIndex());
+}
@@ -51,7 +51,7 @@ void EMT::Ph1::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Mat
 	MNAInterface::mnaInitialize(omega, timeStep);
 	updateMatrixNodeIndices();
 
-	mEquivCond = (2.0 * mCapacitance) / timeStep;
+	mnaUpdateTimeStep(timeStep);
 	// Update internal state
 	mEquivCurrent = -mIntfCurrent(0,0) + -mEquivCond * mIntfVoltage(0,0);
 
@@ -60,6 +60,10 @@ void EMT::Ph1::Capacitor::mnaInitialize(Real omega, Real timeStep, Attribute<Mat
 	mMnaTasks.push_back(std::make_shared<MnaPostStep>(*this, leftVector));
 }
 
+void EMT::Ph1::Capacitor::mnaUpdateTimeStep(Real timeStep) {
+	mEquivCond = (2.0 * mCapacitance) / timeStep;
+}
+
 void EMT::Ph1::Capacitor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 	if (terminalNotGrounded(0))
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(0), mEquivCond);
@@ -100,3 +104,9 @@ void EMT::Ph1::Capacitor::mnaUpdateVoltage(const Matrix& leftVector) {
 void EMT::Ph1::Capacitor::mnaUpdateCurrent(const Matrix& leftVector) {
 	mIntfCurrent(0,0) = mEquivCond * mIntfVoltage(0,0) + mEquivCurrent;
 }
+
+void EMT::Ph1::Capacitor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, Complex(0, omega * mCapacitance));
+}
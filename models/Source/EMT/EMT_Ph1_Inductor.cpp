@@ -51,7 +51,7 @@ void EMT::Ph1::Inductor::mnaInitialize(Real omega, Real timeStep, Attribute<Matr
 	MNAInterface::mnaInitialize(omega, timeStep);
 	updateMatrixNodeIndices();
 
-	mEquivCond = timeStep / (2.0 * mInductance);
+	mnaUpdateTimeStep(timeStep);
 	// Update internal state
 	mEquivCurrent = mEquivCond * mIntfVoltage(0,0) + mIntfCurrent(0,0);
 
@@ -60,6 +60,10 @@ void EMT::Ph1::Inductor::mnaInitialize(Real omega, Real timeStep, Attribute<Matr
 	mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 }
 
+void EMT::Ph1::Inductor::mnaUpdateTimeStep(Real timeStep) {
+	mEquivCond = timeStep / (2.0 * mInductance);
+}
+
 void EMT::Ph1::Inductor::mnaApplySystemMatrixStamp(Matrix& systemMatrix) {
 	if (terminalNotGrounded(0))
 		Math::addToMatrixElement(systemMatrix, matrixNodeIndex(0), matrixNodeIndex(0), mEquivCond);
@@ -102,3 +106,11 @@ void EMT::Ph1::Inductor::mnaUpdateCurrent(const Matrix& leftVector) {
 	mIntfCurrent(0,0) = mEquivCond * mIntfVoltage(0,0) + mEquivCurrent;
 }
 
+void EMT::Ph1::Inductor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	// A short circuit has no admittance
+	if (omega == 0)
+		throw SystemError("Inductor " + mName + " has no admittance at 0 Hz");
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / Complex(0, omega * mInductance));
+}
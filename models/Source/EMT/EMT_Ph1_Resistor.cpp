@@ -91,3 +91,9 @@ void EMT::Ph1::Resistor::mnaUpdateVoltage(const Matrix& leftVector) {
 void EMT::Ph1::Resistor::mnaUpdateCurrent(const Matrix& leftVector) {
 	mIntfCurrent(0,0) = mIntfVoltage(0,0) / mResistance;
 }
+
+void EMT::Ph1::Resistor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / mResistance);
+}
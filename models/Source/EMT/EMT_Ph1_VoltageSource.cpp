@@ -91,3 +91,9 @@ void EMT::Ph1::VoltageSource::MnaPostStep::execute(Real time, Int timeStepCount)
 void EMT::Ph1::VoltageSource::mnaUpdateCurrent(const Matrix& leftVector) {
 	mIntfCurrent(0,0) = Math::realFromVectorElement(leftVector, mVirtualNodes[0]->matrixNodeIndex());
 }
+
+void EMT::Ph1::VoltageSource::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addVoltageSourceStamp(admittance, node0, node1, mVirtualNodes[0]->matrixNodeIndex());
+}
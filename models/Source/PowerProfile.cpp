@@ -0,0 +1,168 @@
+/* Copyright 2017-2020 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <cps/PowerProfile.h>
+
+using namespace CPS;
+
+// Table files start with a header of the form
+// magic, number of profiles, number of samples, start time, interval,
+// weighting factor flag and profile names followed by the rows of samples.
+static const std::uint32_t tableMagic = 0x54505044; // "DPPT"
+
+PowerProfileTable::PowerProfileTable(const std::vector<String>& names, Real startTime, Real interval,
+	UInt numSamples, Bool weightingFactors, Interpolation interpolation) :
+	mNames(names), mStartTime(startTime), mInterval(interval), mNumSamples(numSamples),
+	mWeightingFactors(weightingFactors), mInterpolation(interpolation),
+	mData(static_cast<std::size_t>(numSamples) * names.size(), PQData{0, 0}),
+	mWindowSamples(numSamples) {
+
+	if (interval <= 0 || numSamples == 0)
+		throw SystemError("Profile table requires a positive interval and at least one sample");
+	initIndices();
+}
+
+PowerProfileTable::PowerProfileTable(const String& filename, UInt windowSamples, Interpolation interpolation) :
+	mInterpolation(interpolation), mFile(filename, std::ios_base::in | std::ios_base::binary),
+	mMaxWindowSamples(windowSamples < 2 ? 2 : windowSamples) {
+
+	if (!mFile.is_open())
+		throw SystemError("Cannot open profile table " + filename);
+
+	std::uint32_t magic = 0;
+	std::uint64_t numProfiles = 0, numSamples = 0;
+	std::uint8_t weightingFactors = 0;
+	mFile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	mFile.read(reinterpret_cast<char*>(&numProfiles), sizeof(numProfiles));
+	mFile.read(reinterpret_cast<char*>(&numSamples), sizeof(numSamples));
+	mFile.read(reinterpret_cast<char*>(&mStartTime), sizeof(mStartTime));
+	mFile.read(reinterpret_cast<char*>(&mInterval), sizeof(mInterval));
+	mFile.read(reinterpret_cast<char*>(&weightingFactors), sizeof(weightingFactors));
+	if (!mFile || magic != tableMagic || numSamples == 0)
+		throw SystemError("Invalid profile table " + filename);
+
+	mNumSamples = static_cast<UInt>(numSamples);
+	mWeightingFactors = weightingFactors != 0;
+	mNames.resize(numProfiles);
+	for (auto& name : mNames) {
+		std::uint64_t length = 0;
+		mFile.read(reinterpret_cast<char*>(&length), sizeof(length));
+		name.resize(length);
+		mFile.read(&name[0], length);
+	}
+	if (!mFile)
+		throw SystemError("Invalid profile table " + filename);
+
+	mDataOffset = mFile.tellg();
+	initIndices();
+	loadWindow(0, 0);
+}
+
+void PowerProfileTable::initIndices() {
+	mIndices.clear();
+	for (UInt idx = 0; idx < mNames.size(); idx++)
+		mIndices[mNames[idx]] = idx;
+}
+
+UInt PowerProfileTable::profileIndex(const String& name) const {
+	auto it = mIndices.find(name);
+	if (it == mIndices.end())
+		throw SystemError("No profile " + name + " in profile table");
+	return it->second;
+}
+
+void PowerProfileTable::setSample(UInt profile, UInt sample, PQData data) {
+	if (mFile.is_open())
+		throw SystemError("Profile table read from file cannot be modified");
+	mData[static_cast<std::size_t>(sample) * mNames.size() + profile] = data;
+}
+
+void PowerProfileTable::loadWindow(UInt first, UInt last) {
+	if (first >= mWindowStart && last < mWindowStart + mWindowSamples)
+		return;
+
+	// Windows start at the first requested sample because time
+	// usually advances, the following samples are read ahead
+	mWindowStart = first;
+	mWindowSamples = std::min(mMaxWindowSamples, mNumSamples - first);
+	std::size_t rowSize = sizeof(PQData) * mNames.size();
+	mData.resize(static_cast<std::size_t>(mWindowSamples) * mNames.size());
+
+	mFile.clear();
+	mFile.seekg(mDataOffset + static_cast<std::streamoff>(first) * rowSize);
+	mFile.read(reinterpret_cast<char*>(mData.data()), mWindowSamples * rowSize);
+	if (!mFile)
+		throw SystemError("Profile table file is truncated");
+}
+
+PQData PowerProfileTable::value(UInt profile, Real time) {
+	Real pos = (time - mStartTime) / mInterval;
+	if (pos <= 0)
+		pos = 0;
+	else if (pos >= mNumSamples - 1)
+		pos = mNumSamples - 1;
+
+	// Tolerate rounding errors for times at multiples of the interval
+	UInt idx = static_cast<UInt>(std::floor(pos + 1e-9));
+	Real frac = std::max(pos - idx, 0.);
+	if (idx >= mNumSamples - 1 || mInterpolation == Interpolation::Hold) {
+		idx = std::min(idx, mNumSamples - 1);
+		frac = 0;
+	}
+	UInt last = frac > 0 ? idx + 1 : idx;
+
+	// Tables in memory are not modified while they are read
+	if (!mFile.is_open())
+		return interpolate(profile, idx, frac);
+
+	std::lock_guard<std::mutex> lock(mWindowMutex);
+	loadWindow(idx, last);
+	return interpolate(profile, idx, frac);
+}
+
+PQData PowerProfileTable::interpolate(UInt profile, UInt idx, Real frac) const {
+	const PQData& before = sample(profile, idx);
+	if (frac <= 0)
+		return before;
+	const PQData& after = sample(profile, idx + 1);
+	return PQData{ before.p + frac * (after.p - before.p), before.q + frac * (after.q - before.q) };
+}
+
+void PowerProfileTable::writeHeader(std::ofstream& file, const std::vector<String>& names,
+	Real startTime, Real interval, UInt numSamples, Bool weightingFactors) {
+
+	std::uint64_t numProfiles = names.size(), samples = numSamples;
+	std::uint8_t wf = weightingFactors ? 1 : 0;
+	file.write(reinterpret_cast<const char*>(&tableMagic), sizeof(tableMagic));
+	file.write(reinterpret_cast<const char*>(&numProfiles), sizeof(numProfiles));
+	file.write(reinterpret_cast<const char*>(&samples), sizeof(samples));
+	file.write(reinterpret_cast<const char*>(&startTime), sizeof(startTime));
+	file.write(reinterpret_cast<const char*>(&interval), sizeof(interval));
+	file.write(reinterpret_cast<const char*>(&wf), sizeof(wf));
+	for (auto& name : names) {
+		std::uint64_t length = name.size();
+		file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		file.write(name.data(), length);
+	}
+}
+
+void PowerProfileTable::save(const String& filename) const {
+	if (mFile.is_open())
+		throw SystemError("Profile table is already stored in a file");
+
+	std::ofstream file(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!file.is_open())
+		throw SystemError("Cannot open profile table " + filename);
+
+	writeHeader(file, mNames, mStartTime, mInterval, mNumSamples, mWeightingFactors);
+	file.write(reinterpret_cast<const char*>(mData.data()), sizeof(PQData) * mData.size());
+}
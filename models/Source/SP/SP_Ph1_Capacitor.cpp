@@ -109,3 +109,9 @@ void SP::Ph1::Capacitor::mnaUpdateVoltage(const Matrix& leftVector) {
 void SP::Ph1::Capacitor::mnaUpdateCurrent(const Matrix& leftVector) {
 	mIntfCurrent = mSusceptance * mIntfVoltage;
 }
+
+void SP::Ph1::Capacitor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, Complex(0, omega * mCapacitance));
+}
@@ -114,4 +114,11 @@ void SP::Ph1::Inductor::mnaTearApplyMatrixStamp(Matrix& tearMatrix) {
 	Math::addToMatrixElement(tearMatrix, mTearIdx, mTearIdx, 1. / mSusceptance);
 }
 
-
+void SP::Ph1::Inductor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	// A short circuit has no admittance
+	if (omega == 0)
+		throw SystemError("Inductor " + mName + " has no admittance at 0 Hz");
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / Complex(0, omega * mInductance));
+}
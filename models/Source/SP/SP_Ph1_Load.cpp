@@ -27,12 +27,16 @@ SP::Ph1::Load::Load(String uid, String name, Logger::Level logLevel)
 	addAttribute<Real>("P", &mActivePower, Flags::read | Flags::write);
 	addAttribute<Real>("Q", &mReactivePower, Flags::read | Flags::write);
 	addAttribute<Real>("V_nom", &mNomVoltage, Flags::read | Flags::write);
+	addAttribute<Real>("P_nom", &mActivePowerNom, Flags::read | Flags::write);
+	addAttribute<Real>("Q_nom", &mReactivePowerNom, Flags::read | Flags::write);
 };
 
 
 void SP::Ph1::Load::setParameters(Real activePower, Real reactivePower, Real nominalVoltage) {
 	mActivePower = activePower;
 	mReactivePower = reactivePower;
+	mActivePowerNom = activePower;
+	mReactivePowerNom = reactivePower;
 	mPower = { mActivePower, mReactivePower };
 	mNomVoltage = nominalVoltage;
 
@@ -84,16 +88,34 @@ void SP::Ph1::Load::modifyPowerFlowBusType(PowerflowBusType powerflowBusType) {
 };
 
 
+// Returns the last entry at or before the given time
+template <typename T>
+static const T& profileEntry(const std::map<Real, T>& data, Real time) {
+	auto it = data.upper_bound(time);
+	if (it != data.begin())
+		--it;
+	return it->second;
+}
+
 void SP::Ph1::Load::updatePQ(Real time) {
-	if (mLoadProfile.weightingFactors.empty()) {
-		this->attribute<Real>("P")->set(mLoadProfile.pqData.find(time)->second.p);
-		this->attribute<Real>("Q")->set(mLoadProfile.pqData.find(time)->second.q);
+	if (mProfileTable) {
+		PQData data = mProfileTable->value(mProfileIndex, time);
+		// The attributes refer to the members, so they are accessed
+		// directly instead of looking them up by name in every step
+		if (mProfileTable->weightingFactors()) {
+			data.p *= mActivePowerNom;
+			data.q *= mReactivePowerNom;
+		}
+		mActivePower = data.p;
+		mReactivePower = data.q;
+	} else if (mLoadProfile.weightingFactors.empty()) {
+		const PQData& data = profileEntry(mLoadProfile.pqData, time);
+		mActivePower = data.p;
+		mReactivePower = data.q;
 	} else {
-		Real wf = mLoadProfile.weightingFactors.find(time)->second;
-		Real P_new = this->attribute<Real>("P_nom")->get()*wf;
-		Real Q_new = this->attribute<Real>("Q_nom")->get()*wf;
-		this->attribute<Real>("P")->set(P_new);
-		this->attribute<Real>("Q")->set(Q_new);
+		Real wf = profileEntry(mLoadProfile.weightingFactors, time);
+		mActivePower = mActivePowerNom * wf;
+		mReactivePower = mReactivePowerNom * wf;
 	}
 };
 
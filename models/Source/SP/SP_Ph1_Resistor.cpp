@@ -152,3 +152,9 @@ void SP::Ph1::Resistor::mnaUpdateCurrent(const Matrix& leftVector) {
 void SP::Ph1::Resistor::mnaTearApplyMatrixStamp(Matrix& tearMatrix) {
 	Math::addToMatrixElement(tearMatrix, mTearIdx, mTearIdx, Complex(mResistance, 0));
 }
+
+void SP::Ph1::Resistor::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addAdmittanceStamp(admittance, node0, node1, 1. / mResistance);
+}
@@ -116,3 +116,9 @@ Complex SP::Ph1::VoltageSource::daeInitialize() {
 	mIntfVoltage(0, 0) = mVoltageRef->get();
 	return mVoltageRef->get();
 }
+
+void SP::Ph1::VoltageSource::mnaApplyAdmittanceStamp(Real omega, AdmittanceStamp& admittance) {
+	Int node0 = terminalNotGrounded(0) ? static_cast<Int>(matrixNodeIndex(0)) : -1;
+	Int node1 = terminalNotGrounded(1) ? static_cast<Int>(matrixNodeIndex(1)) : -1;
+	addVoltageSourceStamp(admittance, node0, node1, mVirtualNodes[0]->matrixNodeIndex());
+}
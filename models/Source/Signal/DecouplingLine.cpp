@@ -165,3 +165,21 @@ Task::List DecouplingLine::getTasks() {
 IdentifiedObject::List DecouplingLine::getLineComponents() {
 	return IdentifiedObject::List({mRes1, mRes2, mSrc1, mSrc2});
 }
+
+void DecouplingLine::saveState(Snapshot& snapshot) {
+	SimSignalComp::saveState(snapshot);
+	snapshot.write(mVolt1);
+	snapshot.write(mVolt2);
+	snapshot.write(mCur1);
+	snapshot.write(mCur2);
+	snapshot.write(mBufIdx);
+}
+
+void DecouplingLine::loadState(Snapshot& snapshot) {
+	SimSignalComp::loadState(snapshot);
+	snapshot.read(mVolt1);
+	snapshot.read(mVolt2);
+	snapshot.read(mCur1);
+	snapshot.read(mCur2);
+	snapshot.read(mBufIdx);
+}
@@ -132,3 +132,21 @@ Task::List DecouplingLineEMT::getTasks() {
 IdentifiedObject::List DecouplingLineEMT::getLineComponents() {
 	return IdentifiedObject::List({mRes1, mRes2, mSrc1, mSrc2});
 }
+
+void DecouplingLineEMT::saveState(Snapshot& snapshot) {
+	SimSignalComp::saveState(snapshot);
+	snapshot.write(mVolt1);
+	snapshot.write(mVolt2);
+	snapshot.write(mCur1);
+	snapshot.write(mCur2);
+	snapshot.write(mBufIdx);
+}
+
+void DecouplingLineEMT::loadState(Snapshot& snapshot) {
+	SimSignalComp::loadState(snapshot);
+	snapshot.read(mVolt1);
+	snapshot.read(mVolt2);
+	snapshot.read(mCur1);
+	snapshot.read(mCur2);
+	snapshot.read(mBufIdx);
+}
@@ -63,3 +63,15 @@ Int FIRFilter::getIndex(Int index) {
 void FIRFilter::setInput(Attribute<Real>::Ptr input) {
 	mInput = input;
 }
+
+void FIRFilter::saveState(Snapshot& snapshot) {
+	SimSignalComp::saveState(snapshot);
+	snapshot.write(mSignal);
+	snapshot.write(mCurrentIdx);
+}
+
+void FIRFilter::loadState(Snapshot& snapshot) {
+	SimSignalComp::loadState(snapshot);
+	snapshot.read(mSignal);
+	snapshot.read(mCurrentIdx);
+}
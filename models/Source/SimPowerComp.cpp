@@ -168,6 +168,26 @@ void SimPowerComp<VarType>::initialize(Matrix frequencies) {
 		node->initialize(frequencies);
 }
 
+template<typename VarType>
+void SimPowerComp<VarType>::saveState(Snapshot& snapshot) {
+	AttributeList::saveState(snapshot);
+	for (auto subComp : mSubComponents)
+		subComp->saveState(snapshot);
+	for (auto subComp : stateSubComponents()) {
+		if (subComp) subComp->saveState(snapshot);
+	}
+}
+
+template<typename VarType>
+void SimPowerComp<VarType>::loadState(Snapshot& snapshot) {
+	AttributeList::loadState(snapshot);
+	for (auto subComp : mSubComponents)
+		subComp->loadState(snapshot);
+	for (auto subComp : stateSubComponents()) {
+		if (subComp) subComp->loadState(snapshot);
+	}
+}
+
 // Declare specializations to move definitions to .cpp
 template class CPS::SimPowerComp<Real>;
 template class CPS::SimPowerComp<Complex>;